@@ -28,10 +28,10 @@ parameters:
 - id: type
   label: '${direction.title()}put Type'
   dtype: enum
-  options: [fc32]
-  option_labels: [Complex Float32]
+  options: [fc32, sc16, sc8]
+  option_labels: [Complex Float32, Complex Int16, Complex Int8]
   option_attributes:
-      type: [fc32]
+      type: [fc32, sc16, sc8]
   hide: part
 - id: args
   label: 'Device Arguments'
@@ -80,6 +80,9 @@ inputs:
   id: command
   optional: true
 % if sourk == 'source':
+- domain: message
+  id: scan
+  optional: true
 
 outputs:
 % endif
@@ -100,7 +103,7 @@ templates:
      import time
   make: |
     osmosdr.${sourk}(
-        args="numchan=" + str(${'$'}{nchan}) + " " + ${'$'}{args}
+        args="numchan=" + str(${'$'}{nchan}) + " item_type=${'$'}{type} " + ${'$'}{args}
     )
     % for m in range(max_mboards):
     ${'%'} if context.get('num_mboards')() > ${m}:
@@ -175,12 +178,18 @@ documentation: |-
    * Fairwaves XTRX through libxtrx
    * Fairwaves UmTRX through Fairwaves' module for UHD
    * Red Pitaya SDR transceiver (http://bazaar.redpitaya.com)
+   * VITA 49 (VRT) IF data and context packets over UDP
    * FreeSRP through libfreesrp library
 
   By using the osmocom $sourk block you can take advantage of a common software api in your application(s) independent of the underlying radio hardware.
 
-  Output Type:
-  This parameter controls the data type of the stream in gnuradio. Only complex float32 samples are supported at the moment.
+  ${direction.title()}put Type:
+  This parameter controls the data type of the stream in gnuradio.
+% if sourk == 'source':
+  Complex int16 and int8 samples are scaled to the full range of the type. The rtl, hackrf, airspy, bladerf and soapy devices deliver them without a float conversion, the others get converted from complex float. Resampling, software DC offset and IQ balance correction, scanning, align= and ddc= work on complex float only.
+% else:
+  Complex int16 and int8 samples are scaled to the full range of the type. The uhd, hackrf, bladerf, soapy and xtrx devices take them without a float conversion, a file sink writes them as they are, the others get them converted to complex float.
+% endif
 
   Device Arguments:
   The device argument is a comma delimited string used to locate devices on your system. Device arguments for multiple devices may be given by separating them with a space.
@@ -192,34 +201,77 @@ documentation: |-
   Lines ending with ... mean it's possible to bind devices together by specifying multiple device arguments separated with a space.
 
   % if sourk == 'source':
-    miri=0[,buffers=32] ...
+    miri=0[,buffers=32][,format=8|10+2|12|14] ...
+    sdrplay=0[,buffers=512]
     rtl=serial_number ...
     rtl=0[,rtl_xtal=28.8e6][,tuner_xtal=28.8e6] ...
     rtl=1[,buffers=32][,buflen=N*512] ...
-    rtl=2[,direct_samp=0|1|2][,offset_tune=0|1][,bias=0|1] ...
+    rtl=2[,direct_samp=0|1|2][,offset_tune=0|1][,bias=0|1][,settle_ms=0] ...
     rtl_tcp=127.0.0.1:1234[,psize=16384][,direct_samp=0|1|2][,offset_tune=0|1][,bias=0|1] ...
     file='/path/to/your file',rate=1e6[,freq=100e6][,repeat=true][,throttle=true] ...
     netsdr=127.0.0.1[:50000][,nchan=2]
     sdr-ip=127.0.0.1[:50000]
     cloudiq=127.0.0.1[:50000]
     sdr-iq=/dev/ttyUSB0
-    airspy=0[,bias=0|1][,linearity][,sensitivity]
+    airspy=0[,bias=0|1][,linearity][,sensitivity][,settle_ms=0]
   % endif
   % if sourk == 'sink':
     file='/path/to/your file',rate=1e6[,freq=100e6][,append=true][,throttle=true] ...
+    soapy=0[,driver=...][,format=CF32|CS16|CS8] ...
+  % endif
+    redpitaya=192.168.1.100[:1001][,buffers=32][,buflen=65536][,rcvbuf=N|sndbuf=N][,nodelay=0|1][,quickack=0|1][,timeout=100]
+  % if sourk == 'source':
+    vrt=[0.0.0.0][:4991][,iface=192.168.1.10][,stream_id=N][,context_id=N][,format=sc16|sc8|fc32][,rate=1e6][,freq=0][,batch=32][,buflen=2097152][,rcvbuf=N][,time_period=1.0]
+  % endif
+  % if sourk == 'sink':
+    vrt=127.0.0.1[:4991][,stream_id=0][,context_id=N][,format=sc16|sc8|fc32][,spp=360][,batch=32][,sndbuf=N][,context_period=1.0][,pace=0|1]
   % endif
-    redpitaya=192.168.1.100[:1001]
     freesrp=0[,fx3='path/to/fx3.img',fpga='path/to/fpga.bin',loopback]
-    hackrf=0[,buffers=32][,bias=0|1][,bias_tx=0|1]
+    hackrf=0[,buffers=32][,bias=0|1][,bias_tx=0|1][,settle_ms=0]
     bladerf=0[,tamer=internal|external|external_1pps][,smb=25e6]
     uhd[,serial=...][,lo_offset=0][,mcr=52e6][,nchan=2][,subdev='\\\\'B:0 A:0\\\\''] ...
     xtrx
 
+  % if sourk == 'source':
+  Receive Thread:
+  The rtl, miri, hackrf, airspy, airspyhf, sdr-iq and vrt devices take [,rx_cpu=N][,rx_prio=N][,rx_policy=fifo|rr] to pin the thread receiving from the device to a CPU and give it a real-time priority, which needs the right to do so. What was applied gets printed and shows in get_stats().
+
+  Conversion Threads:
+  The bladerf and soapy devices take [,convert_threads=N] to convert the samples in work() on N threads, for rates the thread of the block cannot keep up with. Soapy devices with a native CS16 format are then read as such and converted to complex float here instead of in the driver.
+
+  % endif
+  Sample Buffers:
+  The sample rings of the rtl, miri, hackrf, airspy, airspyhf, sdr-iq, vrt and bladerf devices come from a shared pool of huge pages where available, locked in memory and faulted in before streaming starts. Adding [,numa_node=N] to the device arguments places them on that NUMA node.
+
+  VITA 49:
+  % if sourk == 'source':
+  The vrt device receives the IF data packets of one stream on a UDP port, from the first stream seen unless stream_id= is given, and the context packets with context_id=, the same id by default. An IPv4 multicast address joins the group, on the interface with the address iface= if given. The digitizer is not controlled from here: frequency, rate, gain and bandwidth come from its context packets, rate= and freq= stand in until the first one arrives. The packet timestamps become rx_time tags on the first sample, after lost packets and every time_period seconds, packets lost according to the packet count get rx_dropped tags.
+  % else:
+  The vrt device sends IF data packets with stream id, packet count and UTC timestamps from the host clock or the last tx_time tag, and a context packet with frequency, gain and rate after changes and every context_period seconds. With pace=0 it sends as fast as the flowgraph runs, a vrt sink to 127.0.0.1 feeds a vrt source on the same host for testing.
+  % endif
+
   Num Channels:
   Selects the total number of channels in this multi-device configuration. Required when specifying multiple device arguments.
 
+  The devices of a multi-device configuration are opened at the same time, one thread each, and wired up in the order given. Adding open_threads=N as a separate argument opens no more than N at once, open_threads=1 one after another.
+
+  % if sourk == 'source':
+  Channel Alignment:
+  Adding align=xcorr[,align_len=65536][,align_period=0] as a separate argument aligns the channels of a multi-device configuration to each other. The offsets are measured by cross correlating align_len (at least 1024) samples of every channel against channel 0, repeated every align_period seconds if non-zero. Output starts after the first measurement.
+
+  IQ Balance Correction:
+  Devices without IQ balance correction in hardware get it in software while enabled. Adding iq_corr=iqbalance as a separate argument uses gr-iqbalance for it instead of the built-in corrector, if gr-osmosdr was built with it.
+
+  Narrowband Channels:
+  Adding ddc=N[,ddc_decim=64][,ddc_taps=32][,ddc_threads=1][,ddc_chan=0] as a separate argument adds N outputs after the device channels, each carrying a part of channel ddc_chan at its sample rate divided by ddc_decim. They are tuned with set_ddc_offset() and have to be connected, which is done from Python or C++ since this block does not show them.
+
+  % endif
+
   Sample Rate:
   The sample rate is the number of samples per second output by this block on each channel.
+  % if sourk == 'source':
+  Rates the device does not support are resampled from a native one. Adding resample=0 as a separate argument passes the rate to the device unchanged.
+  % endif
 
   Frequency:
   The center frequency is the frequency the RF chain is tuned to.
@@ -229,12 +281,12 @@ documentation: |-
 
   % if sourk == 'source':
   DC Offset Mode:
-  Controls the behavior of hardware DC offset corrrection.
+  Controls the behavior of DC offset corrrection.
     Off: Disable correction algorithm (pass through).
     Manual: Keep last estimated correction when switched from Automatic to Manual.
     Automatic: Periodicallly find the best solution to compensate for DC offset.
 
-  This functionality is available for USRP devices only.
+  Devices without hardware support are corrected in software.
 
   IQ Balance Mode:
   Controls the behavior of software IQ imbalance corrrection.
@@ -242,8 +294,6 @@ documentation: |-
     Manual: Keep last estimated correction when switched from Automatic to Manual.
     Automatic: Periodicallly find the best solution to compensate for image signals.
 
-  This functionality depends on http://cgit.osmocom.org/cgit/gr-iqbal/
-
   Gain Mode:
   Chooses between the manual (default) and automatic gain mode where appropriate.
   To allow manual control of RF/IF/BB gain stages, manual gain mode must be configured.
@@ -19,7 +19,6 @@
 #define INCLUDED_OSMOSDR_RANGES_H
 
 #include <osmosdr/api.h>
-#include <osmosdr/pimpl.h>
 #include <string>
 #include <vector>
 
@@ -66,11 +65,16 @@ namespace osmosdr{
         //! Convert this range to a printable string
         const std::string to_pp_string(void) const;
 
-    private: OSMOSDR_PIMPL_DECL(impl) _impl;
+    private: double _start, _stop, _step;
     };
 
     /*!
      * A meta-range object holds a list of individual ranges.
+     *
+     * validate() checks the list once and keeps its overall start, stop and
+     * step, queries then take O(1) and clip() O(log n). Without it, or once
+     * the list was resized, every query checks the list again. Call it
+     * again after replacing elements in place.
      */
     struct OSMOSDR_API meta_range_t : std::vector<range_t>{
 
@@ -85,7 +89,8 @@ namespace osmosdr{
          */
         template <typename InputIterator>
         meta_range_t(InputIterator first, InputIterator last):
-            std::vector<range_t>(first, last){ /* NOP */ }
+            std::vector<range_t>(first, last),
+            _data(NULL), _size(0), _start(0), _stop(0), _step(0){ /* NOP */ }
 
         /*!
          * A convenience constructor for a single range.
@@ -96,6 +101,17 @@ namespace osmosdr{
          */
         meta_range_t(double start, double stop, double step = 0);
 
+        meta_range_t(const meta_range_t &other);
+        meta_range_t(meta_range_t &&other);
+        meta_range_t &operator=(const meta_range_t &other);
+        meta_range_t &operator=(meta_range_t &&other);
+
+        /*!
+         * Check the ranges and keep the overall start, stop and step.
+         * \throws std::runtime_error if empty or not monotonic
+         */
+        void validate(void);
+
         //! Get the overall start value for this meta-range.
         double start(void) const;
 
@@ -119,6 +135,14 @@ namespace osmosdr{
         //! Convert this meta-range to a printable string
         const std::string to_pp_string(void) const;
 
+    private:
+        //! whether validate() ran for the elements as they are now
+        bool validated(void) const;
+
+        const range_t *_data;
+        size_t _size;
+        double _start, _stop, _step;
+
     };
 
     typedef meta_range_t gain_range_t;
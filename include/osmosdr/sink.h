@@ -25,6 +25,8 @@
 #include <osmosdr/time_spec.h>
 #include <gnuradio/hier_block2.h>
 
+#include <map>
+
 namespace osmosdr {
 
 class sink;
@@ -275,6 +277,23 @@ public:
    */
   virtual osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 ) = 0;
 
+  /*!
+   * Apply several settings of a channel in one go.
+   *
+   * Takes rate, freq, corr, bw, gain_mode (auto or manual), gain, if_gain,
+   * bb_gain, gain:NAME for the gain stage of that name and antenna, all
+   * given as strings. The rate applies to all channels. Values already in
+   * effect are left alone. The device gets the rest at once and can order
+   * and coalesce them, restarting its stream or reinitializing at most
+   * once where single calls would each have done so.
+   *
+   * \param settings the values by name
+   * \param chan the channel index 0 to N-1
+   * \throws std::runtime_error on unknown names or values not numbers
+   */
+  virtual void configure( const std::map< std::string, std::string > &settings,
+                          size_t chan = 0 ) = 0;
+
   /*!
    * Set the time source for the device.
    * This sets the method of time synchronization,
@@ -371,6 +390,23 @@ public:
    * \param time_spec the new time
    */
   virtual void set_time_unknown_pps(const ::osmosdr::time_spec_t &time_spec) = 0;
+
+  /*!
+   * Get the streaming statistics of the device behind a channel.
+   *
+   * Backends with a sample ring between their streaming callback and the
+   * flowgraph report its fill and high-water mark (fill, fill_max,
+   * capacity, in samples), the spacing of the callbacks (callbacks,
+   * interval_mean_us, interval_max_us, interval_jitter_us) and how long
+   * samples wait between work() and the callback (latency_count,
+   * latency_p50_us, latency_p90_us, latency_p99_us, latency_p999_us,
+   * latency_max_us). The percentiles come from logarithmic buckets and
+   * are up to 25 % high.
+   *
+   * \param chan the channel index 0 to N-1
+   * \return the figures by name, empty for backends not keeping them
+   */
+  virtual std::map< std::string, double > get_stats( size_t chan = 0 ) = 0;
 };
 
 } /* namespace osmosdr */
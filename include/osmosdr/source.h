@@ -25,6 +25,8 @@
 #include <osmosdr/time_spec.h>
 #include <gnuradio/hier_block2.h>
 
+#include <map>
+
 namespace osmosdr {
 
 class source;
@@ -77,7 +79,14 @@ public:
   /*!
    * Set the sample rate for the underlying radio hardware.
    * This also will select the appropriate IF bandpass, if applicable.
+   *
+   * A rate the hardware does not support is delivered by resampling from
+   * a native one: the smallest supported multiple of the rate if there is
+   * one, the smallest supported rate above it otherwise. Pass resample=0
+   * as a separate device argument to hand the rate to the hardware as is.
+   *
    * \param rate a new rate in Sps
+   * \return the actual rate in Sps
    */
   virtual double set_sample_rate( double rate ) = 0;
 
@@ -88,6 +97,13 @@ public:
    */
   virtual double get_sample_rate( void ) = 0;
 
+  /*!
+   * Get the rate the hardware samples at. It differs from the one returned
+   * by get_sample_rate() while the samples are resampled.
+   * \return the rate of the hardware in Sps
+   */
+  virtual double get_native_sample_rate( void ) = 0;
+
   /*!
    * Get the tunable frequency range for the underlying radio hardware.
    * \param chan the channel index 0 to N-1
@@ -320,6 +336,23 @@ public:
    */
   virtual osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 ) = 0;
 
+  /*!
+   * Apply several settings of a channel in one go.
+   *
+   * Takes rate, freq, corr, bw, gain_mode (auto or manual), gain, if_gain,
+   * bb_gain, gain:NAME for the gain stage of that name and antenna, all
+   * given as strings. The rate applies to all channels. Values already in
+   * effect are left alone. The device gets the rest at once and can order
+   * and coalesce them, restarting its stream or reinitializing at most
+   * once where single calls would each have done so.
+   *
+   * \param settings the values by name
+   * \param chan the channel index 0 to N-1
+   * \throws std::runtime_error on unknown names or values not numbers
+   */
+  virtual void configure( const std::map< std::string, std::string > &settings,
+                          size_t chan = 0 ) = 0;
+
   /*!
    * Set the time source for the device.
    * This sets the method of time synchronization,
@@ -416,6 +449,89 @@ public:
    * \param time_spec the new time
    */
   virtual void set_time_unknown_pps(const ::osmosdr::time_spec_t &time_spec) = 0;
+
+  /*!
+   * Start hopping all channels through a list of frequencies.
+   *
+   * Retuning is driven by sample counts: every hop passes on exactly the
+   * dwell time worth of samples, the samples in between are dropped. Each
+   * segment starts with rx_freq and rx_time stream tags. While scanning the
+   * block's "scan" message port takes the symbols hold and resume.
+   *
+   * Devices tagging their retunes with rx_freq are exact. For the others
+   * the samples queued when the retune returns and another 100 ms are
+   * dropped, a settle time covers devices buffering more than that.
+   *
+   * Calling it again during a scan restarts with the new list.
+   *
+   * \param freqs the center frequencies in Hz, visited in a loop
+   * \param dwell the time spent on each frequency in seconds
+   * \param settle the time dropped after each retune in seconds
+   */
+  virtual void start_scan( const std::vector< double > &freqs,
+                           double dwell, double settle = 0 ) = 0;
+
+  /*!
+   * Stop a scan started with start_scan, the channels stay on the last
+   * frequency and stream continuously again.
+   */
+  virtual void stop_scan( void ) = 0;
+
+  /*!
+   * Get the channel offsets measured with the align=xcorr argument.
+   *
+   * An offset of d means a channel's stream started d samples later than
+   * the one of channel 0. Samples from all channels leave the block aligned
+   * to each other.
+   *
+   * \return the offset of every channel in samples, empty without alignment
+   */
+  virtual std::vector< double > get_sample_offsets( void ) = 0;
+
+  /*!
+   * Tune a narrowband channel added with the ddc=N argument.
+   *
+   * The N narrowband channels are output on the ports following the ones
+   * of the devices. They are cut from channel ddc_chan, 0 by default, at
+   * its sample rate divided by ddc_decim, 64 by default. All of them share
+   * a single FFT of the wideband stream, so adding one costs in proportion
+   * to its own sample rate only.
+   *
+   * \param offset the offset from the center frequency in Hz
+   * \param ddc the narrowband channel index 0 to N-1
+   * \return the actual offset in Hz
+   */
+  virtual double set_ddc_offset( double offset, size_t ddc = 0 ) = 0;
+
+  /*!
+   * Get the offset of a narrowband channel from the center frequency.
+   * \param ddc the narrowband channel index 0 to N-1
+   * \return the offset in Hz
+   */
+  virtual double get_ddc_offset( size_t ddc = 0 ) = 0;
+
+  /*!
+   * Get the sample rate of the narrowband channels.
+   * \return the rate in Sps, 0 without the ddc argument
+   */
+  virtual double get_ddc_sample_rate( void ) = 0;
+
+  /*!
+   * Get the streaming statistics of the device behind a channel.
+   *
+   * Backends with a sample ring between their streaming callback and the
+   * flowgraph report its fill and high-water mark (fill, fill_max,
+   * capacity, in samples), the spacing of the callbacks (callbacks,
+   * interval_mean_us, interval_max_us, interval_jitter_us) and how long
+   * samples wait between the callback and work() (latency_count,
+   * latency_p50_us, latency_p90_us, latency_p99_us, latency_p999_us,
+   * latency_max_us). The percentiles come from logarithmic buckets and
+   * are up to 25 % high. Sources add their overflows.
+   *
+   * \param chan the channel index 0 to N-1
+   * \return the figures by name, empty for backends not keeping them
+   */
+  virtual std::map< std::string, double > get_stats( size_t chan = 0 ) = 0;
 };
 
 } /* namespace osmosdr */
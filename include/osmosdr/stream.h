@@ -0,0 +1,269 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_OSMOSDR_STREAM_H
+#define INCLUDED_OSMOSDR_STREAM_H
+
+#include <osmosdr/api.h>
+#include <osmosdr/ranges.h>
+#include <osmosdr/time_spec.h>
+#include <gnuradio/gr_complex.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace osmosdr {
+
+/*!
+ * \brief Metadata passed along with a block of samples.
+ *
+ * On receive every field is filled in by read(). On transmit write() uses
+ * the burst flags and, with has_time set, the time of the first sample.
+ */
+struct OSMOSDR_API stream_metadata
+{
+  stream_metadata()
+    : has_time( false ), overflow( false ), freq( 0 ),
+      start_of_burst( false ), end_of_burst( false )
+  {
+  }
+
+  /*! the time of the first sample is in time */
+  bool has_time;
+
+  /*!
+   * The time of the first sample. Received samples carry the device time
+   * when the backend provides one and an estimate from the host clock
+   * otherwise.
+   */
+  time_spec_t time;
+
+  /*! the device lost samples since the previous read */
+  bool overflow;
+
+  /*! the center frequency of every sample of the read in Hz */
+  double freq;
+
+  /*! the first sample written starts a burst */
+  bool start_of_burst;
+
+  /*! the last sample written ends the burst */
+  bool end_of_burst;
+};
+
+/*!
+ * \brief Direct sample access to a device without a flowgraph.
+ *
+ * A stream opens a single device with the same arguments as a source or a
+ * sink and calls into its backend from the thread calling read() or
+ * write(), so there is neither a scheduler nor any buffer in between. Only
+ * backends implemented as a single synchronous block support this, the
+ * ones built from a flowgraph of their own (file, fcd, uhd) do not.
+ *
+ * A read never spans a retune: when the frequency changes in the middle of
+ * the samples, the read ends in front of the first sample at the new
+ * frequency and the next one starts with it.
+ */
+class OSMOSDR_API stream
+{
+public:
+  typedef std::shared_ptr< stream > sptr;
+
+  enum direction_t {
+    RX = 0,
+    TX
+  };
+
+  /*!
+   * \brief Return a shared_ptr to a new instance of stream.
+   *
+   * \param direction RX to read from a source, TX to write to a sink
+   * \param args the address to identify the hardware
+   * \return a new osmosdr stream object
+   */
+  static sptr make( direction_t direction, const std::string & args = "" );
+
+  virtual ~stream() = default;
+
+  /*!
+   * Get the number of channels, read() and write() take one buffer for each.
+   * \return the number of available channels
+   */
+  virtual size_t get_num_channels( void ) = 0;
+
+  /*!
+   * Start streaming on the device.
+   * \return true on success
+   */
+  virtual bool activate( void ) = 0;
+
+  /*!
+   * Stop streaming on the device.
+   * \return true on success
+   */
+  virtual bool deactivate( void ) = 0;
+
+  /*!
+   * Read samples of an active receive stream.
+   *
+   * The timeout is advisory. It is checked between the calls into the
+   * backend, each of which blocks until the device delivers a buffer, so
+   * a read may return up to one buffer time late, or later while a device
+   * that just started streaming has not delivered its first samples.
+   *
+   * \param buffs one buffer of at least nitems samples per channel
+   * \param nitems the number of samples to read
+   * \param timeout the time to wait for samples in seconds
+   * \param meta receives the metadata of the samples read
+   * \return the number of samples read, 0 on timeout and -1 once the
+   * device stopped streaming
+   */
+  virtual int read( const std::vector< gr_complex * > &buffs, size_t nitems,
+                    double timeout, stream_metadata &meta ) = 0;
+
+  /*!
+   * Write samples to an active transmit stream.
+   *
+   * The timeout is advisory like the one of read(), a backend waiting for
+   * room in its buffers is not interrupted by it.
+   *
+   * \param buffs one buffer of nitems samples per channel
+   * \param nitems the number of samples to write
+   * \param timeout the time to wait for the device in seconds
+   * \param meta the burst flags and time of the samples
+   * \return the number of samples written, -1 once the device stopped
+   */
+  virtual int write( const std::vector< const gr_complex * > &buffs, size_t nitems,
+                     double timeout,
+                     const stream_metadata &meta = stream_metadata() ) = 0;
+
+  /*!
+   * Get the possible sample rates for the underlying radio hardware.
+   * \return a range of rates in Sps
+   */
+  virtual osmosdr::meta_range_t get_sample_rates( void ) = 0;
+
+  /*!
+   * Set the sample rate for the underlying radio hardware.
+   * \param rate a new rate in Sps
+   * \return the actual rate in Sps
+   */
+  virtual double set_sample_rate( double rate ) = 0;
+
+  /*!
+   * Get the sample rate for the underlying radio hardware.
+   * \return the actual rate in Sps
+   */
+  virtual double get_sample_rate( void ) = 0;
+
+  /*!
+   * Get the tunable frequency range for the underlying radio hardware.
+   * \param chan the channel index 0 to N-1
+   * \return the frequency range in Hz
+   */
+  virtual osmosdr::freq_range_t get_freq_range( size_t chan = 0 ) = 0;
+
+  /*!
+   * Tune the underlying radio hardware to the desired center frequency.
+   * \param freq the desired frequency in Hz
+   * \param chan the channel index 0 to N-1
+   * \return the actual frequency in Hz
+   */
+  virtual double set_center_freq( double freq, size_t chan = 0 ) = 0;
+
+  /*!
+   * Get the center frequency the underlying radio hardware is tuned to.
+   * \param chan the channel index 0 to N-1
+   * \return the frequency in Hz
+   */
+  virtual double get_center_freq( size_t chan = 0 ) = 0;
+
+  /*!
+   * Get the settable overall gain range for the underlying radio hardware.
+   * \param chan the channel index 0 to N-1
+   * \return the gain range in dB
+   */
+  virtual osmosdr::gain_range_t get_gain_range( size_t chan = 0 ) = 0;
+
+  /*!
+   * Set the gain mode for the underlying radio hardware.
+   * \param automatic the gain mode (true means automatic gain mode)
+   * \param chan the channel index 0 to N-1
+   * \return the actual gain mode
+   */
+  virtual bool set_gain_mode( bool automatic, size_t chan = 0 ) = 0;
+
+  /*!
+   * Set the overall gain for the underlying radio hardware.
+   * \param gain the gain in dB
+   * \param chan the channel index 0 to N-1
+   * \return the actual gain in dB
+   */
+  virtual double set_gain( double gain, size_t chan = 0 ) = 0;
+
+  /*!
+   * Get the actual overall gain of the underlying radio hardware.
+   * \param chan the channel index 0 to N-1
+   * \return the actual gain in dB
+   */
+  virtual double get_gain( size_t chan = 0 ) = 0;
+
+  /*!
+   * Get the available antennas of the underlying radio hardware.
+   * \param chan the channel index 0 to N-1
+   * \return a vector of strings containing the names of available antennas
+   */
+  virtual std::vector< std::string > get_antennas( size_t chan = 0 ) = 0;
+
+  /*!
+   * Select the active antenna of the underlying radio hardware.
+   * \param antenna the antenna name
+   * \param chan the channel index 0 to N-1
+   * \return the actual antenna's name
+   */
+  virtual std::string set_antenna( const std::string & antenna,
+                                   size_t chan = 0 ) = 0;
+
+  /*!
+   * Get the actual underlying radio hardware antenna setting.
+   * \param chan the channel index 0 to N-1
+   * \return the actual antenna's name
+   */
+  virtual std::string get_antenna( size_t chan = 0 ) = 0;
+
+  /*!
+   * Set the bandpass filter on the radio frontend.
+   * \param bandwidth the filter bandwidth in Hz, set to 0 for automatic selection
+   * \param chan the channel index 0 to N-1
+   * \return the actual filter bandwidth in Hz
+   */
+  virtual double set_bandwidth( double bandwidth, size_t chan = 0 ) = 0;
+
+  /*!
+   * Get the actual bandpass filter setting on the radio frontend.
+   * \param chan the channel index 0 to N-1
+   * \return the actual filter bandwidth in Hz
+   */
+  virtual double get_bandwidth( size_t chan = 0 ) = 0;
+};
+
+} /* namespace osmosdr */
+
+#endif /* INCLUDED_OSMOSDR_STREAM_H */
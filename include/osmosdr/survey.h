@@ -0,0 +1,95 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_OSMOSDR_SURVEY_H
+#define INCLUDED_OSMOSDR_SURVEY_H
+
+#include <osmosdr/api.h>
+#include <osmosdr/source.h>
+#include <gnuradio/block.h>
+
+namespace osmosdr {
+
+/*!
+ * \brief Sweeps a frequency range with a source and outputs power spectra.
+ * \ingroup block
+ *
+ * The survey splits the range into hops, starts a scan on the given source
+ * and expects that source's output on its input. Each hop is averaged from
+ * 50% overlapping Blackman-Harris windowed FFTs computed on worker threads,
+ * the center part of the band is kept and the hops are stitched into a
+ * single frequency ordered vector of linear power per bin.
+ *
+ * One output vector is produced per complete sweep, tagged with the rx_time
+ * of its first hop. Sweeps missing a hop are dropped.
+ */
+class OSMOSDR_API survey : virtual public gr::block
+{
+public:
+  typedef std::shared_ptr< survey > sptr;
+
+  /*!
+   * \brief Return a shared_ptr to a new instance of survey.
+   *
+   * The sample rate of the source has to be set before, the hop plan is
+   * derived from it.
+   *
+   * \param src the source to scan, its output feeds the survey
+   * \param start_freq the lower edge of the range in Hz
+   * \param stop_freq the upper edge of the range in Hz
+   * \param fft_len the FFT size, sets the bin width to rate / fft_len
+   * \param avg the number of FFTs averaged per hop
+   * \param usable the fraction of each hop's bins kept for the output
+   * \param settle the time dropped after each retune in seconds
+   * \param threads the number of FFT workers, 0 picks one per core
+   * \return a new osmosdr survey block object
+   */
+  static sptr make( source::sptr src, double start_freq, double stop_freq,
+                    size_t fft_len = 1024, size_t avg = 16,
+                    double usable = 0.75, double settle = 0,
+                    size_t threads = 0 );
+
+  /*!
+   * Get the length of the output vectors.
+   * \return the number of bins in a sweep
+   */
+  virtual size_t get_num_bins( void ) = 0;
+
+  /*!
+   * Get the width of one output bin.
+   * \return the bin width in Hz
+   */
+  virtual double get_bin_width( void ) = 0;
+
+  /*!
+   * Get the center frequency of each output bin.
+   * \return a vector of get_num_bins() frequencies in Hz
+   */
+  virtual std::vector< double > get_freqs( void ) = 0;
+
+  /*!
+   * Get the center frequencies the source is hopping through.
+   * \return the hop frequencies in Hz
+   */
+  virtual std::vector< double > get_hops( void ) = 0;
+};
+
+} /* namespace osmosdr */
+
+#endif /* INCLUDED_OSMOSDR_SURVEY_H */
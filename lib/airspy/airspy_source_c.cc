@@ -30,6 +30,7 @@
 #include <stdexcept>
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 
 #include <boost/assign.hpp>
 #include <boost/format.hpp>
@@ -38,10 +39,17 @@
 
 #include <gnuradio/io_signature.h>
 
+#include <pmt/pmt.h>
+
 #include "airspy_source_c.h"
 #include "airspy_fir_kernels.h"
 
 #include "arg_helpers.h"
+#include "convert_helpers.h"
+
+static const pmt::pmt_t RX_FREQ_KEY = pmt::string_to_symbol("rx_freq");
+static const pmt::pmt_t RX_DROPPED_KEY = pmt::string_to_symbol("rx_dropped");
+static const pmt::pmt_t RX_TIME_KEY = pmt::string_to_symbol("rx_time");
 
 using namespace boost::assign;
 
@@ -81,10 +89,11 @@ static const int MAX_OUT = 1;	// maximum number of output streams
  * The private constructor
  */
 airspy_source_c::airspy_source_c (const std::string &args)
-  : gr::sync_block ("airspy_source_c",
+  : direct_block ("airspy_source_c",
         gr::io_signature::make(MIN_IN, MAX_IN, sizeof (gr_complex)),
-        gr::io_signature::make(MIN_OUT, MAX_OUT, sizeof (gr_complex))),
+        gr::io_signature::make(MIN_OUT, MAX_OUT, args_to_item_size(args))),
     _dev(NULL),
+    _item_size(args_to_item_size(args)),
     _sample_rate(0),
     _center_freq(0),
     _freq_corr(0),
@@ -93,7 +102,9 @@ airspy_source_c::airspy_source_c (const std::string &args)
     _lna_gain(0),
     _mix_gain(0),
     _vga_gain(0),
-    _bandwidth(0)
+    _bandwidth(0),
+    _fifo_in(0),
+    _settle_ms(0)
 {
   int ret;
 
@@ -135,6 +146,13 @@ airspy_source_c::airspy_source_c (const std::string &args)
 
   std::cerr << std::endl;
 
+  /* integer items come from the int16 converter of libairspy, sc8 keeps
+   * its upper half */
+  if ( _item_size != sizeof(gr_complex) ) {
+    ret = airspy_set_sample_type( _dev, AIRSPY_SAMPLE_INT16_IQ );
+    AIRSPY_THROW_ON_ERROR(ret, "Failed to set the int16 sample type")
+  }
+
   set_center_freq( (get_freq_range().start() + get_freq_range().stop()) / 2.0 );
   set_sample_rate( get_sample_rates().start() );
   set_bandwidth( 0 );
@@ -151,6 +169,16 @@ airspy_source_c::airspy_source_c (const std::string &args)
 
   set_if_gain( 5 ); /* preset to a reasonable default (non-GRC use case) */
 
+  if ( dict.count( "settle_ms" ) )
+    _settle_ms = boost::lexical_cast< double >( dict["settle_ms"] );
+
+  if ( dict.count( "time_period" ) )
+    _clock.set_tag_period( boost::lexical_cast< double >( dict["time_period"] ) );
+  else
+    _clock.set_tag_period( 1.0 );
+
+  _sched.set( dict );
+
   if ( dict.count( "bias" ) )
   {
     bool bias = boost::lexical_cast<bool>( dict["bias"] );
@@ -168,7 +196,8 @@ airspy_source_c::airspy_source_c (const std::string &args)
     AIRSPY_THROW_ON_ERROR(ret, "Failed to set USB bit packing")
   }
 
-  _fifo = new boost::circular_buffer<gr_complex>(5000000);
+  _fifo = new fifo_t( 5000000 * _item_size,
+                      pool_allocator< uint8_t >( args_to_numa_node( dict ) ) );
   if (!_fifo) {
     throw std::runtime_error( std::string(__FUNCTION__) + " " +
                               "Failed to allocate a sample FIFO!" );
@@ -211,28 +240,53 @@ int airspy_source_c::_airspy_rx_callback(airspy_transfer *transfer)
 {
   airspy_source_c *obj = (airspy_source_c *)transfer->ctx;
 
-  return obj->airspy_rx_callback((float *)transfer->samples, transfer->sample_count);
+  return obj->airspy_rx_callback(transfer->samples, transfer->sample_count);
 }
 
 int airspy_source_c::airspy_rx_callback(void *samples, int sample_count)
 {
-  size_t i, n_avail, to_copy, num_samples = sample_count;
-  float *sample = (float *)samples;
+  size_t n_avail, to_copy, num_samples = sample_count;
+  const uint8_t *sample = (const uint8_t *)samples;
+
+  /* libairspy hands out complex float or complex int16 */
+  const size_t xfer_size = _item_size == sizeof(gr_complex) ?
+                           sizeof(gr_complex) : 2 * sizeof(int16_t);
+
+  _sched.apply_once( "airspy rx callback" );
+
+  uint64_t now = _stats.arrival();
+  uint64_t count = _clock.arrival( num_samples );
 
   _fifo_lock.lock();
 
-  n_avail = _fifo->capacity() - _fifo->size();
+  retune_mark mark = _retune.transfer( num_samples );
+  sample += xfer_size * mark.skip; /* settling samples */
+  num_samples -= mark.skip;
+
+  if ( mark.valid )
+    _retune_marks.push_back( std::make_pair( _fifo_in, mark ) );
+
+  n_avail = (_fifo->capacity() - _fifo->size()) / _item_size;
   to_copy = (n_avail < num_samples ? n_avail : num_samples);
 
-  for (i = 0; i < to_copy; i++ )
-  {
-    /* Push sample to the fifo */
-    _fifo->push_back( gr_complex( *sample, *(sample+1) ) );
+  if ( _item_size != xfer_size ) {
+    _conv.resize( 2 * to_copy );
+    convert_16i_to_8i( (const int16_t *)sample, &_conv[0], 2 * to_copy, 8 );
+    sample = (const uint8_t *)&_conv[0];
+  }
+
+  _fifo->insert( _fifo->end(), sample, sample + to_copy * _item_size );
 
-    /* offset to the next I+Q sample */
-    sample += 2;
+  if ( to_copy ) {
+    time_mark tmark = { _fifo_in, count + mark.skip, to_copy };
+    _time_marks.push_back( tmark );
   }
 
+  _fifo_in += to_copy;
+
+  _arrivals.queued( to_copy, now );
+  _stats.fill( _fifo->size() / _item_size, _fifo->capacity() / _item_size );
+
   _fifo_lock.unlock();
 
   /* We have made some new samples available to the consumer in work() */
@@ -242,8 +296,10 @@ int airspy_source_c::airspy_rx_callback(void *samples, int sample_count)
   }
 
   /* Indicate overrun, if neccesary */
-  if (to_copy < num_samples)
+  if (to_copy < num_samples) {
+    _overflows++;
     std::cerr << "O" << std::flush;
+  }
 
   return 0; // TODO: return -1 on error/stop
 }
@@ -253,6 +309,15 @@ bool airspy_source_c::start()
   if ( ! _dev )
     return false;
 
+  {
+    /* the first sample carries the frequency we start on */
+    std::lock_guard<std::mutex> lock( _fifo_lock );
+    _fifo_in = nitems_written(0) + _fifo->size() / _item_size;
+    _retune.arm( get_center_freq(), get_sample_rate(), 0 );
+  }
+
+  _clock.reset( get_sample_rate() );
+
   int ret = airspy_start_rx( _dev, _airspy_rx_callback, (void *)this );
   if ( ret != AIRSPY_SUCCESS ) {
     std::cerr << "Failed to start RX streaming (" << ret << ")" << std::endl;
@@ -280,7 +345,7 @@ int airspy_source_c::work( int noutput_items,
                         gr_vector_const_void_star &input_items,
                         gr_vector_void_star &output_items )
 {
-  gr_complex *out = (gr_complex *)output_items[0];
+  uint8_t *out = (uint8_t *)output_items[0];
 
   bool running = false;
 
@@ -293,16 +358,52 @@ int airspy_source_c::work( int noutput_items,
   std::unique_lock<std::mutex> lock(_fifo_lock);
 
   /* Wait until we have the requested number of samples */
-  int n_samples_avail = _fifo->size();
+  int n_samples_avail = _fifo->size() / _item_size;
 
   while (n_samples_avail < noutput_items) {
     _samp_avail.wait(lock);
-    n_samples_avail = _fifo->size();
+    n_samples_avail = _fifo->size() / _item_size;
   }
 
-  for(int i = 0; i < noutput_items; ++i) {
-    out[i] = _fifo->at(0);
-    _fifo->pop_front();
+  /* the fifo wraps around at most once */
+  size_t nbytes = noutput_items * _item_size;
+  fifo_t::array_range one = _fifo->array_one();
+  size_t head = std::min( nbytes, one.second );
+
+  memcpy( out, one.first, head );
+  if ( head < nbytes )
+    memcpy( out + head, _fifo->array_two().first, nbytes - head );
+
+  _fifo->erase_begin( nbytes );
+
+  _arrivals.taken( noutput_items, _stats );
+  _stats.fill( _fifo->size() / _item_size, _fifo->capacity() / _item_size );
+
+  /* the fifo position of a sample equals its output position */
+  uint64_t first = nitems_written(0);
+
+  while ( !_retune_marks.empty() &&
+          _retune_marks.front().first < first + noutput_items ) {
+    uint64_t offset = std::max( _retune_marks.front().first, first );
+    const retune_mark &mark = _retune_marks.front().second;
+
+    add_item_tag(0, offset, RX_FREQ_KEY, pmt::from_double(mark.freq));
+    if ( mark.dropped )
+      add_item_tag(0, offset, RX_DROPPED_KEY, pmt::from_uint64(mark.dropped));
+
+    _retune_marks.pop_front();
+  }
+
+  while ( !_time_marks.empty() &&
+          _time_marks.front().pos < first + noutput_items ) {
+    const time_mark &tmark = _time_marks.front();
+    uint64_t offset = std::max( tmark.pos, first );
+
+    if ( _clock.tag_due( tmark.count, tmark.nitems ) )
+      add_item_tag(0, offset, RX_TIME_KEY,
+                   time_to_pmt(_clock.time_of( tmark.count + offset - tmark.pos )));
+
+    _time_marks.pop_front();
   }
 
   //std::cerr << "-" << std::flush;
@@ -345,6 +446,20 @@ size_t airspy_source_c::get_num_channels()
   return 1;
 }
 
+uint64_t airspy_source_c::get_overflows()
+{
+  return _overflows;
+}
+
+std::map<std::string, double> airspy_source_c::get_stats( size_t chan )
+{
+  std::map<std::string, double> stats;
+  _stats.report( stats );
+  _sched.report( stats );
+
+  return stats;
+}
+
 osmosdr::meta_range_t airspy_source_c::get_sample_rates()
 {
   osmosdr::meta_range_t range;
@@ -382,6 +497,7 @@ double airspy_source_c::set_sample_rate( double rate )
     ret = airspy_set_samplerate( _dev, samp_rate_index );
     if ( AIRSPY_SUCCESS == ret ) {
       _sample_rate = rate;
+      _clock.set_rate( rate );
     } else {
       AIRSPY_THROW_ON_ERROR( ret, AIRSPY_FUNC_STR( "airspy_set_samplerate", rate ) )
     }
@@ -415,6 +531,9 @@ double airspy_source_c::set_center_freq( double freq, size_t chan )
     ret = airspy_set_freq( _dev, uint64_t(corr_freq) );
     if ( AIRSPY_SUCCESS == ret ) {
       _center_freq = freq;
+
+      std::lock_guard<std::mutex> lock( _fifo_lock );
+      _retune.arm( freq, _sample_rate, _settle_ms );
     } else {
       AIRSPY_THROW_ON_ERROR( ret, AIRSPY_FUNC_STR( "airspy_set_freq", corr_freq ) )
     }
@@ -649,7 +768,8 @@ std::string airspy_source_c::get_antenna( size_t chan )
 
 double airspy_source_c::set_bandwidth( double bandwidth, size_t chan )
 {
-  if (bandwidth == 0.f)
+  /* the int16 converter keeps its own filter */
+  if (bandwidth == 0.f || _item_size != sizeof(gr_complex))
     return get_bandwidth( chan );
 
   {
@@ -711,3 +831,13 @@ osmosdr::freq_range_t airspy_source_c::get_bandwidth_range( size_t chan )
 
   return bandwidths;
 }
+
+::osmosdr::time_spec_t airspy_source_c::get_time_now( size_t mboard )
+{
+  return _clock.now();
+}
+
+void airspy_source_c::set_time_now( const ::osmosdr::time_spec_t &time_spec, size_t mboard )
+{
+  _clock.set_time( time_spec );
+}
@@ -24,14 +24,22 @@
 
 #include <boost/circular_buffer.hpp>
 
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
+#include <deque>
 
 #include <gnuradio/sync_block.h>
 
 #include <libairspy/airspy.h>
 
 #include "source_iface.h"
+#include "direct_block.h"
+#include "retune_helpers.h"
+#include "stats_helpers.h"
+#include "time_helpers.h"
+#include "sched_helpers.h"
+#include "pool_helpers.h"
 
 class airspy_source_c;
 
@@ -62,7 +70,7 @@ airspy_source_c_sptr make_airspy_source_c (const std::string & args = "");
  * \ingroup block
  */
 class airspy_source_c :
-    public gr::sync_block,
+    public direct_block,
     public source_iface
 {
 private:
@@ -89,6 +97,8 @@ public:
   static std::vector< std::string > get_devices();
 
   size_t get_num_channels( void );
+  uint64_t get_overflows( void );
+  std::map< std::string, double > get_stats( size_t chan = 0 );
 
   osmosdr::meta_range_t get_sample_rates( void );
   double set_sample_rate( double rate );
@@ -122,13 +132,20 @@ public:
   double get_bandwidth( size_t chan = 0 );
   osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 );
 
+  ::osmosdr::time_spec_t get_time_now( size_t mboard = 0 );
+  void set_time_now( const ::osmosdr::time_spec_t &time_spec, size_t mboard = 0 );
+
 private:
   static int _airspy_rx_callback(airspy_transfer* transfer);
   int airspy_rx_callback(void *samples, int sample_count);
 
   airspy_device *_dev;
 
-  boost::circular_buffer<gr_complex> *_fifo;
+  /* samples as handed out, of complex float, int16 or int8 */
+  size_t _item_size;
+  typedef boost::circular_buffer< uint8_t, pool_allocator< uint8_t > > fifo_t;
+  fifo_t *_fifo;
+  std::vector<int8_t> _conv;
   std::mutex _fifo_lock;
   std::condition_variable _samp_avail;
 
@@ -148,6 +165,22 @@ private:
   double _mix_gain;
   double _vga_gain;
   double _bandwidth;
+
+  /* retune marks by position in the sample stream */
+  std::deque< std::pair<uint64_t, retune_mark> > _retune_marks;
+  retune_tracker _retune;
+  uint64_t _fifo_in;
+  double _settle_ms;
+
+  std::atomic<uint64_t> _overflows{0};
+
+  fifo_arrivals _arrivals;
+  stream_stats _stats;
+
+  std::deque< time_mark > _time_marks;
+  host_clock _clock;
+
+  io_sched _sched;
 };
 
 #endif /* INCLUDED_AIRSPY_SOURCE_C_H */
@@ -34,6 +34,7 @@
 #include <boost/assign.hpp>
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/thread/thread.hpp>
 
 #include <gnuradio/io_signature.h>
@@ -41,6 +42,8 @@
 #include "airspyhf_source_c.h"
 #include "arg_helpers.h"
 
+static const pmt::pmt_t RX_TIME_KEY = pmt::string_to_symbol("rx_time");
+
 using namespace boost::assign;
 
 #define AIRSPYHF_FORMAT_ERROR(ret, msg) \
@@ -78,18 +81,26 @@ static const int MAX_OUT = 1;	// maximum number of output streams
  * The private constructor
  */
 airspyhf_source_c::airspyhf_source_c (const std::string &args)
-  : gr::sync_block ("airspyhf_source_c",
+  : direct_block ("airspyhf_source_c",
         gr::io_signature::make(MIN_IN, MAX_IN, sizeof (gr_complex)),
         gr::io_signature::make(MIN_OUT, MAX_OUT, sizeof (gr_complex))),
     _dev(NULL),
     _sample_rate(0),
     _center_freq(0),
-    _freq_corr(0)
+    _freq_corr(0),
+    _fifo_in(0)
 {
   int ret;
 
   dict_t dict = params_to_dict(args);
 
+  if ( dict.count( "time_period" ) )
+    _clock.set_tag_period( boost::lexical_cast< double >( dict["time_period"] ) );
+  else
+    _clock.set_tag_period( 1.0 );
+
+  _sched.set( dict );
+
   _dev = NULL;
   ret = airspyhf_open( &_dev );
   AIRSPYHF_THROW_ON_ERROR(ret, "Failed to open Airspy HF+ device")
@@ -116,7 +127,8 @@ airspyhf_source_c::airspyhf_source_c (const std::string &args)
   set_center_freq( (get_freq_range().start() + get_freq_range().stop()) / 2.0 );
   set_sample_rate( get_sample_rates().start() );
 
-  _fifo = new boost::circular_buffer<gr_complex>(5000000);
+  _fifo = new fifo_t( 5000000,
+                      pool_allocator< gr_complex >( args_to_numa_node( dict ) ) );
   if (!_fifo) {
     throw std::runtime_error( std::string(__FUNCTION__) + " " +
                               "Failed to allocate a sample FIFO!" );
@@ -167,6 +179,11 @@ int airspyhf_source_c::airspyhf_rx_callback(void *samples, int sample_count)
   size_t i, n_avail, to_copy, num_samples = sample_count;
   float *sample = (float *)samples;
 
+  _sched.apply_once( "airspyhf rx callback" );
+
+  uint64_t now = _stats.arrival();
+  uint64_t count = _clock.arrival( num_samples );
+
   _fifo_lock.lock();
 
   n_avail = _fifo->capacity() - _fifo->size();
@@ -181,6 +198,16 @@ int airspyhf_source_c::airspyhf_rx_callback(void *samples, int sample_count)
     sample += 2;
   }
 
+  if ( to_copy ) {
+    time_mark tmark = { _fifo_in, count, to_copy };
+    _time_marks.push_back( tmark );
+  }
+
+  _fifo_in += to_copy;
+
+  _arrivals.queued( to_copy, now );
+  _stats.fill( _fifo->size(), _fifo->capacity() );
+
   _fifo_lock.unlock();
 
   /* We have made some new samples available to the consumer in work() */
@@ -190,8 +217,10 @@ int airspyhf_source_c::airspyhf_rx_callback(void *samples, int sample_count)
   }
 
   /* Indicate overrun, if neccesary */
-  if (to_copy < num_samples)
+  if (to_copy < num_samples) {
+    _overflows++;
     std::cerr << "O" << std::flush;
+  }
 
   return 0; // TODO: return -1 on error/stop
 }
@@ -201,6 +230,13 @@ bool airspyhf_source_c::start()
   if ( ! _dev )
     return false;
 
+  {
+    std::lock_guard<std::mutex> lock(_fifo_lock);
+    _fifo_in = nitems_written(0) + _fifo->size();
+  }
+
+  _clock.reset( get_sample_rate() );
+
   int ret = airspyhf_start( _dev, _airspyhf_rx_callback, (void *)this );
   if ( ret != AIRSPYHF_SUCCESS ) {
     std::cerr << "Failed to start RX streaming (" << ret << ")" << std::endl;
@@ -253,6 +289,24 @@ int airspyhf_source_c::work( int noutput_items,
     _fifo->pop_front();
   }
 
+  _arrivals.taken( noutput_items, _stats );
+  _stats.fill( _fifo->size(), _fifo->capacity() );
+
+  /* the fifo position of a sample equals its output position */
+  uint64_t first = nitems_written(0);
+
+  while ( !_time_marks.empty() &&
+          _time_marks.front().pos < first + noutput_items ) {
+    const time_mark &tmark = _time_marks.front();
+    uint64_t offset = std::max( tmark.pos, first );
+
+    if ( _clock.tag_due( tmark.count, tmark.nitems ) )
+      add_item_tag(0, offset, RX_TIME_KEY,
+                   time_to_pmt(_clock.time_of( tmark.count + offset - tmark.pos )));
+
+    _time_marks.pop_front();
+  }
+
   return noutput_items;
 }
 
@@ -279,6 +333,20 @@ size_t airspyhf_source_c::get_num_channels()
   return 1;
 }
 
+uint64_t airspyhf_source_c::get_overflows()
+{
+  return _overflows;
+}
+
+std::map<std::string, double> airspyhf_source_c::get_stats( size_t chan )
+{
+  std::map<std::string, double> stats;
+  _stats.report( stats );
+  _sched.report( stats );
+
+  return stats;
+}
+
 osmosdr::meta_range_t airspyhf_source_c::get_sample_rates()
 {
   osmosdr::meta_range_t range;
@@ -316,6 +384,7 @@ double airspyhf_source_c::set_sample_rate( double rate )
     ret = airspyhf_set_samplerate( _dev, samp_rate_index );
     if ( AIRSPYHF_SUCCESS == ret ) {
       _sample_rate = rate;
+      _clock.set_rate( rate );
     } else {
       AIRSPYHF_THROW_ON_ERROR( ret, AIRSPYHF_FUNC_STR( "airspyhf_set_samplerate", rate ) )
     }
@@ -435,3 +504,13 @@ std::string airspyhf_source_c::get_antenna( size_t chan )
 {
   return "RX";
 }
+
+::osmosdr::time_spec_t airspyhf_source_c::get_time_now( size_t mboard )
+{
+  return _clock.now();
+}
+
+void airspyhf_source_c::set_time_now( const ::osmosdr::time_spec_t &time_spec, size_t mboard )
+{
+  _clock.set_time( time_spec );
+}
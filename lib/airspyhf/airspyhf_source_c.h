@@ -24,6 +24,7 @@
 
 #include <boost/circular_buffer.hpp>
 
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 
@@ -32,6 +33,11 @@
 #include <libairspyhf/airspyhf.h>
 
 #include "source_iface.h"
+#include "direct_block.h"
+#include "stats_helpers.h"
+#include "time_helpers.h"
+#include "sched_helpers.h"
+#include "pool_helpers.h"
 
 class airspyhf_source_c;
 
@@ -51,7 +57,7 @@ airspyhf_source_c_sptr make_airspyhf_source_c (const std::string & args = "");
  * \ingroup block
  */
 class airspyhf_source_c :
-    public gr::sync_block,
+    public direct_block,
     public source_iface
 {
 private:
@@ -75,6 +81,8 @@ public:
   static std::vector< std::string > get_devices();
 
   size_t get_num_channels( void );
+  uint64_t get_overflows( void );
+  std::map< std::string, double > get_stats( size_t chan = 0 );
 
   osmosdr::meta_range_t get_sample_rates( void );
   double set_sample_rate( double rate );
@@ -98,6 +106,8 @@ public:
   std::string set_antenna( const std::string & antenna, size_t chan = 0 );
   std::string get_antenna( size_t chan = 0 );
 
+  ::osmosdr::time_spec_t get_time_now( size_t mboard = 0 );
+  void set_time_now( const ::osmosdr::time_spec_t &time_spec, size_t mboard = 0 );
 
 private:
   static int _airspyhf_rx_callback(airspyhf_transfer_t* transfer);
@@ -105,7 +115,8 @@ private:
 
   airspyhf_device *_dev;
 
-  boost::circular_buffer<gr_complex> *_fifo;
+  typedef boost::circular_buffer< gr_complex, pool_allocator< gr_complex > > fifo_t;
+  fifo_t *_fifo;
   std::mutex _fifo_lock;
   std::condition_variable _samp_avail;
 
@@ -113,6 +124,17 @@ private:
   double _sample_rate;
   double _center_freq;
   double _freq_corr;
+
+  std::atomic<uint64_t> _overflows{0};
+
+  fifo_arrivals _arrivals;
+  stream_stats _stats;
+
+  uint64_t _fifo_in;    /* output position of the next sample queued */
+  std::deque< time_mark > _time_marks;
+  host_clock _clock;
+
+  io_sched _sched;
 };
 
 #endif /* INCLUDED_AIRSPY_SOURCE_C_H */
@@ -0,0 +1,305 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/fft/fft.h>
+
+#include <volk/volk.h>
+
+#include "align_cc.h"
+
+/* fractional delay interpolator length, mu = 0 hits tap ALIGN_CENTER */
+#define ALIGN_NTAPS 16
+#define ALIGN_CENTER 7
+
+/* fractions closer to a whole sample than this are rounded */
+#define ALIGN_MIN_FRAC 1e-3
+
+/* correlation peak over its mean magnitude needed to trust an estimate */
+#define ALIGN_MIN_PEAK 8.0
+
+static const pmt::pmt_t RX_ALIGN_KEY = pmt::string_to_symbol("rx_align");
+
+align_cc_sptr make_align_cc( size_t nchan, size_t cal_len, uint64_t period )
+{
+  return gnuradio::get_initial_sptr( new align_cc( nchan, cal_len, period ) );
+}
+
+align_cc::align_cc( size_t nchan, size_t cal_len, uint64_t period )
+  : gr::block( "align_cc",
+               gr::io_signature::make( nchan, nchan, sizeof(gr_complex) ),
+               gr::io_signature::make( nchan, nchan, sizeof(gr_complex) ) ),
+    _nchan( nchan ),
+    _cal_len( cal_len ),
+    _period( period ),
+    _offsets( nchan, 0.0 ),
+    _aligned( false ),
+    _tag( false ),
+    _since( 0 ),
+    _cal( nchan, std::vector< gr_complex >( cal_len ) ),
+    _cal_pos( nchan, 0 ),
+    _cal_fill( 0 ),
+    _collecting( false ),
+    _skip( nchan, 0 ),
+    _frac( nchan, false ),
+    _taps( nchan, std::vector< float >( ALIGN_NTAPS, 0.0f ) ),
+    _hist( nchan, std::vector< gr_complex >( ALIGN_NTAPS - 1 ) )
+{
+  set_tag_propagation_policy( TPP_ONE_TO_ONE );
+
+  for ( size_t chan = 0; chan < _nchan; chan++ )
+    design( chan, 0 );
+}
+
+std::vector< double > align_cc::offsets()
+{
+  std::lock_guard< std::mutex > lock( _lock );
+
+  return _offsets;
+}
+
+void align_cc::set_period( uint64_t period )
+{
+  _period = period;
+}
+
+void align_cc::design( size_t chan, double mu )
+{
+  std::vector< float > &taps = _taps[chan];
+
+  _frac[chan] = mu >= ALIGN_MIN_FRAC;
+
+  /* windowed sinc around x(ALIGN_CENTER + mu), the window follows mu */
+  double sum = 0;
+  for ( int j = 0; j < ALIGN_NTAPS; j++ ) {
+    double x = j - ALIGN_CENTER - mu;
+    double t = x / ALIGN_NTAPS + 0.5;
+    double w = 0.42 - 0.5 * std::cos( 2 * M_PI * t ) + 0.08 * std::cos( 4 * M_PI * t );
+    double s = std::fabs( x ) < 1e-9 ? 1.0 : std::sin( M_PI * x ) / ( M_PI * x );
+    taps[j] = float( s * w );
+    sum += taps[j];
+  }
+
+  for ( float &tap : taps )
+    tap /= float( sum );
+}
+
+/* offset of every channel against channel 0 from the calibration window */
+bool align_cc::estimate()
+{
+  const size_t len = 2 * _cal_len; /* zero padded to get a linear correlation */
+
+  gr::fft::fft_complex_fwd fwd( len );
+  gr::fft::fft_complex_rev rev( len );
+
+  std::vector< gr_complex > ref( len );
+  std::vector< float > mag( len );
+  std::vector< double > offsets( _nchan, 0.0 );
+
+  std::fill( fwd.get_inbuf(), fwd.get_inbuf() + len, gr_complex( 0, 0 ) );
+  memcpy( fwd.get_inbuf(), _cal[0].data(), _cal_len * sizeof(gr_complex) );
+  fwd.execute();
+  memcpy( ref.data(), fwd.get_outbuf(), len * sizeof(gr_complex) );
+
+  for ( size_t chan = 1; chan < _nchan; chan++ ) {
+    std::fill( fwd.get_inbuf(), fwd.get_inbuf() + len, gr_complex( 0, 0 ) );
+    memcpy( fwd.get_inbuf(), _cal[chan].data(), _cal_len * sizeof(gr_complex) );
+    fwd.execute();
+
+    /* r[d] = sum x0[n + d] * conj(xi[n]) */
+    volk_32fc_x2_multiply_conjugate_32fc( rev.get_inbuf(), ref.data(),
+                                          fwd.get_outbuf(), len );
+    rev.execute();
+    volk_32fc_magnitude_squared_32f( mag.data(), rev.get_outbuf(), len );
+
+    size_t peak = std::max_element( mag.begin(), mag.end() ) - mag.begin();
+
+    double mean = 0;
+    for ( float m : mag )
+      mean += std::sqrt( m );
+    mean /= len;
+
+    double top = std::sqrt( mag[peak] );
+    if ( !( top > ALIGN_MIN_PEAK * mean ) ) {
+      std::cerr << "align: no clear correlation peak on channel " << chan
+                << " (" << top / mean << "), keeping the previous offsets"
+                << std::endl;
+      return false;
+    }
+
+    /* parabola through the peak and its neighbours */
+    double m0 = top;
+    double m1 = std::sqrt( mag[ ( peak + len - 1 ) % len ] );
+    double p1 = std::sqrt( mag[ ( peak + 1 ) % len ] );
+    double denom = m1 - 2 * m0 + p1;
+    double delta = denom != 0 ? 0.5 * ( m1 - p1 ) / denom : 0;
+
+    double lag = peak < _cal_len ? double( peak ) : double( peak ) - len;
+
+    /* the windows may have been taken at different input offsets */
+    offsets[chan] = lag + delta + double( _cal_pos[0] ) - double( _cal_pos[chan] );
+  }
+
+  std::lock_guard< std::mutex > lock( _lock );
+  _offsets = offsets;
+
+  return true;
+}
+
+/* called with the read position of every input at pos[chan] */
+void align_cc::apply( const std::vector< double > &pos )
+{
+  std::vector< double > offsets = this->offsets();
+
+  /* x_i[pos_i + skip_i + mu_i] has to be the same instant on every channel */
+  double target = 0;
+  for ( size_t chan = 0; chan < _nchan; chan++ )
+    target = std::max( target, pos[chan] + offsets[chan] );
+  target = std::ceil( target );
+
+  for ( size_t chan = 0; chan < _nchan; chan++ ) {
+    double ahead = target - pos[chan] - offsets[chan];
+    double skip = std::floor( ahead );
+    double mu = ahead - skip;
+
+    if ( mu > 1.0 - ALIGN_MIN_FRAC ) {
+      skip += 1;
+      mu = 0;
+    }
+
+    _skip[chan] = uint64_t( skip );
+    design( chan, mu );
+  }
+
+  _tag = true;
+}
+
+int align_cc::general_work( int noutput_items,
+                            gr_vector_int &ninput_items,
+                            gr_vector_const_void_star &input_items,
+                            gr_vector_void_star &output_items )
+{
+  /* leading channels drop their head start while the others wait */
+  bool skipped = false;
+  for ( size_t chan = 0; chan < _nchan; chan++ ) {
+    if ( !_skip[chan] )
+      continue;
+
+    uint64_t n = std::min( _skip[chan], uint64_t( ninput_items[chan] ) );
+    consume( chan, int( n ) );
+    _skip[chan] -= n;
+    skipped = true;
+  }
+
+  if ( skipped )
+    return 0;
+
+  int nin = ninput_items[0];
+  for ( size_t chan = 1; chan < _nchan; chan++ )
+    nin = std::min( nin, ninput_items[chan] );
+
+  if ( !_collecting && ( !_aligned || ( _period && _since >= _period ) ) ) {
+    _collecting = true;
+    _cal_fill = 0;
+    for ( size_t chan = 0; chan < _nchan; chan++ )
+      _cal_pos[chan] = nitems_read( chan );
+  }
+
+  int n = _aligned ? std::min( nin, noutput_items ) : nin;
+
+  if ( _collecting ) {
+    n = int( std::min( size_t( n ), _cal_len - _cal_fill ) );
+
+    for ( size_t chan = 0; chan < _nchan; chan++ )
+      memcpy( &_cal[chan][ _cal_fill ], input_items[chan], n * sizeof(gr_complex) );
+
+    _cal_fill += n;
+  }
+
+  if ( _aligned ) {
+    const size_t hist = ALIGN_NTAPS - 1;
+
+    for ( size_t chan = 0; chan < _nchan; chan++ ) {
+      const gr_complex *in = (const gr_complex *) input_items[chan];
+      gr_complex *out = (gr_complex *) output_items[chan];
+      std::vector< gr_complex > &h = _hist[chan];
+
+      if ( _frac[chan] ) {
+        _scratch.resize( hist + n );
+        memcpy( _scratch.data(), h.data(), hist * sizeof(gr_complex) );
+        memcpy( _scratch.data() + hist, in, n * sizeof(gr_complex) );
+
+        for ( int i = 0; i < n; i++ )
+          volk_32fc_32f_dot_prod_32fc( out + i, _scratch.data() + i,
+                                       _taps[chan].data(), ALIGN_NTAPS );
+      } else {
+        /* the interpolator at mu = 0 is a plain delay of hist - ALIGN_CENTER */
+        size_t from_hist = std::min( size_t( n ), hist - ALIGN_CENTER );
+        memcpy( out, h.data() + ALIGN_CENTER, from_hist * sizeof(gr_complex) );
+        memcpy( out + from_hist, in, ( n - from_hist ) * sizeof(gr_complex) );
+      }
+
+      /* keep the last hist input samples for the next call */
+      if ( size_t( n ) >= hist ) {
+        memcpy( h.data(), in + n - hist, hist * sizeof(gr_complex) );
+      } else {
+        memmove( h.data(), h.data() + n, ( hist - n ) * sizeof(gr_complex) );
+        memcpy( h.data() + hist - n, in, n * sizeof(gr_complex) );
+      }
+
+      if ( _tag )
+        add_item_tag( chan, nitems_written( chan ), RX_ALIGN_KEY,
+                      pmt::from_double( _offsets[chan] ) );
+    }
+
+    _tag = false;
+    _since += n;
+  }
+
+  consume_each( n );
+
+  int produced = _aligned ? n : 0;
+
+  if ( _collecting && _cal_fill == _cal_len ) {
+    _collecting = false;
+    _since = 0;
+
+    bool first = !_aligned;
+    if ( estimate() || first ) {
+      std::vector< double > pos( _nchan );
+      for ( size_t chan = 0; chan < _nchan; chan++ )
+        pos[chan] = double( nitems_read( chan ) + n );
+      apply( pos );
+    }
+
+    _aligned = true;
+  }
+
+  return produced;
+}
@@ -0,0 +1,98 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_ALIGN_CC_H
+#define INCLUDED_ALIGN_CC_H
+
+#include <gnuradio/block.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+class align_cc;
+
+typedef std::shared_ptr< align_cc > align_cc_sptr;
+
+align_cc_sptr make_align_cc( size_t nchan, size_t cal_len, uint64_t period );
+
+/*!
+ * Sample alignment of the channels of a multi-device source, enabled with
+ * the align=xcorr argument.
+ *
+ * A window of cal_len samples is taken from every channel and cross
+ * correlated against channel 0 through FFTs. The correlation peak gives
+ * the integer offset, a parabolic fit around it the fractional part. The
+ * integer part is removed by dropping samples from the leading channels.
+ * The fractional part goes through a short windowed sinc interpolator.
+ * Every channel passes through the same filter, so the delay it adds is
+ * common to all of them.
+ *
+ * Nothing is output before the first estimate. With a non-zero period,
+ * measured in samples, the estimate is repeated on the passing stream. New
+ * offsets are tagged as rx_align on every output.
+ */
+class align_cc : public gr::block
+{
+private:
+  friend align_cc_sptr make_align_cc( size_t nchan, size_t cal_len, uint64_t period );
+
+  align_cc( size_t nchan, size_t cal_len, uint64_t period );
+
+public:
+  int general_work( int noutput_items,
+                    gr_vector_int &ninput_items,
+                    gr_vector_const_void_star &input_items,
+                    gr_vector_void_star &output_items );
+
+  /* last measured offset of each channel against channel 0, in samples */
+  std::vector< double > offsets();
+
+  void set_period( uint64_t period );
+
+private:
+  bool estimate();
+  void apply( const std::vector< double > &pos );
+  void design( size_t chan, double mu );
+
+  size_t _nchan;
+  size_t _cal_len;
+  std::atomic< uint64_t > _period;
+
+  std::mutex _lock;
+  std::vector< double > _offsets;
+
+  bool _aligned;
+  bool _tag;
+  uint64_t _since;             /* samples output since the last estimate */
+
+  /* calibration window, taken at the same time from every channel */
+  std::vector< std::vector< gr_complex > > _cal;
+  std::vector< uint64_t > _cal_pos;
+  size_t _cal_fill;
+  bool _collecting;
+
+  std::vector< uint64_t > _skip;
+  std::vector< bool > _frac;   /* channel needs the interpolator */
+  std::vector< std::vector< float > > _taps;
+  std::vector< std::vector< gr_complex > > _hist;
+  std::vector< gr_complex > _scratch;
+};
+
+#endif /* INCLUDED_ALIGN_CC_H */
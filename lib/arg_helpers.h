@@ -109,18 +109,61 @@ inline dict_t params_to_dict( const std::string &params )
   return result;
 }
 
-struct is_nchan_argument
+/* tokens applying to the whole block rather than to one device, told apart
+ * by their first key as a device token may carry some of them as well */
+struct is_global_argument
 {
   bool operator ()(const std::string &str)
   {
-    return str.find("numchan=") == 0;
+    std::vector< std::string > params = params_to_vector(str);
+    if (params.empty())
+      return false;
+
+    std::string key = param_to_pair(params.front()).first;
+
+    return key == "numchan" || key == "align" || key == "resample" ||
+           key == "ddc" || key == "item_type" || key == "open_threads" ||
+           key == "iq_corr";
   }
 };
 
+/* the stream item type given by item_type=, complex float by default */
+inline std::string args_to_item_type( const std::string &args )
+{
+  std::string type = "fc32";
+
+  for (std::string arg : args_to_vector( args ))
+  {
+    dict_t dict = params_to_dict( arg );
+    if ( dict.count( "item_type" ) )
+      type = dict["item_type"];
+  }
+
+  return type;
+}
+
+inline size_t item_type_size( const std::string &type )
+{
+  if ( type == "fc32" )
+    return sizeof(gr_complex);
+  if ( type == "sc16" )
+    return 2 * sizeof(int16_t);
+  if ( type == "sc8" )
+    return 2 * sizeof(int8_t);
+
+  throw std::runtime_error("Unsupported item_type '" + type + "', use fc32, sc16 or sc8.");
+}
+
+inline size_t args_to_item_size( const std::string &args )
+{
+  return item_type_size( args_to_item_type( args ) );
+}
+
 inline gr::io_signature::sptr args_to_io_signature( const std::string &args )
 {
   size_t max_nchan = 0;
   size_t dev_nchan = 0;
+  size_t ddc_nchan = 0;
   std::vector< std::string > arg_list = args_to_vector( args );
 
   for (std::string arg : arg_list)
@@ -130,12 +173,16 @@ inline gr::io_signature::sptr args_to_io_signature( const std::string &args )
       pair_t pair = param_to_pair( arg );
       max_nchan = boost::lexical_cast<size_t>( pair.second );
     }
+
+    dict_t dict = params_to_dict( arg );
+    if ( dict.count( "ddc" ) ) // narrowband channels follow the device ones
+      ddc_nchan = boost::lexical_cast<size_t>( dict["ddc"] );
   }
 
-  arg_list.erase( std::remove_if( // remove any global nchan tokens
+  arg_list.erase( std::remove_if( // remove any global tokens
                     arg_list.begin(),
                     arg_list.end(),
-                    is_nchan_argument() ),
+                    is_global_argument() ),
                   arg_list.end() );
 
   // try to parse device specific nchan values, assume 1 channel if none given
@@ -157,8 +204,8 @@ inline gr::io_signature::sptr args_to_io_signature( const std::string &args )
   if ( max_nchan && dev_nchan && max_nchan != dev_nchan )
     throw std::runtime_error("Wrong device arguments specified. Missing nchan?");
 
-  const size_t nchan = std::max<size_t>(dev_nchan, 1); // assume at least one
-  return gr::io_signature::make(nchan, nchan, sizeof(gr_complex));
+  const size_t nchan = std::max<size_t>(dev_nchan, 1) + ddc_nchan; // assume at least one
+  return gr::io_signature::make(nchan, nchan, args_to_item_size(args));
 }
 
 #endif // OSMOSDR_ARG_HELPERS_H
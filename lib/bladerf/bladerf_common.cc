@@ -39,6 +39,7 @@
 #include <boost/lexical_cast.hpp>
 
 #include "bladerf_common.h"
+#include "pool_helpers.h"
 
 /* Defaults for these values. */
 static size_t const NUM_BUFFERS = 512;
@@ -140,6 +141,7 @@ bladerf_common::bladerf_common() :
   _samples_per_buffer(NUM_SAMPLES_PER_BUFFER),
   _num_transfers(NUM_TRANSFERS),
   _stream_timeout(STREAM_TIMEOUT_MS),
+  _numa_node(-1),
   _format(BLADERF_FORMAT_SC16_Q11)
 {
 }
@@ -313,6 +315,8 @@ void bladerf_common::init(dict_t const &dict, bladerf_direction direction)
     _stream_timeout = boost::lexical_cast<unsigned int>(_get(dict, "stream_timeout_ms"));
   }
 
+  _numa_node = args_to_numa_node(dict);
+
   if (dict.count("enable_metadata") > 0) {
     _format = BLADERF_FORMAT_SC16_Q11_META;
   }
@@ -251,6 +251,7 @@ protected:
   size_t _samples_per_buffer;   /**< how many samples per buffer */
   size_t _num_transfers;        /**< number of active backend transfers */
   unsigned int _stream_timeout; /**< timeout for backend transfers */
+  int _numa_node;               /**< of the conversion buffers, -1 for any */
 
   bladerf_format _format;       /**< sample format to use */
 
@@ -39,6 +39,8 @@
 #include <volk/volk.h>
 
 #include "arg_helpers.h"
+#include "convert_helpers.h"
+#include "pool_helpers.h"
 #include "bladerf_sink_c.h"
 #include "osmosdr/sink.h"
 
@@ -65,9 +67,10 @@ bladerf_sink_c_sptr make_bladerf_sink_c(const std::string &args)
  * The private constructor
  */
 bladerf_sink_c::bladerf_sink_c(const std::string &args) :
-  gr::sync_block( "bladerf_sink_c",
+  direct_block( "bladerf_sink_c",
                   args_to_io_signature(args),
                   gr::io_signature::make(0, 0, 0)),
+  _item_size(args_to_item_size(args)),
   _16icbuf(NULL),
   _32fcbuf(NULL),
   _in_burst(false),
@@ -109,11 +112,11 @@ bladerf_sink_c::bladerf_sink_c(const std::string &args) :
 
     set_input_signature(gr::io_signature::make(get_max_channels(),
                                                get_max_channels(),
-                                               sizeof(gr_complex)));
+                                               _item_size));
   }
 
   /* Set up constraints */
-  int const alignment_multiple = volk_get_alignment() / sizeof(gr_complex);
+  int const alignment_multiple = volk_get_alignment() / _item_size;
   set_alignment(std::max(1,alignment_multiple));
   set_max_noutput_items(_samples_per_buffer);
   set_output_multiple(get_num_channels());
@@ -181,10 +184,17 @@ bool bladerf_sink_c::start()
   }
 
   /* Allocate memory for conversions in work() */
-  size_t alignment = volk_get_alignment();
-
-  _16icbuf = reinterpret_cast<int16_t *>(volk_malloc(2*_samples_per_buffer*sizeof(int16_t), alignment));
-  _32fcbuf = reinterpret_cast<gr_complex *>(volk_malloc(_samples_per_buffer*sizeof(gr_complex), alignment));
+  buffer_pool &pool = buffer_pool::get();
+
+  _16icbuf = reinterpret_cast<int16_t *>(pool.alloc(2*_samples_per_buffer*sizeof(int16_t), _numa_node));
+  _32fcbuf = reinterpret_cast<gr_complex *>(pool.alloc(_samples_per_buffer*sizeof(gr_complex), _numa_node));
+  if (_16icbuf == NULL || _32fcbuf == NULL) {
+    pool.release(_16icbuf);
+    pool.release(_32fcbuf);
+    _16icbuf = NULL;
+    _32fcbuf = NULL;
+    BLADERF_THROW("failed to allocate conversion buffers");
+  }
 
   _running = true;
 
@@ -215,8 +225,8 @@ bool bladerf_sink_c::stop()
   }
 
   /* Deallocate conversion memory */
-  volk_free(_16icbuf);
-  volk_free(_32fcbuf);
+  buffer_pool::get().release(_16icbuf);
+  buffer_pool::get().release(_32fcbuf);
   _16icbuf = NULL;
   _32fcbuf = NULL;
 
@@ -237,27 +247,37 @@ int bladerf_sink_c::work(int noutput_items,
     return 0;
   }
 
-  // copy the samples from input_items
-  gr_complex const **in = reinterpret_cast<gr_complex const **>(&input_items[0]);
+  // a single stream gets converted straight from input_items
+  uint8_t const *intl = reinterpret_cast<uint8_t const *>(input_items[0]);
 
   if (nstreams > 1) {
     // we need to interleave the streams as we copy
-    gr_complex *intl_out = _32fcbuf;
+    uint8_t const **in = reinterpret_cast<uint8_t const **>(&input_items[0]);
+    uint8_t *intl_out = reinterpret_cast<uint8_t *>(_32fcbuf);
 
     for (size_t i = 0; i < (noutput_items/nstreams); ++i) {
       for (size_t n = 0; n < nstreams; ++n) {
-        memcpy(intl_out++, in[n]++, sizeof(gr_complex));
+        memcpy(intl_out, in[n], _item_size);
+        intl_out += _item_size;
+        in[n] += _item_size;
       }
     }
-  } else {
-    // no interleaving to do: simply copy everything
-    memcpy(_32fcbuf, in[0], noutput_items * sizeof(gr_complex));
+
+    intl = reinterpret_cast<uint8_t const *>(_32fcbuf);
   }
 
-  // convert floating point to fixed point and scale
-  // input_items is gr_complex (2x float), so num_points is 2*noutput_items
-  volk_32f_s32f_convert_16i(_16icbuf, reinterpret_cast<float const *>(_32fcbuf),
-                            SCALING_FACTOR, 2*noutput_items);
+  // convert to SC16_Q11, 2 values per sample
+  if (_item_size == sizeof(gr_complex)) {
+    volk_32f_s32f_convert_16i(_16icbuf, reinterpret_cast<float const *>(intl),
+                              SCALING_FACTOR, 2*noutput_items);
+  } else if (_item_size == 2 * sizeof(int16_t)) {
+    // the top 12 bits of the int16 range
+    convert_16i_shr(reinterpret_cast<int16_t const *>(intl), _16icbuf,
+                    2*noutput_items, 4);
+  } else {
+    convert_8i_to_16i(reinterpret_cast<int8_t const *>(intl), _16icbuf,
+                      2*noutput_items, 4);
+  }
 
   // transmit the samples from the temp buffer
   if (BLADERF_FORMAT_SC16_Q11_META == _format) {
@@ -568,6 +588,37 @@ double bladerf_sink_c::get_bandwidth(size_t chan)
   return bladerf_common::get_bandwidth(chan2channel(BLADERF_TX, chan));
 }
 
+void bladerf_sink_c::configure(const channel_config &config, size_t chan)
+{
+  /* a new antenna restarts the stream, apply everything else meanwhile */
+  bool _was_running = _running && config.has_antenna;
+
+  if (_was_running) {
+    stop();
+  }
+
+  channel_config rest = config;
+
+  try {
+    if (config.has_antenna) {
+      bladerf_common::set_antenna(BLADERF_TX, chan, config.antenna);
+      rest.has_antenna = false;
+    }
+
+    apply_channel_config(*this, rest, chan);
+  } catch (...) {
+    /* a failed setting must not leave the stream stopped */
+    if (_was_running) {
+      start();
+    }
+    throw;
+  }
+
+  if (_was_running) {
+    start();
+  }
+}
+
 std::vector < std::string > bladerf_sink_c::get_clock_sources(size_t mboard)
 {
   return bladerf_common::get_clock_sources(mboard);
@@ -23,6 +23,7 @@
 
 #include <gnuradio/sync_block.h>
 #include "sink_iface.h"
+#include "direct_block.h"
 #include "bladerf_common.h"
 
 #include "osmosdr/ranges.h"
@@ -52,7 +53,7 @@ typedef std::shared_ptr<bladerf_sink_c> bladerf_sink_c_sptr;
 bladerf_sink_c_sptr make_bladerf_sink_c(const std::string &args = "");
 
 class bladerf_sink_c :
-  public gr::sync_block,
+  public direct_block,
   public sink_iface,
   protected bladerf_common
 {
@@ -113,6 +114,8 @@ public:
   double set_bandwidth(double bandwidth, size_t chan = 0);
   double get_bandwidth(size_t chan = 0);
 
+  void configure(const channel_config &config, size_t chan = 0);
+
   std::vector<std::string> get_clock_sources(size_t mboard);
   void set_clock_source(const std::string &source, size_t mboard = 0);
   std::string get_clock_source(size_t mboard);
@@ -123,6 +126,7 @@ private:
   int transmit_with_tags(int16_t const *samples, int noutput_items);
 
   // Sample-handling buffers
+  size_t _item_size;              /**< of complex float, int16 or int8 */
   int16_t *_16icbuf;              /**< raw samples to bladeRF */
   gr_complex *_32fcbuf;           /**< intermediate buffer for conversions */
 
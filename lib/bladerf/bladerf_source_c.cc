@@ -39,6 +39,8 @@
 #include <volk/volk.h>
 
 #include "arg_helpers.h"
+#include "convert_helpers.h"
+#include "pool_helpers.h"
 #include "bladerf_source_c.h"
 #include "osmosdr/source.h"
 
@@ -65,9 +67,10 @@ bladerf_source_c_sptr make_bladerf_source_c(const std::string &args)
  * The private constructor
  */
 bladerf_source_c::bladerf_source_c(const std::string &args) :
-  gr::sync_block( "bladerf_source_c",
-                  gr::io_signature::make(0, 0, 0),
-                  args_to_io_signature(args)),
+  direct_block( "bladerf_source_c",
+                gr::io_signature::make(0, 0, 0),
+                args_to_io_signature(args)),
+  _item_size(args_to_item_size(args)),
   _16icbuf(NULL),
   _32fcbuf(NULL),
   _running(false),
@@ -80,6 +83,9 @@ bladerf_source_c::bladerf_source_c(const std::string &args) :
   /* Perform src/sink agnostic initializations */
   init(dict, BLADERF_RX);
 
+  /* Conversion in work() on convert_threads threads */
+  _workers.reset(new chunk_workers(args_to_convert_threads(dict)));
+
   /* Handle setting of sampling mode */
   if (dict.count("sampling")) {
     bladerf_sampling sampling = BLADERF_SAMPLING_UNKNOWN;
@@ -166,11 +172,11 @@ bladerf_source_c::bladerf_source_c(const std::string &args) :
 
     set_output_signature(gr::io_signature::make(get_max_channels(),
                                                 get_max_channels(),
-                                                sizeof(gr_complex)));
+                                                _item_size));
   }
 
   /* Set up constraints */
-  int const alignment_multiple = volk_get_alignment() / sizeof(gr_complex);
+  int const alignment_multiple = volk_get_alignment() / _item_size;
   set_alignment(std::max(1,alignment_multiple));
   set_max_noutput_items(_samples_per_buffer);
   set_output_multiple(get_num_channels());
@@ -246,10 +252,17 @@ bool bladerf_source_c::start()
   }
 
   /* Allocate memory for conversions in work() */
-  size_t alignment = volk_get_alignment();
+  buffer_pool &pool = buffer_pool::get();
 
-  _16icbuf = reinterpret_cast<int16_t *>(volk_malloc(2*_samples_per_buffer*sizeof(int16_t), alignment));
-  _32fcbuf = reinterpret_cast<gr_complex *>(volk_malloc(_samples_per_buffer*sizeof(gr_complex), alignment));
+  _16icbuf = reinterpret_cast<int16_t *>(pool.alloc(2*_samples_per_buffer*sizeof(int16_t), _numa_node));
+  _32fcbuf = reinterpret_cast<gr_complex *>(pool.alloc(_samples_per_buffer*sizeof(gr_complex), _numa_node));
+  if (_16icbuf == NULL || _32fcbuf == NULL) {
+    pool.release(_16icbuf);
+    pool.release(_32fcbuf);
+    _16icbuf = NULL;
+    _32fcbuf = NULL;
+    BLADERF_THROW("failed to allocate conversion buffers");
+  }
 
   _running = true;
 
@@ -282,8 +295,8 @@ bool bladerf_source_c::stop()
   }
 
   /* Deallocate conversion memory */
-  volk_free(_16icbuf);
-  volk_free(_32fcbuf);
+  buffer_pool::get().release(_16icbuf);
+  buffer_pool::get().release(_32fcbuf);
   _16icbuf = NULL;
   _32fcbuf = NULL;
 
@@ -329,27 +342,41 @@ int bladerf_source_c::work(int noutput_items,
     _failures = 0;
   }
 
-  // convert from int16_t to float
-  // output_items is gr_complex (2x float), so num_points is 2*noutput_items
-  volk_16i_s32f_convert_32f(reinterpret_cast<float *>(_32fcbuf), _16icbuf,
-                            SCALING_FACTOR, 2*noutput_items);
+  uint8_t **out = reinterpret_cast<uint8_t **>(&output_items[0]);
+
+  // a single stream is converted straight into output_items
+  uint8_t *conv = (nstreams > 1) ? reinterpret_cast<uint8_t *>(_32fcbuf) : out[0];
+
+  // chunks of whole multiplex frames, on convert_threads threads
+  size_t chunk = std::max(CONVERT_CHUNK / nstreams, size_t(1)) * nstreams;
 
-  // copy the samples into output_items
-  gr_complex **out = reinterpret_cast<gr_complex **>(&output_items[0]);
+  _workers->run(noutput_items, chunk, [&](size_t begin, size_t end) {
+    int16_t const *in = _16icbuf + 2*begin;
+    uint8_t *dst = conv + _item_size*begin;
+
+    // convert from SC16_Q11 to the output items, 2 values per sample
+    if (_item_size == sizeof(gr_complex)) {
+      volk_16i_s32f_convert_32f(reinterpret_cast<float *>(dst), in,
+                                SCALING_FACTOR, 2*(end - begin));
+    } else if (_item_size == 2 * sizeof(int16_t)) {
+      // 12 bits to the top of the int16 range
+      convert_16i_shl(in, reinterpret_cast<int16_t *>(dst), 2*(end - begin), 4);
+    } else {
+      convert_16i_to_8i(in, reinterpret_cast<int8_t *>(dst), 2*(end - begin), 4);
+    }
 
-  if (nstreams > 1) {
-    // we need to deinterleave the multiplex as we copy
-    gr_complex const *deint_in = _32fcbuf;
+    if (nstreams > 1) {
+      // we need to deinterleave the multiplex as we copy
+      uint8_t const *deint_in = dst;
 
-    for (size_t i = 0; i < (noutput_items/nstreams); ++i) {
-      for (size_t n = 0; n < nstreams; ++n) {
-        memcpy(out[n]++, deint_in++, sizeof(gr_complex));
+      for (size_t i = begin/nstreams; i < end/nstreams; ++i) {
+        for (size_t n = 0; n < nstreams; ++n) {
+          memcpy(out[n] + _item_size*i, deint_in, _item_size);
+          deint_in += _item_size;
+        }
       }
     }
-  } else {
-    // no deinterleaving to do: simply copy everything
-    memcpy(out[0], _32fcbuf, sizeof(gr_complex) * noutput_items);
-  }
+  });
 
   return noutput_items/(get_num_channels());
 }
@@ -544,6 +571,37 @@ double bladerf_source_c::get_bandwidth(size_t chan)
   return bladerf_common::get_bandwidth(chan2channel(BLADERF_RX, chan));
 }
 
+void bladerf_source_c::configure(const channel_config &config, size_t chan)
+{
+  /* a new antenna restarts the stream, apply everything else meanwhile */
+  bool _was_running = _running && config.has_antenna;
+
+  if (_was_running) {
+    stop();
+  }
+
+  channel_config rest = config;
+
+  try {
+    if (config.has_antenna) {
+      bladerf_common::set_antenna(BLADERF_RX, chan, config.antenna);
+      rest.has_antenna = false;
+    }
+
+    apply_channel_config(*this, rest, chan);
+  } catch (...) {
+    /* a failed setting must not leave the stream stopped */
+    if (_was_running) {
+      start();
+    }
+    throw;
+  }
+
+  if (_was_running) {
+    start();
+  }
+}
+
 std::vector<std::string> bladerf_source_c::get_clock_sources(size_t mboard)
 {
   return bladerf_common::get_clock_sources(mboard);
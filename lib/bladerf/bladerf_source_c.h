@@ -23,7 +23,9 @@
 
 #include <gnuradio/sync_block.h>
 #include "source_iface.h"
+#include "direct_block.h"
 #include "bladerf_common.h"
+#include "worker_helpers.h"
 
 #include "osmosdr/ranges.h"
 
@@ -52,7 +54,7 @@ typedef std::shared_ptr<bladerf_source_c> bladerf_source_c_sptr;
 bladerf_source_c_sptr make_bladerf_source_c(const std::string &args = "");
 
 class bladerf_source_c :
-  public gr::sync_block,
+  public direct_block,
   public source_iface,
   protected bladerf_common
 {
@@ -107,15 +109,19 @@ public:
   std::string get_antenna(size_t chan = 0);
 
   void set_dc_offset_mode(int mode, size_t chan = 0);
+  bool has_dc_offset_mode(size_t chan = 0) { return true; }
   void set_dc_offset(const std::complex<double> &offset, size_t chan = 0);
 
   void set_iq_balance_mode(int mode, size_t chan = 0);
+  bool has_iq_balance_mode(size_t chan = 0) { return true; }
   void set_iq_balance(const std::complex<double> &balance, size_t chan = 0);
 
   osmosdr::freq_range_t get_bandwidth_range(size_t chan = 0);
   double set_bandwidth(double bandwidth, size_t chan = 0);
   double get_bandwidth(size_t chan = 0);
 
+  void configure(const channel_config &config, size_t chan = 0);
+
   std::vector<std::string> get_clock_sources(size_t mboard);
   void set_clock_source(const std::string &source, size_t mboard = 0);
   std::string get_clock_source(size_t mboard);
@@ -128,8 +134,10 @@ public:
 
 private:
   // Sample-handling buffers
+  size_t _item_size;              /**< of complex float, int16 or int8 */
   int16_t *_16icbuf;              /**< raw samples from bladeRF */
   gr_complex *_32fcbuf;           /**< intermediate buffer to gnuradio */
+  std::unique_ptr<chunk_workers> _workers; /**< of the conversion */
 
   bool _running;                  /**< is the source running? */
   bladerf_channel_layout _layout; /**< channel layout */
@@ -0,0 +1,186 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef OSMOSDR_CONFIG_HELPERS_H
+#define OSMOSDR_CONFIG_HELPERS_H
+
+#include <stddef.h>
+
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+
+/*
+ * The settings of one channel handed to configure() in one go, each with a
+ * flag telling it was given. The rate is the same for all channels of a
+ * device, named gains are kept as the stage name to dB.
+ */
+struct channel_config
+{
+  channel_config()
+    : has_rate( false ), rate( 0 ),
+      has_freq( false ), freq( 0 ),
+      has_corr( false ), corr( 0 ),
+      has_bandwidth( false ), bandwidth( 0 ),
+      has_gain_mode( false ), gain_mode( false ),
+      has_gain( false ), gain( 0 ),
+      has_if_gain( false ), if_gain( 0 ),
+      has_bb_gain( false ), bb_gain( 0 ),
+      has_antenna( false )
+  {
+  }
+
+  bool has_rate;
+  double rate;
+  bool has_freq;
+  double freq;
+  bool has_corr;
+  double corr;
+  bool has_bandwidth;
+  double bandwidth;
+  bool has_gain_mode;
+  bool gain_mode;             /* true for automatic */
+  bool has_gain;
+  double gain;
+  bool has_if_gain;
+  double if_gain;
+  bool has_bb_gain;
+  double bb_gain;
+  std::map< std::string, double > gains;
+  bool has_antenna;
+  std::string antenna;
+};
+
+inline double config_to_double( const std::string &key, const std::string &value )
+{
+  try {
+    return boost::lexical_cast< double >( value );
+  } catch ( const boost::bad_lexical_cast & ) {
+    throw std::runtime_error( "configure: bad value for " + key + ": " + value );
+  }
+}
+
+inline bool config_to_gain_mode( const std::string &value )
+{
+  std::string mode = boost::algorithm::to_lower_copy( value );
+
+  if ( mode == "auto" || mode == "automatic" || mode == "true" || mode == "1" )
+    return true;
+  if ( mode == "manual" || mode == "false" || mode == "0" )
+    return false;
+
+  throw std::runtime_error( "configure: bad value for gain_mode: " + value );
+}
+
+/*
+ * The settings of a configure() call: rate, freq, corr, bw, gain_mode
+ * (auto or manual), gain, if_gain, bb_gain, gain:NAME for the stage of
+ * that name and antenna. Throws on keys it does not know, so that a typo
+ * does not go unnoticed.
+ */
+inline channel_config dict_to_channel_config( const std::map< std::string, std::string > &settings )
+{
+  channel_config config;
+
+  for ( const auto &setting : settings ) {
+    const std::string &key = setting.first;
+    const std::string &value = setting.second;
+
+    if ( key == "rate" ) {
+      config.has_rate = true;
+      config.rate = config_to_double( key, value );
+    } else if ( key == "freq" ) {
+      config.has_freq = true;
+      config.freq = config_to_double( key, value );
+    } else if ( key == "corr" ) {
+      config.has_corr = true;
+      config.corr = config_to_double( key, value );
+    } else if ( key == "bw" ) {
+      config.has_bandwidth = true;
+      config.bandwidth = config_to_double( key, value );
+    } else if ( key == "gain_mode" ) {
+      config.has_gain_mode = true;
+      config.gain_mode = config_to_gain_mode( value );
+    } else if ( key == "gain" ) {
+      config.has_gain = true;
+      config.gain = config_to_double( key, value );
+    } else if ( key == "if_gain" ) {
+      config.has_if_gain = true;
+      config.if_gain = config_to_double( key, value );
+    } else if ( key == "bb_gain" ) {
+      config.has_bb_gain = true;
+      config.bb_gain = config_to_double( key, value );
+    } else if ( key.compare( 0, 5, "gain:" ) == 0 && key.size() > 5 ) {
+      config.gains[ key.substr( 5 ) ] = config_to_double( key, value );
+    } else if ( key == "antenna" ) {
+      config.has_antenna = true;
+      config.antenna = value;
+    } else {
+      throw std::runtime_error( "configure: unknown setting " + key );
+    }
+  }
+
+  return config;
+}
+
+/*
+ * Applies the settings through the single setters of a source or sink, in
+ * the order that is the least work for most hardware: the antenna, then the
+ * rate before the filters chosen for it, the frequency and the gains last,
+ * after the gain mode.
+ */
+template< typename iface_t >
+void apply_channel_config( iface_t &dev, const channel_config &config, size_t chan )
+{
+  if ( config.has_antenna )
+    dev.set_antenna( config.antenna, chan );
+
+  if ( config.has_rate )
+    dev.set_sample_rate( config.rate );
+
+  if ( config.has_bandwidth )
+    dev.set_bandwidth( config.bandwidth, chan );
+
+  if ( config.has_freq )
+    dev.set_center_freq( config.freq, chan );
+
+  if ( config.has_corr )
+    dev.set_freq_corr( config.corr, chan );
+
+  if ( config.has_gain_mode )
+    dev.set_gain_mode( config.gain_mode, chan );
+
+  if ( config.has_gain )
+    dev.set_gain( config.gain, chan );
+
+  if ( config.has_if_gain )
+    dev.set_if_gain( config.if_gain, chan );
+
+  if ( config.has_bb_gain )
+    dev.set_bb_gain( config.bb_gain, chan );
+
+  for ( const auto &gain : config.gains )
+    dev.set_gain( gain.second, gain.first, chan );
+}
+
+#endif // OSMOSDR_CONFIG_HELPERS_H
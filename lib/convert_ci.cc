@@ -0,0 +1,55 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+
+#include "convert_ci.h"
+#include "convert_helpers.h"
+
+convert_ci_sptr make_convert_ci( size_t item_size )
+{
+  return gnuradio::get_initial_sptr( new convert_ci( item_size ) );
+}
+
+convert_ci::convert_ci( size_t item_size )
+  : gr::sync_block( "convert_ci",
+                    gr::io_signature::make( 1, 1, sizeof(gr_complex) ),
+                    gr::io_signature::make( 1, 1, item_size ) ),
+    _item_size( item_size )
+{
+}
+
+int convert_ci::work( int noutput_items,
+                      gr_vector_const_void_star &input_items,
+                      gr_vector_void_star &output_items )
+{
+  const float *in = (const float *) input_items[0];
+
+  if ( _item_size == 2 * sizeof(int16_t) )
+    convert_32f_to_16i( in, (int16_t *) output_items[0], 2 * noutput_items, 32767.0f );
+  else
+    convert_32f_to_8i( in, (int8_t *) output_items[0], 2 * noutput_items, 127.0f );
+
+  return noutput_items;
+}
@@ -0,0 +1,52 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_CONVERT_CI_H
+#define INCLUDED_CONVERT_CI_H
+
+#include <gnuradio/sync_block.h>
+
+class convert_ci;
+
+typedef std::shared_ptr< convert_ci > convert_ci_sptr;
+
+convert_ci_sptr make_convert_ci( size_t item_size );
+
+/*!
+ * Complex float to complex int16 or int8 at full scale, saturating. The
+ * source puts it behind the backends which only deliver complex float when
+ * an integer item_type was asked for.
+ */
+class convert_ci : public gr::sync_block
+{
+private:
+  friend convert_ci_sptr make_convert_ci( size_t item_size );
+
+  convert_ci( size_t item_size );
+
+public:
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+private:
+  size_t _item_size;
+};
+
+#endif /* INCLUDED_CONVERT_CI_H */
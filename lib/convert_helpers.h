@@ -0,0 +1,292 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef OSMOSDR_CONVERT_HELPERS_H
+#define OSMOSDR_CONVERT_HELPERS_H
+
+/*
+ * Sample format conversion kernels shared by the backends.
+ *
+ * All counts are given in scalar values (2 per complex sample). The SSE2
+ * and AVX variants are selected at compile time through the USE_SIMD cmake
+ * option, the scalar loops handle the remainder and non-x86 targets.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <cmath>
+
+#ifdef USE_AVX
+#include <immintrin.h>
+#elif USE_SSE2
+#include <emmintrin.h>
+#endif
+
+inline int16_t convert_clip_16i( float v )
+{
+  if ( v > 32767.0f ) return 32767;
+  if ( v < -32768.0f ) return -32768;
+  return (int16_t) lrintf( v );
+}
+
+inline int8_t convert_clip_8i( float v )
+{
+  if ( v > 127.0f ) return 127;
+  if ( v < -128.0f ) return -128;
+  return (int8_t) lrintf( v );
+}
+
+/* float -> int16, saturating */
+inline void convert_32f_to_16i( const float *in, int16_t *out,
+                                size_t count, float scale )
+{
+  size_t i = 0;
+#ifdef USE_AVX
+  const __m256 mul = _mm256_set1_ps( scale );
+  const __m256 top = _mm256_set1_ps( 32767.0f ), bot = _mm256_set1_ps( -32768.0f );
+  for ( ; i + 16 <= count; i += 16 ) {
+    /* clamp first, out of range values would convert to INT_MIN */
+    __m256 fa = _mm256_mul_ps( _mm256_loadu_ps( in + i + 0 ), mul );
+    __m256 fb = _mm256_mul_ps( _mm256_loadu_ps( in + i + 8 ), mul );
+    __m256i a = _mm256_cvtps_epi32( _mm256_max_ps( _mm256_min_ps( fa, top ), bot ) );
+    __m256i b = _mm256_cvtps_epi32( _mm256_max_ps( _mm256_min_ps( fb, top ), bot ) );
+    __m128i lo = _mm_packs_epi32( _mm256_castsi256_si128( a ), _mm256_extractf128_si256( a, 1 ) );
+    __m128i hi = _mm_packs_epi32( _mm256_castsi256_si128( b ), _mm256_extractf128_si256( b, 1 ) );
+    _mm_storeu_si128( (__m128i *)(out + i + 0), lo );
+    _mm_storeu_si128( (__m128i *)(out + i + 8), hi );
+  }
+#elif USE_SSE2
+  const __m128 mul = _mm_set1_ps( scale );
+  const __m128 top = _mm_set1_ps( 32767.0f ), bot = _mm_set1_ps( -32768.0f );
+  for ( ; i + 8 <= count; i += 8 ) {
+    /* clamp first, out of range values would convert to INT_MIN */
+    __m128 fa = _mm_mul_ps( _mm_loadu_ps( in + i + 0 ), mul );
+    __m128 fb = _mm_mul_ps( _mm_loadu_ps( in + i + 4 ), mul );
+    __m128i a = _mm_cvtps_epi32( _mm_max_ps( _mm_min_ps( fa, top ), bot ) );
+    __m128i b = _mm_cvtps_epi32( _mm_max_ps( _mm_min_ps( fb, top ), bot ) );
+    _mm_storeu_si128( (__m128i *)(out + i), _mm_packs_epi32( a, b ) );
+  }
+#endif
+  for ( ; i < count; i++ )
+    out[i] = convert_clip_16i( in[i] * scale );
+}
+
+/* float -> int8, saturating */
+inline void convert_32f_to_8i( const float *in, int8_t *out,
+                               size_t count, float scale )
+{
+  size_t i = 0;
+#if defined(USE_AVX) || defined(USE_SSE2)
+  const __m128 mul = _mm_set1_ps( scale );
+  const __m128 top = _mm_set1_ps( 127.0f ), bot = _mm_set1_ps( -128.0f );
+#define CONVERT_8I_LANE(n) \
+    _mm_cvtps_epi32( _mm_max_ps( _mm_min_ps( _mm_mul_ps( _mm_loadu_ps( in + i + n ), mul ), top ), bot ) )
+  for ( ; i + 16 <= count; i += 16 ) {
+    __m128i a = CONVERT_8I_LANE(0);
+    __m128i b = CONVERT_8I_LANE(4);
+    __m128i c = CONVERT_8I_LANE(8);
+    __m128i d = CONVERT_8I_LANE(12);
+    __m128i bytes = _mm_packs_epi16( _mm_packs_epi32( a, b ), _mm_packs_epi32( c, d ) );
+    _mm_storeu_si128( (__m128i *)(out + i), bytes );
+  }
+#undef CONVERT_8I_LANE
+#endif
+  for ( ; i < count; i++ )
+    out[i] = convert_clip_8i( in[i] * scale );
+}
+
+/* int16 -> float */
+inline void convert_16i_to_32f( const int16_t *in, float *out,
+                                size_t count, float scale )
+{
+  size_t i = 0;
+#if defined(USE_AVX) || defined(USE_SSE2)
+  const __m128 mul = _mm_set1_ps( scale );
+  for ( ; i + 8 <= count; i += 8 ) {
+    __m128i v = _mm_loadu_si128( (const __m128i *)(in + i) );
+    /* sign extend by unpacking into the upper half and shifting back */
+    __m128i lo = _mm_srai_epi32( _mm_unpacklo_epi16( v, v ), 16 );
+    __m128i hi = _mm_srai_epi32( _mm_unpackhi_epi16( v, v ), 16 );
+    _mm_storeu_ps( out + i + 0, _mm_mul_ps( _mm_cvtepi32_ps( lo ), mul ) );
+    _mm_storeu_ps( out + i + 4, _mm_mul_ps( _mm_cvtepi32_ps( hi ), mul ) );
+  }
+#endif
+  for ( ; i < count; i++ )
+    out[i] = float( in[i] ) * scale;
+}
+
+/* int8 -> float */
+inline void convert_8i_to_32f( const int8_t *in, float *out,
+                               size_t count, float scale )
+{
+  size_t i = 0;
+#if defined(USE_AVX) || defined(USE_SSE2)
+  const __m128 mul = _mm_set1_ps( scale );
+  for ( ; i + 16 <= count; i += 16 ) {
+    __m128i v = _mm_loadu_si128( (const __m128i *)(in + i) );
+    __m128i w0 = _mm_unpacklo_epi8( v, v );
+    __m128i w1 = _mm_unpackhi_epi8( v, v );
+    __m128i d0 = _mm_srai_epi32( _mm_unpacklo_epi16( w0, w0 ), 24 );
+    __m128i d1 = _mm_srai_epi32( _mm_unpackhi_epi16( w0, w0 ), 24 );
+    __m128i d2 = _mm_srai_epi32( _mm_unpacklo_epi16( w1, w1 ), 24 );
+    __m128i d3 = _mm_srai_epi32( _mm_unpackhi_epi16( w1, w1 ), 24 );
+    _mm_storeu_ps( out + i + 0, _mm_mul_ps( _mm_cvtepi32_ps( d0 ), mul ) );
+    _mm_storeu_ps( out + i + 4, _mm_mul_ps( _mm_cvtepi32_ps( d1 ), mul ) );
+    _mm_storeu_ps( out + i + 8, _mm_mul_ps( _mm_cvtepi32_ps( d2 ), mul ) );
+    _mm_storeu_ps( out + i + 12, _mm_mul_ps( _mm_cvtepi32_ps( d3 ), mul ) );
+  }
+#endif
+  for ( ; i < count; i++ )
+    out[i] = float( in[i] ) * scale;
+}
+
+/* planar int16 I and Q -> interleaved complex float, count in complex samples */
+inline void convert_16i_planar_to_32fc( const int16_t *in_i, const int16_t *in_q,
+                                        float *out, size_t count, float scale )
+{
+  size_t i = 0;
+#if defined(USE_AVX) || defined(USE_SSE2)
+  const __m128 mul = _mm_set1_ps( scale );
+  for ( ; i + 8 <= count; i += 8 ) {
+    __m128i vi = _mm_loadu_si128( (const __m128i *)(in_i + i) );
+    __m128i vq = _mm_loadu_si128( (const __m128i *)(in_q + i) );
+    __m128i lo = _mm_unpacklo_epi16( vi, vq ); /* i0 q0 i1 q1 ... i3 q3 */
+    __m128i hi = _mm_unpackhi_epi16( vi, vq ); /* i4 q4 ... i7 q7 */
+    __m128i d0 = _mm_srai_epi32( _mm_unpacklo_epi16( lo, lo ), 16 );
+    __m128i d1 = _mm_srai_epi32( _mm_unpackhi_epi16( lo, lo ), 16 );
+    __m128i d2 = _mm_srai_epi32( _mm_unpacklo_epi16( hi, hi ), 16 );
+    __m128i d3 = _mm_srai_epi32( _mm_unpackhi_epi16( hi, hi ), 16 );
+    _mm_storeu_ps( out + 2 * i + 0, _mm_mul_ps( _mm_cvtepi32_ps( d0 ), mul ) );
+    _mm_storeu_ps( out + 2 * i + 4, _mm_mul_ps( _mm_cvtepi32_ps( d1 ), mul ) );
+    _mm_storeu_ps( out + 2 * i + 8, _mm_mul_ps( _mm_cvtepi32_ps( d2 ), mul ) );
+    _mm_storeu_ps( out + 2 * i + 12, _mm_mul_ps( _mm_cvtepi32_ps( d3 ), mul ) );
+  }
+#endif
+  for ( ; i < count; i++ ) {
+    out[2 * i + 0] = float( in_i[i] ) * scale;
+    out[2 * i + 1] = float( in_q[i] ) * scale;
+  }
+}
+
+/* offset binary uint8 -> int8 */
+inline void convert_8u_to_8i( const uint8_t *in, int8_t *out, size_t count )
+{
+  size_t i = 0;
+#if defined(USE_AVX) || defined(USE_SSE2)
+  const __m128i sign = _mm_set1_epi8( (char) 0x80 );
+  for ( ; i + 16 <= count; i += 16 ) {
+    __m128i v = _mm_loadu_si128( (const __m128i *)(in + i) );
+    _mm_storeu_si128( (__m128i *)(out + i), _mm_xor_si128( v, sign ) );
+  }
+#endif
+  for ( ; i < count; i++ )
+    out[i] = (int8_t)( in[i] ^ 0x80 );
+}
+
+/* int8 -> int16 shifted left by up to 8, 8 for full scale */
+inline void convert_8i_to_16i( const int8_t *in, int16_t *out,
+                               size_t count, int shift )
+{
+  size_t i = 0;
+#if defined(USE_AVX) || defined(USE_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i bits = _mm_cvtsi32_si128( 8 - shift );
+  for ( ; i + 16 <= count; i += 16 ) {
+    __m128i v = _mm_loadu_si128( (const __m128i *)(in + i) );
+    /* the byte lands in the upper half of each word, then moves down */
+    __m128i lo = _mm_sra_epi16( _mm_unpacklo_epi8( zero, v ), bits );
+    __m128i hi = _mm_sra_epi16( _mm_unpackhi_epi8( zero, v ), bits );
+    _mm_storeu_si128( (__m128i *)(out + i + 0), lo );
+    _mm_storeu_si128( (__m128i *)(out + i + 8), hi );
+  }
+#endif
+  for ( ; i < count; i++ )
+    out[i] = (int16_t)( in[i] * ( 1 << shift ) );
+}
+
+/* offset binary uint8 -> int16, scaled by 256 to full scale */
+inline void convert_8u_to_16i( const uint8_t *in, int16_t *out, size_t count )
+{
+  size_t i = 0;
+#if defined(USE_AVX) || defined(USE_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i sign = _mm_set1_epi8( (char) 0x80 );
+  for ( ; i + 16 <= count; i += 16 ) {
+    __m128i v = _mm_xor_si128( _mm_loadu_si128( (const __m128i *)(in + i) ), sign );
+    _mm_storeu_si128( (__m128i *)(out + i + 0), _mm_unpacklo_epi8( zero, v ) );
+    _mm_storeu_si128( (__m128i *)(out + i + 8), _mm_unpackhi_epi8( zero, v ) );
+  }
+#endif
+  for ( ; i < count; i++ )
+    out[i] = (int16_t)( int8_t( in[i] ^ 0x80 ) * 256 );
+}
+
+/* int16 -> int16 shifted left, the values have to fit */
+inline void convert_16i_shl( const int16_t *in, int16_t *out,
+                             size_t count, int shift )
+{
+  size_t i = 0;
+#if defined(USE_AVX) || defined(USE_SSE2)
+  const __m128i bits = _mm_cvtsi32_si128( shift );
+  for ( ; i + 8 <= count; i += 8 ) {
+    __m128i v = _mm_loadu_si128( (const __m128i *)(in + i) );
+    _mm_storeu_si128( (__m128i *)(out + i), _mm_sll_epi16( v, bits ) );
+  }
+#endif
+  for ( ; i < count; i++ )
+    out[i] = (int16_t)( uint16_t( in[i] ) << shift );
+}
+
+/* int16 -> int16 shifted right, arithmetic */
+inline void convert_16i_shr( const int16_t *in, int16_t *out,
+                             size_t count, int shift )
+{
+  size_t i = 0;
+#if defined(USE_AVX) || defined(USE_SSE2)
+  const __m128i bits = _mm_cvtsi32_si128( shift );
+  for ( ; i + 8 <= count; i += 8 ) {
+    __m128i v = _mm_loadu_si128( (const __m128i *)(in + i) );
+    _mm_storeu_si128( (__m128i *)(out + i), _mm_sra_epi16( v, bits ) );
+  }
+#endif
+  for ( ; i < count; i++ )
+    out[i] = (int16_t)( in[i] >> shift );
+}
+
+/* int16 -> int8 shifted right, saturating */
+inline void convert_16i_to_8i( const int16_t *in, int8_t *out,
+                               size_t count, int shift )
+{
+  size_t i = 0;
+#if defined(USE_AVX) || defined(USE_SSE2)
+  const __m128i bits = _mm_cvtsi32_si128( shift );
+  for ( ; i + 16 <= count; i += 16 ) {
+    __m128i a = _mm_sra_epi16( _mm_loadu_si128( (const __m128i *)(in + i + 0) ), bits );
+    __m128i b = _mm_sra_epi16( _mm_loadu_si128( (const __m128i *)(in + i + 8) ), bits );
+    _mm_storeu_si128( (__m128i *)(out + i), _mm_packs_epi16( a, b ) );
+  }
+#endif
+  for ( ; i < count; i++ ) {
+    int v = in[i] >> shift;
+    out[i] = (int8_t)( v > 127 ? 127 : v < -128 ? -128 : v );
+  }
+}
+
+#endif // OSMOSDR_CONVERT_HELPERS_H
@@ -0,0 +1,52 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_CONVERT_IC_H
+#define INCLUDED_CONVERT_IC_H
+
+#include <gnuradio/sync_block.h>
+
+class convert_ic;
+
+typedef std::shared_ptr< convert_ic > convert_ic_sptr;
+
+convert_ic_sptr make_convert_ic( size_t item_size );
+
+/*!
+ * Complex int16 or int8 to complex float, full scale becoming 1.0. The
+ * sink puts it in front of the backends which only take complex float when
+ * an integer item_type was asked for.
+ */
+class convert_ic : public gr::sync_block
+{
+private:
+  friend convert_ic_sptr make_convert_ic( size_t item_size );
+
+  convert_ic( size_t item_size );
+
+public:
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+private:
+  size_t _item_size;
+};
+
+#endif /* INCLUDED_CONVERT_IC_H */
@@ -0,0 +1,276 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef USE_AVX
+#include <immintrin.h>
+#elif USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <gnuradio/io_signature.h>
+
+#include <osmosdr/source.h>
+
+#include "dc_iq_corr_cc.h"
+
+/* samples per DC estimate, the estimate is refreshed once per block */
+#define CORR_BLOCK_LEN 4096
+
+/* DC smoothing per block, about 32 blocks time constant */
+#define CORR_DC_ALPHA (1.0f / 32)
+
+/* every CORR_IQ_DECIM'th sample feeds the IQ imbalance estimator */
+#define CORR_IQ_DECIM 16
+
+/* moment smoothing per decimated sample */
+#define CORR_IQ_ALPHA (1.0 / 8192)
+
+dc_iq_corr_cc_sptr make_dc_iq_corr_cc()
+{
+  return gnuradio::get_initial_sptr( new dc_iq_corr_cc() );
+}
+
+dc_iq_corr_cc::dc_iq_corr_cc()
+  : gr::sync_block( "dc_iq_corr_cc",
+                    gr::io_signature::make( 1, 1, sizeof(gr_complex) ),
+                    gr::io_signature::make( 1, 1, sizeof(gr_complex) ) ),
+    _dc_mode( osmosdr::source::DCOffsetOff ),
+    _iq_mode( osmosdr::source::IQBalanceOff ),
+    _dc( 0, 0 ),
+    _ii( 0 ), _qq( 0 ), _iq( 0 ),
+    _gain_i( 1 ), _gain_q( 1 ), _cross( 0 )
+{
+}
+
+/*
+ * out.i = in.i * m1[0] + k[0]
+ * out.q = in.q * m1[1] + in.i * m2 + k[1]
+ *
+ * k carries the DC offset through the same coefficients so the whole
+ * correction is two multiply-adds per vector. The sum of the raw input is
+ * returned for the DC estimator.
+ */
+static void corr_kernel( const float *in, float *out, size_t nitems,
+                         const float m1[2], float m2, const float k[2],
+                         float sum[2] )
+{
+  size_t i = 0;
+  size_t count = 2 * nitems;
+  float si = 0, sq = 0;
+#ifdef USE_AVX
+  const __m256 vm1 = _mm256_setr_ps( m1[0], m1[1], m1[0], m1[1], m1[0], m1[1], m1[0], m1[1] );
+  const __m256 vm2 = _mm256_setr_ps( 0, m2, 0, m2, 0, m2, 0, m2 );
+  const __m256 vk = _mm256_setr_ps( k[0], k[1], k[0], k[1], k[0], k[1], k[0], k[1] );
+  __m256 acc = _mm256_setzero_ps();
+  for ( ; i + 8 <= count; i += 8 ) {
+    __m256 v = _mm256_loadu_ps( in + i );
+    __m256 s = _mm256_permute_ps( v, 0xb1 ); /* q0 i0 q1 i1 ... */
+    acc = _mm256_add_ps( acc, v );
+#ifdef __FMA__
+    __m256 r = _mm256_fmadd_ps( v, vm1, _mm256_fmadd_ps( s, vm2, vk ) );
+#else
+    __m256 r = _mm256_add_ps( _mm256_mul_ps( v, vm1 ), _mm256_add_ps( _mm256_mul_ps( s, vm2 ), vk ) );
+#endif
+    _mm256_storeu_ps( out + i, r );
+  }
+  float a[8];
+  _mm256_storeu_ps( a, acc );
+  si = a[0] + a[2] + a[4] + a[6];
+  sq = a[1] + a[3] + a[5] + a[7];
+#elif USE_SSE2
+  const __m128 vm1 = _mm_setr_ps( m1[0], m1[1], m1[0], m1[1] );
+  const __m128 vm2 = _mm_setr_ps( 0, m2, 0, m2 );
+  const __m128 vk = _mm_setr_ps( k[0], k[1], k[0], k[1] );
+  __m128 acc = _mm_setzero_ps();
+  for ( ; i + 4 <= count; i += 4 ) {
+    __m128 v = _mm_loadu_ps( in + i );
+    __m128 s = _mm_shuffle_ps( v, v, _MM_SHUFFLE(2, 3, 0, 1) );
+    acc = _mm_add_ps( acc, v );
+    __m128 r = _mm_add_ps( _mm_mul_ps( v, vm1 ), _mm_add_ps( _mm_mul_ps( s, vm2 ), vk ) );
+    _mm_storeu_ps( out + i, r );
+  }
+  float a[4];
+  _mm_storeu_ps( a, acc );
+  si = a[0] + a[2];
+  sq = a[1] + a[3];
+#endif
+  for ( ; i < count; i += 2 ) {
+    float vi = in[i], vq = in[i + 1];
+    si += vi;
+    sq += vq;
+    out[i] = vi * m1[0] + k[0];
+    out[i + 1] = vq * m1[1] + vi * m2 + k[1];
+  }
+
+  sum[0] = si;
+  sum[1] = sq;
+}
+
+int dc_iq_corr_cc::work( int noutput_items,
+                         gr_vector_const_void_star &input_items,
+                         gr_vector_void_star &output_items )
+{
+  const gr_complex *in = (const gr_complex *) input_items[0];
+  gr_complex *out = (gr_complex *) output_items[0];
+
+  gr::thread::scoped_lock lock( d_setlock );
+
+  bool dc_on = _dc_mode != osmosdr::source::DCOffsetOff;
+  bool iq_on = _iq_mode != osmosdr::source::IQBalanceOff;
+
+  for ( int done = 0; done < noutput_items; ) {
+    int n = std::min( noutput_items - done, CORR_BLOCK_LEN );
+
+    if ( iq_on && osmosdr::source::IQBalanceAutomatic == _iq_mode ) {
+      estimate_iq( in + done, n );
+      update_coeffs();
+    }
+
+    float m1[2] = { 1, 1 }, m2 = 0, k[2] = { 0, 0 }, sum[2];
+    gr_complex dc = dc_on ? _dc : gr_complex( 0, 0 );
+
+    if ( iq_on ) {
+      m1[0] = _gain_i;
+      m1[1] = _gain_q;
+      m2 = _cross;
+    }
+
+    k[0] = -m1[0] * dc.real();
+    k[1] = -( m1[1] * dc.imag() + m2 * dc.real() );
+
+    corr_kernel( (const float *)( in + done ), (float *)( out + done ), n,
+                 m1, m2, k, sum );
+
+    if ( osmosdr::source::DCOffsetAutomatic == _dc_mode ) {
+      gr_complex mean( sum[0] / n, sum[1] / n );
+      float alpha = CORR_DC_ALPHA * n / CORR_BLOCK_LEN;
+      _dc += alpha * ( mean - _dc );
+    }
+
+    done += n;
+  }
+
+  return noutput_items;
+}
+
+void dc_iq_corr_cc::estimate_iq( const gr_complex *in, int nitems )
+{
+  double ii = 0, qq = 0, iq = 0;
+  int count = 0;
+
+  for ( int i = 0; i < nitems; i += CORR_IQ_DECIM ) {
+    double vi = in[i].real() - _dc.real();
+    double vq = in[i].imag() - _dc.imag();
+    ii += vi * vi;
+    qq += vq * vq;
+    iq += vi * vq;
+    count++;
+  }
+
+  if ( !count )
+    return;
+
+  ii /= count;
+  qq /= count;
+  iq /= count;
+
+  if ( 0 == _ii ) { /* first block seeds the averages */
+    _ii = ii;
+    _qq = qq;
+    _iq = iq;
+    return;
+  }
+
+  double alpha = std::min( 1.0, count * CORR_IQ_ALPHA );
+  _ii += alpha * ( ii - _ii );
+  _qq += alpha * ( qq - _qq );
+  _iq += alpha * ( iq - _iq );
+}
+
+void dc_iq_corr_cc::update_coeffs()
+{
+  /* Gram-Schmidt: remove the part of Q correlated with I, then scale the
+   * remainder to the power of I */
+  if ( _ii < 1e-12 )
+    return;
+
+  double rho = _iq / _ii;
+  double qq = _qq - rho * _iq;
+
+  if ( qq < 1e-12 )
+    return;
+
+  double g = std::sqrt( _ii / qq );
+
+  _gain_i = 1.0f;
+  _gain_q = g;
+  _cross = -g * rho;
+}
+
+void dc_iq_corr_cc::set_dc_offset_mode( int mode )
+{
+  gr::thread::scoped_lock lock( d_setlock );
+
+  /* leaving Automatic keeps the last estimate for Manual */
+  _dc_mode = mode;
+}
+
+void dc_iq_corr_cc::set_dc_offset( const std::complex<double> &offset )
+{
+  gr::thread::scoped_lock lock( d_setlock );
+
+  _dc = gr_complex( offset.real(), offset.imag() );
+}
+
+void dc_iq_corr_cc::set_iq_balance_mode( int mode )
+{
+  gr::thread::scoped_lock lock( d_setlock );
+
+  if ( osmosdr::source::IQBalanceAutomatic == mode &&
+       osmosdr::source::IQBalanceAutomatic != _iq_mode )
+    _ii = _qq = _iq = 0; /* restart the estimation */
+
+  _iq_mode = mode;
+}
+
+void dc_iq_corr_cc::set_iq_balance( const std::complex<double> &balance )
+{
+  gr::thread::scoped_lock lock( d_setlock );
+
+  /* same parametrization as gr-iqbal: magnitude and phase correction */
+  _gain_i = 1.0f + balance.real();
+  _gain_q = 1.0f;
+  _cross = balance.imag();
+}
+
+bool dc_iq_corr_cc::enabled()
+{
+  gr::thread::scoped_lock lock( d_setlock );
+
+  return _dc_mode != osmosdr::source::DCOffsetOff ||
+         _iq_mode != osmosdr::source::IQBalanceOff;
+}
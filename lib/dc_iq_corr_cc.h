@@ -0,0 +1,78 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_DC_IQ_CORR_CC_H
+#define INCLUDED_DC_IQ_CORR_CC_H
+
+#include <gnuradio/sync_block.h>
+
+class dc_iq_corr_cc;
+
+typedef std::shared_ptr< dc_iq_corr_cc > dc_iq_corr_cc_sptr;
+
+dc_iq_corr_cc_sptr make_dc_iq_corr_cc();
+
+/*!
+ * Software DC offset and IQ imbalance correction for receivers that can't
+ * do it in hardware. source_impl only splices it into a channel while one
+ * of the two modes is enabled.
+ *
+ * The DC estimate is a single-pole average of block means, the IQ
+ * imbalance is estimated blindly from second order moments taken on a
+ * decimated subset of the samples. Both corrections are folded into one
+ * multiply-add pass over the stream.
+ */
+class dc_iq_corr_cc : public gr::sync_block
+{
+private:
+  friend dc_iq_corr_cc_sptr make_dc_iq_corr_cc();
+
+  dc_iq_corr_cc();
+
+public:
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+  void set_dc_offset_mode( int mode );
+  void set_dc_offset( const std::complex<double> &offset );
+
+  void set_iq_balance_mode( int mode );
+  void set_iq_balance( const std::complex<double> &balance );
+
+  /* true while any correction is enabled */
+  bool enabled();
+
+private:
+  void estimate_iq( const gr_complex *in, int nitems );
+  void update_coeffs();
+
+  int _dc_mode;
+  int _iq_mode;
+
+  gr_complex _dc;
+
+  /* running second order moments of the DC-free input */
+  double _ii, _qq, _iq;
+
+  /* output I = _gain_i * I, output Q = _gain_q * Q + _cross * I */
+  float _gain_i, _gain_q, _cross;
+};
+
+#endif /* INCLUDED_DC_IQ_CORR_CC_H */
@@ -0,0 +1,316 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/fft/window.h>
+
+#include <volk/volk.h>
+
+#include "ddc_cc.h"
+
+/* blocks transformed per call at most, bounds the memory of the spectra */
+#define DDC_MAX_BLOCKS 4
+
+/* inverse FFT length over the filter taps per output sample */
+#define DDC_OVERLAP 4
+
+/* M, a power of two leaving 1 - 1 / DDC_OVERLAP of each block valid */
+static size_t ddc_fft_len( size_t taps )
+{
+  size_t len = 16;
+  while ( len < DDC_OVERLAP * taps )
+    len *= 2;
+
+  return len;
+}
+
+static double sinc( double x )
+{
+  return std::fabs( x ) < 1e-9 ? 1.0 : std::sin( M_PI * x ) / ( M_PI * x );
+}
+
+ddc_cc_sptr make_ddc_cc( size_t nddc, size_t decim, size_t taps, size_t threads )
+{
+  return gnuradio::get_initial_sptr( new ddc_cc( nddc, decim, taps, threads ) );
+}
+
+ddc_cc::ddc_cc( size_t nddc, size_t decim, size_t taps, size_t threads )
+  : gr::block( "ddc_cc",
+               gr::io_signature::make( 1, 1, sizeof(gr_complex) ),
+               gr::io_signature::make( nddc, nddc, sizeof(gr_complex) ) ),
+    _nddc( nddc ),
+    _decim( decim ),
+    _taps( taps ),
+    _fft_len( ddc_fft_len( taps ) ),
+    _len( decim * ddc_fft_len( taps ) ),
+    _step( decim * ( ddc_fft_len( taps ) - taps ) ),
+    _nthreads( std::max( threads, size_t(1) ) ),
+    _chans( nddc ),
+    _offsets( nddc, 0.0 ),
+    _fft( decim * ddc_fft_len( taps ) ),
+    _buf( decim * taps, gr_complex( 0, 0 ) ),
+    _origin( 0 ),
+    _running( false ),
+    _next( nddc ),
+    _done( 0 ),
+    _batch_blocks( 0 ),
+    _batch_out( NULL )
+{
+  if ( nddc < 1 || decim < 2 || taps < 4 )
+    throw std::runtime_error("ddc needs at least one channel, a decimation of 2 and 4 taps.");
+
+  /* low pass at the input rate, its stop band starts at the output nyquist */
+  const size_t ntaps = decim * taps + 1;
+  const double cutoff = 0.5 / decim - 2.0 / ntaps;
+  std::vector< float > window = gr::fft::window::blackman_harris( ntaps );
+
+  double sum = 0;
+  std::vector< double > taps_d( ntaps );
+  for ( size_t j = 0; j < ntaps; j++ ) {
+    taps_d[j] = 2 * cutoff * sinc( 2 * cutoff * ( j - ( ntaps - 1 ) / 2.0 ) ) * window[j];
+    sum += taps_d[j];
+  }
+
+  std::fill( _fft.get_inbuf(), _fft.get_inbuf() + _len, gr_complex( 0, 0 ) );
+  for ( size_t j = 0; j < ntaps; j++ )
+    _fft.get_inbuf()[j] = gr_complex( taps_d[j] / sum, 0 );
+  _fft.execute();
+
+  /* bin r around DC at index r mod M, where the inverse FFT expects it,
+   * including the 1 / N of the inverse transform of the full length */
+  _response.resize( _fft_len );
+  for ( size_t i = 0; i < _fft_len; i++ ) {
+    long r = long( i ) - long( _fft_len / 2 );
+    _response[ ( r + _fft_len ) % _fft_len ] =
+        _fft.get_outbuf()[ ( r + _len ) % _len ] / float( _len );
+  }
+
+  for ( channel &chan : _chans ) {
+    chan.offset = 0;
+    chan.bin = 0;
+    chan.residual = 0;
+    chan.phase = 0;
+    chan.ifft.reset( new gr::fft::fft_complex_rev( _fft_len ) );
+  }
+
+  set_relative_rate( 1, _decim );
+  set_output_multiple( _fft_len - _taps );
+  set_tag_propagation_policy( TPP_DONT );
+}
+
+ddc_cc::~ddc_cc()
+{
+  if ( !_workers.empty() )
+    stop();
+}
+
+bool ddc_cc::start()
+{
+  std::lock_guard< std::mutex > lock( _lock );
+
+  _running = true;
+  for ( size_t i = 1; i < _nthreads; i++ )
+    _workers.push_back( std::thread( &ddc_cc::worker_loop, this ) );
+
+  return true;
+}
+
+bool ddc_cc::stop()
+{
+  {
+    std::lock_guard< std::mutex > lock( _lock );
+    _running = false;
+  }
+  _cond.notify_all();
+
+  for ( std::thread &worker : _workers )
+    worker.join();
+
+  _workers.clear();
+
+  return true;
+}
+
+double ddc_cc::set_offset( size_t ddc, double offset )
+{
+  std::lock_guard< std::mutex > lock( _lock );
+
+  offset = std::min( std::max( offset, -0.5 ), 0.5 );
+  _offsets.at( ddc ) = offset;
+
+  return offset;
+}
+
+double ddc_cc::get_offset( size_t ddc )
+{
+  std::lock_guard< std::mutex > lock( _lock );
+
+  return _offsets.at( ddc );
+}
+
+/* input missing from _buf to transform that many blocks */
+size_t ddc_cc::needed( size_t nblocks )
+{
+  size_t total = nblocks * _step + _decim * _taps;
+
+  return total > _buf.size() ? total - _buf.size() : 0;
+}
+
+void ddc_cc::forecast( int noutput_items, gr_vector_int &ninput_items_required )
+{
+  size_t nblocks = std::min( size_t( noutput_items ) / ( _fft_len - _taps ),
+                             size_t( DDC_MAX_BLOCKS ) );
+
+  ninput_items_required[0] = int( needed( std::max( nblocks, size_t(1) ) ) );
+}
+
+void ddc_cc::process( size_t ddc, size_t nblocks, gr_complex *out )
+{
+  channel &chan = _chans[ ddc ];
+  const size_t nout = _fft_len - _taps;
+  gr_complex *in = chan.ifft->get_inbuf();
+
+  for ( size_t blk = 0; blk < nblocks; blk++ ) {
+    const gr_complex *spec = &_spec[ blk * _len ];
+
+    /* the M bins around the channel, moved to DC */
+    for ( size_t i = 0; i < _fft_len; i++ ) {
+      size_t r = ( i + _fft_len - _fft_len / 2 ) % _fft_len;
+      size_t k = ( chan.bin + _len + i - _fft_len / 2 ) % _len;
+      in[r] = spec[k];
+    }
+    volk_32fc_x2_multiply_32fc( in, in, _response.data(), _fft_len );
+
+    chan.ifft->execute();
+
+    /* the bin shift restarts with every block, its phase at the block
+     * start is added to the residual rotation */
+    uint64_t origin = ( _origin + blk * _step ) % _len;
+    double cycles = -double( ( chan.bin * origin ) % _len ) / _len - chan.phase;
+    double rad = 2 * M_PI * ( cycles - std::floor( cycles ) );
+
+    lv_32fc_t phase = lv_32fc_t( std::cos( rad ), std::sin( rad ) );
+    lv_32fc_t phase_inc = lv_32fc_t( std::cos( 2 * M_PI * chan.residual ),
+                                     -std::sin( 2 * M_PI * chan.residual ) );
+    volk_32fc_s32fc_x2_rotator_32fc( out + blk * nout, chan.ifft->get_outbuf() + _taps,
+                                     phase_inc, &phase, nout );
+
+    chan.phase += chan.residual * nout;
+    chan.phase -= std::floor( chan.phase );
+  }
+}
+
+void ddc_cc::worker_loop()
+{
+  std::unique_lock< std::mutex > lock( _lock );
+
+  while ( true ) {
+    while ( _running && _next >= _nddc )
+      _cond.wait( lock );
+
+    if ( !_running )
+      break;
+
+    size_t ddc = _next++;
+    size_t nblocks = _batch_blocks;
+    gr_complex *out = (gr_complex *) ( *_batch_out )[ ddc ];
+    lock.unlock();
+
+    process( ddc, nblocks, out );
+
+    lock.lock();
+    if ( ++_done == _nddc )
+      _cond.notify_all();
+  }
+}
+
+int ddc_cc::general_work( int noutput_items,
+                          gr_vector_int &ninput_items,
+                          gr_vector_const_void_star &input_items,
+                          gr_vector_void_star &output_items )
+{
+  const gr_complex *in = (const gr_complex *) input_items[0];
+  const size_t nout = _fft_len - _taps;
+
+  size_t want = std::min( size_t( noutput_items ) / nout, size_t( DDC_MAX_BLOCKS ) );
+  size_t take = std::min( size_t( ninput_items[0] ), needed( want ) );
+
+  _buf.insert( _buf.end(), in, in + take );
+  consume_each( int( take ) );
+
+  size_t nblocks = std::min( want, ( _buf.size() - _decim * _taps ) / _step );
+  if ( !nblocks )
+    return 0;
+
+  _spec.resize( nblocks * _len );
+  for ( size_t blk = 0; blk < nblocks; blk++ ) {
+    memcpy( _fft.get_inbuf(), &_buf[ blk * _step ], _len * sizeof(gr_complex) );
+    _fft.execute();
+    memcpy( &_spec[ blk * _len ], _fft.get_outbuf(), _len * sizeof(gr_complex) );
+  }
+
+  std::unique_lock< std::mutex > lock( _lock );
+
+  /* retunes take effect at the start of a call */
+  for ( size_t ddc = 0; ddc < _nddc; ddc++ ) {
+    channel &chan = _chans[ ddc ];
+    if ( chan.offset == _offsets[ ddc ] )
+      continue;
+
+    chan.offset = _offsets[ ddc ];
+    double bin = std::round( chan.offset * _len );
+    chan.bin = size_t( long( bin ) + long( _len ) ) % _len;
+    chan.residual = ( chan.offset - bin / _len ) * _decim;
+  }
+
+  /* the channels are claimed by the workers and this thread alike */
+  _batch_blocks = nblocks;
+  _batch_out = &output_items;
+  _done = 0;
+  _next = 0;
+  _cond.notify_all();
+
+  while ( _next < _nddc ) {
+    size_t ddc = _next++;
+    lock.unlock();
+    process( ddc, nblocks, (gr_complex *) output_items[ ddc ] );
+    lock.lock();
+    _done++;
+  }
+
+  while ( _done < _nddc )
+    _cond.wait( lock );
+
+  lock.unlock();
+
+  _origin = ( _origin + nblocks * _step ) % _len;
+  _buf.erase( _buf.begin(), _buf.begin() + nblocks * _step );
+
+  return int( nblocks * nout );
+}
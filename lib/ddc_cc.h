@@ -0,0 +1,120 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_DDC_CC_H
+#define INCLUDED_DDC_CC_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/fft/fft.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ddc_cc;
+
+typedef std::shared_ptr< ddc_cc > ddc_cc_sptr;
+
+ddc_cc_sptr make_ddc_cc( size_t nddc, size_t decim, size_t taps, size_t threads );
+
+/*!
+ * Fast convolution channelizer behind the ddc= argument of the source.
+ *
+ * The wideband input goes through one overlap-save FFT of decim * M points,
+ * shared by all channels. Each channel takes the M bins around its offset,
+ * weights them with the response of a low pass filter of taps * decim + 1
+ * taps and returns to the time domain with an M point inverse FFT, already
+ * decimated. A rotator removes the part of the offset below one bin and
+ * keeps the phase continuous from block to block. Past the shared FFT the
+ * cost of a channel only depends on its output rate.
+ *
+ * With more than one thread the channels are spread over workers.
+ */
+class ddc_cc : public gr::block
+{
+private:
+  friend ddc_cc_sptr make_ddc_cc( size_t nddc, size_t decim, size_t taps, size_t threads );
+
+  ddc_cc( size_t nddc, size_t decim, size_t taps, size_t threads );
+
+public:
+  ~ddc_cc();
+
+  bool start();
+  bool stop();
+
+  void forecast( int noutput_items, gr_vector_int &ninput_items_required );
+
+  int general_work( int noutput_items,
+                    gr_vector_int &ninput_items,
+                    gr_vector_const_void_star &input_items,
+                    gr_vector_void_star &output_items );
+
+  size_t decimation( void ) const { return _decim; }
+
+  /* offsets in cycles per input sample, within +-0.5 */
+  double set_offset( size_t ddc, double offset );
+  double get_offset( size_t ddc );
+
+private:
+  struct channel
+  {
+    double offset;
+    size_t bin;
+    double residual;    /* cycles per output sample left after the bin */
+    double phase;       /* of the residual rotation, in cycles */
+    std::shared_ptr< gr::fft::fft_complex_rev > ifft;
+  };
+
+  size_t needed( size_t nblocks );
+  void process( size_t ddc, size_t nblocks, gr_complex *out );
+  void worker_loop();
+
+  size_t _nddc;
+  size_t _decim;
+  size_t _taps;
+  size_t _fft_len;     /* M, of the inverse FFTs */
+  size_t _len;         /* N = decim * M, of the shared FFT */
+  size_t _step;        /* input samples per block */
+  size_t _nthreads;
+
+  std::vector< gr_complex > _response;  /* the M bins around DC, scaled */
+  std::vector< channel > _chans;
+  std::vector< double > _offsets;       /* set by the user, taken by work() */
+
+  gr::fft::fft_complex_fwd _fft;
+  std::vector< gr_complex > _buf;       /* input with the overlap in front */
+  std::vector< gr_complex > _spec;      /* spectra of the blocks of a call */
+  uint64_t _origin;                     /* block start modulo N */
+
+  std::mutex _lock;
+  std::condition_variable _cond;
+  std::vector< std::thread > _workers;
+  bool _running;
+
+  /* channels of the current call, claimed one by one */
+  size_t _next;
+  size_t _done;
+  size_t _batch_blocks;
+  gr_vector_void_star *_batch_out;
+};
+
+#endif /* INCLUDED_DDC_CC_H */
@@ -85,6 +85,10 @@
 #include <redpitaya_source_c.h>
 #endif
 
+#ifdef ENABLE_VRT
+#include <vrt_source_c.h>
+#endif
+
 #ifdef ENABLE_FREESRP
 #include <freesrp_source_c.h>
 #endif
@@ -206,6 +210,10 @@ devices_t device::find(const device_t &hint)
   for (std::string dev : redpitaya_source_c::get_devices( fake ))
     devices.push_back( device_t(dev) );
 #endif
+#ifdef ENABLE_VRT
+  for (std::string dev : vrt_source_c::get_devices( fake ))
+    devices.push_back( device_t(dev) );
+#endif
 #ifdef ENABLE_FILE
   for (std::string dev : file_source_c::get_devices( fake ))
     devices.push_back( device_t(dev) );
@@ -0,0 +1,160 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef OSMOSDR_DIRECT_BLOCK_H
+#define OSMOSDR_DIRECT_BLOCK_H
+
+#include <gnuradio/sync_block.h>
+#include <gnuradio/tags.h>
+
+#include <vector>
+
+/*
+ * What osmosdr::stream keeps for a backend while it calls work() itself.
+ * Offsets are absolute like in a flowgraph, counted from the first item
+ * the stream passed through the block. A source adds its tags to the list
+ * of the output port, a sink finds the ones the stream fed it.
+ */
+struct direct_state
+{
+  direct_state( size_t nports = 1 ) : nitems( 0 ), tags( nports ) {}
+
+  uint64_t nitems;
+  std::vector< std::vector< gr::tag_t > > tags;
+};
+
+/*
+ * Base of the backends that count items or use stream tags in work().
+ *
+ * Outside of a flowgraph a block has no detail, which is where GNU Radio
+ * keeps item counts and tags. While a direct_state is attached these calls
+ * are answered from it instead, otherwise they go to the block as usual.
+ * The stream advances by what work() returns, consuming is a no-op then.
+ */
+class direct_block : public gr::sync_block
+{
+public:
+  void set_direct( direct_state *state ) { _direct = state; }
+
+  uint64_t nitems_read( unsigned int which_input )
+  {
+    return _direct ? _direct->nitems : gr::sync_block::nitems_read( which_input );
+  }
+
+  uint64_t nitems_written( unsigned int which_output )
+  {
+    return _direct ? _direct->nitems : gr::sync_block::nitems_written( which_output );
+  }
+
+  void consume( int which_input, int how_many_items )
+  {
+    if ( !_direct )
+      gr::sync_block::consume( which_input, how_many_items );
+  }
+
+  void consume_each( int how_many_items )
+  {
+    if ( !_direct )
+      gr::sync_block::consume_each( how_many_items );
+  }
+
+protected:
+  direct_block( const std::string &name,
+                gr::io_signature::sptr input_signature,
+                gr::io_signature::sptr output_signature )
+    : gr::sync_block( name, input_signature, output_signature ),
+      _direct( NULL )
+  {
+  }
+
+  void add_item_tag( unsigned int which_output, const gr::tag_t &tag )
+  {
+    if ( _direct )
+      _direct->tags[ which_output ].push_back( tag );
+    else
+      gr::sync_block::add_item_tag( which_output, tag );
+  }
+
+  void add_item_tag( unsigned int which_output, uint64_t abs_offset,
+                     const pmt::pmt_t &key, const pmt::pmt_t &value,
+                     const pmt::pmt_t &srcid = pmt::PMT_F )
+  {
+    gr::tag_t tag;
+    tag.offset = abs_offset;
+    tag.key = key;
+    tag.value = value;
+    tag.srcid = srcid;
+
+    add_item_tag( which_output, tag );
+  }
+
+  void get_tags_in_range( std::vector< gr::tag_t > &v, unsigned int which_input,
+                          uint64_t abs_start, uint64_t abs_end )
+  {
+    if ( !_direct ) {
+      gr::sync_block::get_tags_in_range( v, which_input, abs_start, abs_end );
+      return;
+    }
+
+    v.clear();
+    for ( const gr::tag_t &tag : _direct->tags[ which_input ] )
+      if ( tag.offset >= abs_start && tag.offset < abs_end )
+        v.push_back( tag );
+  }
+
+  void get_tags_in_range( std::vector< gr::tag_t > &v, unsigned int which_input,
+                          uint64_t abs_start, uint64_t abs_end,
+                          const pmt::pmt_t &key )
+  {
+    if ( !_direct ) {
+      gr::sync_block::get_tags_in_range( v, which_input, abs_start, abs_end, key );
+      return;
+    }
+
+    get_tags_in_range( v, which_input, abs_start, abs_end );
+    std::vector< gr::tag_t > all;
+    all.swap( v );
+    for ( const gr::tag_t &tag : all )
+      if ( pmt::eqv( tag.key, key ) )
+        v.push_back( tag );
+  }
+
+  void get_tags_in_window( std::vector< gr::tag_t > &v, unsigned int which_input,
+                           uint64_t rel_start, uint64_t rel_end )
+  {
+    uint64_t first = nitems_read( which_input );
+
+    get_tags_in_range( v, which_input, first + rel_start, first + rel_end );
+  }
+
+  void get_tags_in_window( std::vector< gr::tag_t > &v, unsigned int which_input,
+                           uint64_t rel_start, uint64_t rel_end,
+                           const pmt::pmt_t &key )
+  {
+    uint64_t first = nitems_read( which_input );
+
+    get_tags_in_range( v, which_input, first + rel_start, first + rel_end, key );
+  }
+
+private:
+  direct_state *_direct;
+};
+
+#endif /* OSMOSDR_DIRECT_BLOCK_H */
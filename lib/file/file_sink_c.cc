@@ -40,7 +40,7 @@ file_sink_c_sptr make_file_sink_c(const std::string &args)
 
 file_sink_c::file_sink_c(const std::string &args) :
   gr::hier_block2("file_sink_c",
-                 gr::io_signature::make(1, 1, sizeof (gr_complex)),
+                 gr::io_signature::make(1, 1, args_to_item_size(args)),
                  gr::io_signature::make(0, 0, 0))
 {
   std::string filename;
@@ -77,11 +77,12 @@ file_sink_c::file_sink_c(const std::string &args) :
 
   _file_rate = _rate;
 
-  _sink = gr::blocks::file_sink::make( sizeof(gr_complex),
+  /* integer items are written as they are, as cs16 or cs8 files */
+  _sink = gr::blocks::file_sink::make( args_to_item_size(args),
                                            filename.c_str(),
                                            append);
 
-  _throttle = gr::blocks::throttle::make( sizeof(gr_complex), _file_rate );
+  _throttle = gr::blocks::throttle::make( args_to_item_size(args), _file_rate );
 
   if (throttle) {
     connect( self(), 0, _throttle, 0 );
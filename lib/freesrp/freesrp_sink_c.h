@@ -27,6 +27,7 @@
 
 #include "osmosdr/ranges.h"
 #include "sink_iface.h"
+#include "direct_block.h"
 
 #include "freesrp_common.h"
 #include "readerwriterqueue/readerwriterqueue.h"
@@ -61,7 +62,7 @@ typedef std::shared_ptr<freesrp_sink_c> freesrp_sink_c_sptr;
 freesrp_sink_c_sptr make_freesrp_sink_c (const std::string & args = "");
 
 class freesrp_sink_c :
-    public gr::sync_block,
+    public direct_block,
     public sink_iface,
     public freesrp_common
 {
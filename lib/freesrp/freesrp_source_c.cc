@@ -1,5 +1,11 @@
 #include "freesrp_source_c.h"
 
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "convert_helpers.h"
+
 freesrp_source_c_sptr make_freesrp_source_c (const std::string &args)
 {
     return gnuradio::get_initial_sptr(new freesrp_source_c (args));
@@ -19,10 +25,12 @@ static const int MAX_IN = 0;	// maximum number of input streams
 static const int MIN_OUT = 1;	// minimum number of output streams
 static const int MAX_OUT = 1;	// maximum number of output streams
 
-freesrp_source_c::freesrp_source_c (const std::string & args) : gr::sync_block ("freesrp_source_c",
+freesrp_source_c::freesrp_source_c (const std::string & args) : direct_block ("freesrp_source_c",
                                                                 gr::io_signature::make (MIN_IN, MAX_IN, sizeof (gr_complex)),
                                                                 gr::io_signature::make (MIN_OUT, MAX_OUT, sizeof (gr_complex))),
-                                                                freesrp_common(args)
+                                                                freesrp_common(args),
+                                                                _numa_node(args_to_numa_node(params_to_dict(args))),
+                                                                _block(pool_allocator<FreeSRP::sample>(_numa_node))
 {
     if(_srp == nullptr)
     {
@@ -49,67 +57,85 @@ bool freesrp_source_c::stop()
     _srp->send_cmd({FreeSRP::SET_DATAPATH_EN, 0});
     _srp->stop_rx();
 
-    _running = false;
+    {
+        std::lock_guard<std::mutex> lk(_buf_mut);
+        _running = false;
+    }
+    _buf_cond.notify_all();
 
     return true;
 }
 
 void freesrp_source_c::freesrp_rx_callback(const std::vector<FreeSRP::sample> &samples)
 {
-    std::unique_lock<std::mutex> lk(_buf_mut);
+    // Reuse a block already drained by work() to avoid allocating per transfer
+    block_t block{pool_allocator<FreeSRP::sample>(_numa_node)};
+    _free_queue.try_dequeue(block);
+    block.assign(samples.begin(), samples.end());
 
-    for(const FreeSRP::sample &s : samples)
+    if(!_buf_queue.try_enqueue(std::move(block)))
     {
-        if(!_buf_queue.try_enqueue(s))
+        _overflows++;
+        if(!_ignore_overflow)
         {
-	    if(!_ignore_overflow)
-	    {
-		throw std::runtime_error("RX buffer overflow");
-	    }
-        }
-        else
-        {
-            _buf_num_samples++;
+            std::cerr << "O" << std::flush;
         }
+        return;
     }
 
+    // The mutex only orders the wakeup, the samples bypass it
+    std::lock_guard<std::mutex> lk(_buf_mut);
     _buf_cond.notify_one();
 }
 
 int freesrp_source_c::work(int noutput_items, gr_vector_const_void_star& input_items, gr_vector_void_star& output_items)
 {
     gr_complex *out = static_cast<gr_complex *>(output_items[0]);
+    int produced = 0;
 
-    std::unique_lock<std::mutex> lk(_buf_mut);
-
-    if(!_running)
+    while(produced < noutput_items)
     {
-	return WORK_DONE;
-    }
-
-    // Wait until enough samples collected
-    while(_buf_num_samples < (unsigned int) noutput_items)
-    {
-        _buf_cond.wait(lk);
-    }
-
-    for(int i = 0; i < noutput_items; ++i)
-    {
-        FreeSRP::sample s;
-        if(!_buf_queue.try_dequeue(s))
+        if(_block_offset >= _block.size())
         {
-            // This should not be happening
-            throw std::runtime_error("Failed to get sample from buffer. This should never happen. Number of available samples reported to be " + std::to_string(_buf_num_samples) + ", noutput_items=" + std::to_string(noutput_items) + ", i=" + std::to_string(i));
-        }
-        else
-        {
-            _buf_num_samples--;
+            if(!_block.empty())
+            {
+                _free_queue.try_enqueue(std::move(_block));
+                _block.clear();
+            }
+            _block_offset = 0;
+
+            if(!_buf_queue.try_dequeue(_block))
+            {
+                // Hand out what we have rather than waiting for a full buffer
+                if(produced > 0)
+                {
+                    break;
+                }
+
+                std::unique_lock<std::mutex> lk(_buf_mut);
+                while(_running && !_buf_queue.try_dequeue(_block))
+                {
+                    _buf_cond.wait_for(lk, std::chrono::milliseconds(100));
+                }
+
+                if(!_running)
+                {
+                    return WORK_DONE;
+                }
+            }
         }
 
-        out[i] = gr_complex(((float) s.i) / 2048.0f, ((float) s.q) / 2048.0f);
+        size_t n = std::min((size_t) (noutput_items - produced), _block.size() - _block_offset);
+
+        // FreeSRP::sample is an interleaved int16 I/Q pair with 12 significant bits
+        convert_16i_to_32f((const int16_t *) &_block[_block_offset],
+                           (float *) (out + produced), 2 * n, 1.0f / 2048.0f);
+
+        _block_offset += n;
+        produced += n;
     }
 
-    return noutput_items;
+    return produced;
 }
 
 double freesrp_source_c::set_sample_rate( double rate )
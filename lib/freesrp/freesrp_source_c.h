@@ -27,6 +27,8 @@
 
 #include "osmosdr/ranges.h"
 #include "source_iface.h"
+#include "direct_block.h"
+#include "pool_helpers.h"
 
 #include "freesrp_common.h"
 
@@ -34,8 +36,15 @@
 
 #include <freesrp.hpp>
 
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
+#include <vector>
+
+#define FREESRP_RX_BLOCKS 64
+
+static_assert(sizeof(FreeSRP::sample) == 2 * sizeof(int16_t),
+              "FreeSRP::sample is expected to be a packed int16 I/Q pair");
 
 class freesrp_source_c;
 
@@ -62,7 +71,7 @@ typedef std::shared_ptr<freesrp_source_c> freesrp_source_c_sptr;
 freesrp_source_c_sptr make_freesrp_source_c (const std::string & args = "");
 
 class freesrp_source_c :
-    public gr::sync_block,
+    public direct_block,
     public source_iface,
     public freesrp_common
 {
@@ -78,6 +87,7 @@ public:
     // From freesrp_common:
     static std::vector<std::string> get_devices() { return freesrp_common::get_devices(); };
     size_t get_num_channels( void ) { return freesrp_common::get_num_channels(); }
+    uint64_t get_overflows( void ) { return _overflows; }
     osmosdr::meta_range_t get_sample_rates( void ) { return freesrp_common::get_sample_rates(); }
     osmosdr::freq_range_t get_freq_range( size_t chan = 0 ) { return freesrp_common::get_freq_range(chan); }
     osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 ) { return freesrp_common::get_bandwidth_range(chan); }
@@ -120,12 +130,23 @@ private:
 
     void freesrp_rx_callback(const std::vector<FreeSRP::sample> &samples);
 
-    bool _running = false;
+    std::atomic<bool> _running{false};
 
     std::mutex _buf_mut{};
     std::condition_variable _buf_cond{};
-    size_t _buf_num_samples = 0;
-    moodycamel::ReaderWriterQueue<FreeSRP::sample> _buf_queue{FREESRP_RX_TX_QUEUE_SIZE};
+
+    typedef std::vector<FreeSRP::sample, pool_allocator<FreeSRP::sample>> block_t;
+
+    int _numa_node;
+
+    // Whole USB transfers travel through the queue, drained blocks are
+    // handed back through _free_queue so their storage gets reused
+    moodycamel::ReaderWriterQueue<block_t> _buf_queue{FREESRP_RX_BLOCKS};
+    moodycamel::ReaderWriterQueue<block_t> _free_queue{FREESRP_RX_BLOCKS};
+    block_t _block;
+    size_t _block_offset = 0;
+
+    std::atomic<uint64_t> _overflows{0};
 };
 
 #endif /* INCLUDED_FREESRP_SOURCE_C_H */
@@ -32,6 +32,7 @@
 #include <stdexcept>
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 #ifdef USE_AVX
 #include <immintrin.h>
 #elif USE_SSE2
@@ -43,10 +44,12 @@
 #include "hackrf_sink_c.h"
 
 #include "arg_helpers.h"
+#include "convert_helpers.h"
+#include "pool_helpers.h"
 
-static inline bool cb_init(circular_buffer_t *cb, size_t capacity, size_t sz)
+static inline bool cb_init(circular_buffer_t *cb, size_t capacity, size_t sz, int node)
 {
-  cb->buffer = malloc(capacity * sz);
+  cb->buffer = buffer_pool::get().alloc(capacity * sz, node);
   if(cb->buffer == NULL)
     return false; // handle error
   cb->buffer_end = (int8_t *)cb->buffer + capacity * sz;
@@ -60,7 +63,7 @@ static inline bool cb_init(circular_buffer_t *cb, size_t capacity, size_t sz)
 
 static inline void cb_free(circular_buffer_t *cb)
 {
-  free(cb->buffer);
+  buffer_pool::get().release(cb->buffer);
   cb->buffer = NULL;
   // clear out other fields too, just to be safe
   cb->buffer_end = 0;
@@ -130,10 +133,11 @@ static const int MAX_OUT = 0;  // maximum number of output streams
  * The private constructor
  */
 hackrf_sink_c::hackrf_sink_c (const std::string &args)
-  : gr::sync_block ("hackrf_sink_c",
-        gr::io_signature::make(MIN_IN, MAX_IN, sizeof (gr_complex)),
+  : direct_block ("hackrf_sink_c",
+        gr::io_signature::make(MIN_IN, MAX_IN, args_to_item_size(args)),
         gr::io_signature::make(MIN_OUT, MAX_OUT, sizeof (gr_complex))),
     hackrf_common::hackrf_common(args),
+    _item_size(args_to_item_size(args)),
     _buf(NULL),
     _vga_gain(0)
 {
@@ -167,9 +171,12 @@ hackrf_sink_c::hackrf_sink_c (const std::string &args)
     hackrf_common::set_bias(dict["bias_tx"] == "1");
   }
 
-  _buf = (int8_t *) malloc( BUF_LEN );
+  int numa_node = args_to_numa_node( dict );
 
-  cb_init( &_cbuf, _buf_num, BUF_LEN );
+  _buf = (int8_t *) buffer_pool::get().alloc( BUF_LEN, numa_node );
+
+  if ( !_buf || !cb_init( &_cbuf, _buf_num, BUF_LEN, numa_node ) )
+    throw std::runtime_error("Failed to allocate sample buffers.");
 }
 
 /*
@@ -177,7 +184,7 @@ hackrf_sink_c::hackrf_sink_c (const std::string &args)
  */
 hackrf_sink_c::~hackrf_sink_c ()
 {
-  free(_buf);
+  buffer_pool::get().release(_buf);
   _buf = NULL;
 
   cb_free( &_cbuf );
@@ -195,6 +202,8 @@ int hackrf_sink_c::hackrf_tx_callback(unsigned char *buffer, uint32_t length)
   for (unsigned int i = 0; i < length; ++i) /* simulate noise */
     *buffer++ = rand() % 255;
 #else
+  _stats.arrival();
+
   {
     std::lock_guard<std::mutex> lock(_buf_mutex);
 
@@ -204,10 +213,13 @@ int hackrf_sink_c::hackrf_tx_callback(unsigned char *buffer, uint32_t length)
         _buf_cond.notify_one();
         return -1;
       } else {
+        _underflows++;
         std::cerr << "U" << std::flush;
       }
     } else {
 //      std::cerr << "-" << std::flush;
+      _queued.taken(1, _stats);
+      _stats.fill(_cbuf.count * (BUF_LEN / 2), _cbuf.capacity * (BUF_LEN / 2));
       _buf_cond.notify_one();
     }
   }
@@ -247,6 +259,7 @@ bool hackrf_sink_c::stop()
     // Fill the rest of the current buffer with silence.
     memset(_buf + _buf_used, 0, BUF_LEN - _buf_used);
     cb_push_back( &_cbuf, _buf );
+    _queued.queued(1, stream_stats::now());
     _buf_used = 0;
 
     // Add some more silence so the end doesn't get cut off.
@@ -256,6 +269,7 @@ bool hackrf_sink_c::stop()
         _buf_cond.wait( lock );
 
       cb_push_back( &_cbuf, _buf );
+      _queued.queued(1, stream_stats::now());
     }
 
     _stopping = true;
@@ -339,8 +353,6 @@ int hackrf_sink_c::work( int noutput_items,
                          gr_vector_const_void_star &input_items,
                          gr_vector_void_star &output_items )
 {
-  const gr_complex *in = (const gr_complex *) input_items[0];
-
   {
     std::unique_lock<std::mutex> lock(_buf_mutex);
 
@@ -354,21 +366,29 @@ int hackrf_sink_c::work( int noutput_items,
   unsigned int remaining = (BUF_LEN-_buf_used)/2; //complex
 
   unsigned int count = std::min((unsigned int)noutput_items,remaining);
-  unsigned int sse_rem = count/8; // 8 complex = 16f==512bit for avx
-  unsigned int nosse_rem = count%8; // remainder
+
+  if (_item_size == sizeof(gr_complex)) {
+    const gr_complex *in = (const gr_complex *) input_items[0];
+    unsigned int sse_rem = count/8; // 8 complex = 16f==512bit for avx
+    unsigned int nosse_rem = count%8; // remainder
 
 #ifdef USE_AVX
-  convert_avx((float*)in, buf, sse_rem);
-  convert_default((float*)(in+sse_rem*8), buf+(sse_rem*8*2), nosse_rem*2);
+    convert_avx((float*)in, buf, sse_rem);
+    convert_default((float*)(in+sse_rem*8), buf+(sse_rem*8*2), nosse_rem*2);
 #elif USE_SSE2
-  convert_sse2((float*)in, buf, sse_rem);
-  convert_default((float*)(in+sse_rem*8), buf+(sse_rem*8*2), nosse_rem*2);
+    convert_sse2((float*)in, buf, sse_rem);
+    convert_default((float*)(in+sse_rem*8), buf+(sse_rem*8*2), nosse_rem*2);
 #else
-  convert_default((float*)in, buf, count*2);
+    convert_default((float*)in, buf, count*2);
 #endif
+  } else if (_item_size == 2 * sizeof(int16_t)) {
+    convert_16i_to_8i((const int16_t *) input_items[0], buf, count*2, 8);
+  } else {
+    memcpy(buf, input_items[0], count*2); /* the device format */
+  }
 
-  _buf_used += (sse_rem*8+nosse_rem)*2;
-  int items_consumed = sse_rem*8+nosse_rem;
+  _buf_used += count*2;
+  int items_consumed = count;
 
   if((unsigned int)noutput_items >= remaining) {
     {
@@ -381,6 +401,8 @@ int hackrf_sink_c::work( int noutput_items,
       } else {
 //        std::cerr << "+" << std::flush;
         _buf_used = 0;
+        _queued.queued(1, stream_stats::now());
+        _stats.fill(_cbuf.count * (BUF_LEN / 2), _cbuf.capacity * (BUF_LEN / 2));
       }
     }
   }
@@ -403,6 +425,15 @@ size_t hackrf_sink_c::get_num_channels()
   return 1;
 }
 
+std::map<std::string, double> hackrf_sink_c::get_stats( size_t chan )
+{
+  std::map<std::string, double> stats;
+  _stats.report( stats );
+  stats["underflows"] = double( _underflows );
+
+  return stats;
+}
+
 osmosdr::meta_range_t hackrf_sink_c::get_sample_rates()
 {
   return hackrf_common::get_sample_rates();
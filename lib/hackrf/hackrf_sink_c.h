@@ -29,7 +29,9 @@
 #include <libhackrf/hackrf.h>
 
 #include "sink_iface.h"
+#include "direct_block.h"
 #include "hackrf_common.h"
+#include "stats_helpers.h"
 
 class hackrf_sink_c;
 
@@ -67,7 +69,7 @@ typedef std::shared_ptr<hackrf_sink_c> hackrf_sink_c_sptr;
 hackrf_sink_c_sptr make_hackrf_sink_c (const std::string & args = "");
 
 class hackrf_sink_c :
-    public gr::sync_block,
+    public direct_block,
     public sink_iface,
     protected hackrf_common
 {
@@ -91,6 +93,7 @@ public:
   static std::vector< std::string > get_devices();
 
   size_t get_num_channels( void );
+  std::map< std::string, double > get_stats( size_t chan = 0 );
 
   osmosdr::meta_range_t get_sample_rates( void );
   double set_sample_rate( double rate );
@@ -127,6 +130,7 @@ private:
   static int _hackrf_tx_callback(hackrf_transfer* transfer);
   int hackrf_tx_callback(unsigned char *buffer, uint32_t length);
 
+  size_t _item_size; /* complex float, int16 or int8 */
   circular_buffer_t _cbuf;
   int8_t *_buf;
   unsigned int _buf_num;
@@ -136,6 +140,10 @@ private:
   std::condition_variable _buf_cond;
 
   double _vga_gain;
+
+  std::atomic<uint64_t> _underflows{0};
+  fifo_arrivals _queued; /* of the buffers in _cbuf */
+  stream_stats _stats;
 };
 
 #endif /* INCLUDED_HACKRF_SINK_C_H */
@@ -31,12 +31,20 @@
 #include <stdexcept>
 #include <iostream>
 #include <chrono>
+#include <cstring>
 
 #include <gnuradio/io_signature.h>
 
+#include <pmt/pmt.h>
+
 #include "hackrf_source_c.h"
 
 #include "arg_helpers.h"
+#include "convert_helpers.h"
+
+static const pmt::pmt_t RX_FREQ_KEY = pmt::string_to_symbol("rx_freq");
+static const pmt::pmt_t RX_DROPPED_KEY = pmt::string_to_symbol("rx_dropped");
+static const pmt::pmt_t RX_TIME_KEY = pmt::string_to_symbol("rx_time");
 
 hackrf_source_c_sptr make_hackrf_source_c (const std::string & args)
 {
@@ -61,16 +69,24 @@ static const int MAX_OUT = 1;	// maximum number of output streams
  * The private constructor
  */
 hackrf_source_c::hackrf_source_c (const std::string &args)
-  : gr::sync_block ("hackrf_source_c",
+  : direct_block ("hackrf_source_c",
         gr::io_signature::make(MIN_IN, MAX_IN, sizeof (gr_complex)),
-        gr::io_signature::make(MIN_OUT, MAX_OUT, sizeof (gr_complex))),
+        gr::io_signature::make(MIN_OUT, MAX_OUT, args_to_item_size(args))),
     hackrf_common::hackrf_common(args),
+    _item_size(args_to_item_size(args)),
     _buf(NULL),
     _lna_gain(0),
-    _vga_gain(0)
+    _vga_gain(0),
+    _settle_ms(0)
 {
   dict_t dict = params_to_dict(args);
 
+  if (dict.count("settle_ms"))
+    _settle_ms = std::stod(dict["settle_ms"]);
+
+  _clock.set_tag_period( dict.count("time_period") ? std::stod(dict["time_period"]) : 1.0 );
+  _sched.set( dict );
+
   _buf_num = _buf_len = _buf_head = _buf_used = _buf_offset = 0;
 
   if (dict.count("buffers"))
@@ -86,6 +102,9 @@ hackrf_source_c::hackrf_source_c (const std::string &args)
     _buf_len = BUF_LEN;
 
   _samp_avail = _buf_len / BYTES_PER_SAMPLE;
+  _buf_mark.resize( _buf_num );
+  _buf_time.resize( _buf_num );
+  _buf_count.resize( _buf_num );
 
   // create a lookup table for gr_complex values
   for (unsigned int i = 0; i <= 0xff; i++) {
@@ -114,9 +133,15 @@ hackrf_source_c::hackrf_source_c (const std::string &args)
 
   _buf = (unsigned char **) malloc(_buf_num * sizeof(unsigned char *));
 
+  /* all buffers in one piece of the pool */
+  unsigned char *mem = (unsigned char *)
+      buffer_pool::get().alloc( _buf_num * _buf_len, args_to_numa_node( dict ) );
+  if ( !mem )
+    throw std::runtime_error("Failed to allocate sample buffers.");
+
   if (_buf) {
     for(unsigned int i = 0; i < _buf_num; ++i)
-      _buf[i] = (unsigned char *) malloc(_buf_len);
+      _buf[i] = mem + i * _buf_len;
   }
 }
 
@@ -126,9 +151,7 @@ hackrf_source_c::hackrf_source_c (const std::string &args)
 hackrf_source_c::~hackrf_source_c ()
 {
   if (_buf) {
-    for(unsigned int i = 0; i < _buf_num; ++i) {
-      free(_buf[i]);
-    }
+    buffer_pool::get().release( _buf[0] );
 
     free(_buf);
     _buf = NULL;
@@ -143,18 +166,34 @@ int hackrf_source_c::_hackrf_rx_callback(hackrf_transfer *transfer)
 
 int hackrf_source_c::hackrf_rx_callback(unsigned char *buf, uint32_t len)
 {
+  _sched.apply_once( "hackrf rx callback" );
+
+  uint64_t now = _stats.arrival();
+  uint64_t count = _clock.arrival( len / BYTES_PER_SAMPLE );
+
   {
     std::lock_guard<std::mutex> lock(_buf_mutex);
 
+    retune_mark mark = _retune.transfer( len / BYTES_PER_SAMPLE );
+    if (mark.skip * BYTES_PER_SAMPLE == len)
+      return 0; /* still settling */
+
     int buf_tail = (_buf_head + _buf_used) % _buf_num;
     memcpy(_buf[buf_tail], buf, len);
+    _buf_mark[buf_tail] = mark;
+    _buf_time[buf_tail] = now;
+    _buf_count[buf_tail] = count;
 
     if (_buf_used == _buf_num) {
+      _overflows++;
       std::cerr << "O" << std::flush;
       _buf_head = (_buf_head + 1) % _buf_num;
     } else {
       _buf_used++;
     }
+
+    _stats.fill(_buf_used * (_buf_len / BYTES_PER_SAMPLE),
+                _buf_num * (_buf_len / BYTES_PER_SAMPLE));
   }
 
   _buf_cond.notify_one();
@@ -167,6 +206,14 @@ bool hackrf_source_c::start()
   if ( ! _dev.get() )
     return false;
 
+  {
+    /* the first sample carries the frequency we start on */
+    std::lock_guard<std::mutex> lock(_buf_mutex);
+    _retune.arm( get_center_freq(), get_sample_rate(), 0 );
+  }
+
+  _clock.reset( get_sample_rate() );
+
   hackrf_common::start();
   int ret = hackrf_start_rx( _dev.get(), _hackrf_rx_callback, (void *)this );
   if ( ret != HACKRF_SUCCESS ) {
@@ -194,7 +241,7 @@ int hackrf_source_c::work( int noutput_items,
                         gr_vector_const_void_star &input_items,
                         gr_vector_void_star &output_items )
 {
-  gr_complex *out = (gr_complex *)output_items[0];
+  uint8_t *out = (uint8_t *)output_items[0];
 
   bool running = false;
 
@@ -218,38 +265,80 @@ int hackrf_source_c::work( int noutput_items,
   if ( ! running )
     return WORK_DONE;
 
-  const uint8_t *buf = _buf[_buf_head] + _buf_offset * BYTES_PER_SAMPLE;
 #define TO_COMPLEX(p) gr_complex( _lut[(p)[0]], _lut[(p)[1]] )
 
-  if (noutput_items <= _samp_avail) {
-    for (int i = 0; i < noutput_items; ++i)
-      *out++ = TO_COMPLEX( buf + i*BYTES_PER_SAMPLE );
-
-    _buf_offset += noutput_items;
-    _samp_avail -= noutput_items;
-  } else {
-    for (int i = 0; i < _samp_avail; ++i)
-      *out++ = TO_COMPLEX( buf + i*BYTES_PER_SAMPLE );
+  int remaining = noutput_items;
+
+  while (remaining) {
+    if (!_buf_offset) {
+      retune_mark mark;
+      uint64_t count;
+      {
+        std::lock_guard<std::mutex> lock(_buf_mutex);
+        mark = _buf_mark[_buf_head];
+        _buf_mark[_buf_head].valid = false;
+        count = _buf_count[_buf_head];
+        _stats.taken(_buf_time[_buf_head]);
+      }
+
+      uint64_t offset = nitems_written(0) + (noutput_items - remaining);
+
+      if (mark.valid) {
+        add_item_tag(0, offset, RX_FREQ_KEY, pmt::from_double(mark.freq));
+        if (mark.dropped)
+          add_item_tag(0, offset, RX_DROPPED_KEY, pmt::from_uint64(mark.dropped));
+
+        _buf_offset = mark.skip;
+        _samp_avail -= mark.skip;
+      }
+
+      /* trimmed settling samples are a gap as well */
+      if (_clock.tag_due(count, _buf_len / BYTES_PER_SAMPLE) || _buf_offset)
+        add_item_tag(0, offset, RX_TIME_KEY,
+                     time_to_pmt(_clock.time_of(count + _buf_offset)));
+    }
 
-    {
-      std::lock_guard<std::mutex> lock(_buf_mutex);
+    const uint8_t *buf = _buf[_buf_head] + _buf_offset * BYTES_PER_SAMPLE;
+    const int nout = std::min(remaining, _samp_avail);
 
-      _buf_head = (_buf_head + 1) % _buf_num;
-      _buf_used--;
+    if (_item_size == sizeof(gr_complex)) {
+      gr_complex *cout = (gr_complex *)out;
+      for (int i = 0; i < nout; ++i)
+        cout[i] = TO_COMPLEX( buf + i*BYTES_PER_SAMPLE );
+    } else if (_item_size == 2 * sizeof(int16_t)) {
+      convert_8i_to_16i( (const int8_t *)buf, (int16_t *)out, 2 * nout, 8 );
+    } else {
+      memcpy( out, buf, nout * BYTES_PER_SAMPLE ); /* the device format */
     }
+    out += nout * _item_size;
 
-    buf = _buf[_buf_head];
+    remaining -= nout;
+    _samp_avail -= nout;
 
-    int remaining = noutput_items - _samp_avail;
+    if (!_samp_avail) {
+      bool more;
+      {
+        std::lock_guard<std::mutex> lock(_buf_mutex);
 
-    for (int i = 0; i < remaining; ++i)
-      *out++ = TO_COMPLEX( buf + i*BYTES_PER_SAMPLE );
+        _buf_head = (_buf_head + 1) % _buf_num;
+        _buf_used--;
+        more = _buf_used > 0;
 
-    _buf_offset = remaining;
-    _samp_avail = (_buf_len / BYTES_PER_SAMPLE) - remaining;
+        _stats.fill(_buf_used * (_buf_len / BYTES_PER_SAMPLE),
+                    _buf_num * (_buf_len / BYTES_PER_SAMPLE));
+      }
+      _samp_avail = _buf_len / BYTES_PER_SAMPLE;
+      _buf_offset = 0;
+
+      /* only hand out what has been received */
+      if (!more)
+        break;
+    } else {
+      _buf_offset += nout;
+    }
   }
 
-  return noutput_items;
+  return noutput_items - remaining;
 }
 
 std::vector<std::string> hackrf_source_c::get_devices()
@@ -262,6 +351,20 @@ size_t hackrf_source_c::get_num_channels()
   return 1;
 }
 
+uint64_t hackrf_source_c::get_overflows()
+{
+  return _overflows;
+}
+
+std::map<std::string, double> hackrf_source_c::get_stats( size_t chan )
+{
+  std::map<std::string, double> stats;
+  _stats.report( stats );
+  _sched.report( stats );
+
+  return stats;
+}
+
 osmosdr::meta_range_t hackrf_source_c::get_sample_rates()
 {
   return hackrf_common::get_sample_rates();
@@ -269,7 +372,11 @@ osmosdr::meta_range_t hackrf_source_c::get_sample_rates()
 
 double hackrf_source_c::set_sample_rate( double rate )
 {
-  return hackrf_common::set_sample_rate(rate);
+  double actual = hackrf_common::set_sample_rate(rate);
+
+  _clock.set_rate( actual );
+
+  return actual;
 }
 
 double hackrf_source_c::get_sample_rate()
@@ -284,7 +391,14 @@ osmosdr::freq_range_t hackrf_source_c::get_freq_range( size_t chan )
 
 double hackrf_source_c::set_center_freq( double freq, size_t chan )
 {
-  return hackrf_common::set_center_freq(freq, chan);
+  double actual = hackrf_common::set_center_freq(freq, chan);
+
+  {
+    std::lock_guard<std::mutex> lock(_buf_mutex);
+    _retune.arm( actual, get_sample_rate(), _settle_ms );
+  }
+
+  return actual;
 }
 
 double hackrf_source_c::get_center_freq( size_t chan )
@@ -450,3 +564,13 @@ osmosdr::freq_range_t hackrf_source_c::get_bandwidth_range( size_t chan )
 {
   return hackrf_common::get_bandwidth_range(chan);
 }
+
+::osmosdr::time_spec_t hackrf_source_c::get_time_now( size_t mboard )
+{
+  return _clock.now();
+}
+
+void hackrf_source_c::set_time_now( const ::osmosdr::time_spec_t &time_spec, size_t mboard )
+{
+  _clock.set_time( time_spec );
+}
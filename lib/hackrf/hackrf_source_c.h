@@ -24,12 +24,19 @@
 #include <gnuradio/sync_block.h>
 
 #include <condition_variable>
+#include <atomic>
 #include <mutex>
 
 #include <libhackrf/hackrf.h>
 
 #include "source_iface.h"
+#include "direct_block.h"
 #include "hackrf_common.h"
+#include "retune_helpers.h"
+#include "stats_helpers.h"
+#include "time_helpers.h"
+#include "sched_helpers.h"
+#include "pool_helpers.h"
 
 class hackrf_source_c;
 
@@ -60,7 +67,7 @@ hackrf_source_c_sptr make_hackrf_source_c (const std::string & args = "");
  * \ingroup block
  */
 class hackrf_source_c :
-    public gr::sync_block,
+    public direct_block,
     public source_iface,
     protected hackrf_common
 {
@@ -87,6 +94,8 @@ public:
   static std::vector< std::string > get_devices();
 
   size_t get_num_channels( void );
+  uint64_t get_overflows( void );
+  std::map< std::string, double > get_stats( size_t chan = 0 );
 
   osmosdr::meta_range_t get_sample_rates( void );
   double set_sample_rate( double rate );
@@ -119,11 +128,15 @@ public:
   double get_bandwidth( size_t chan = 0 );
   osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 );
 
+  ::osmosdr::time_spec_t get_time_now( size_t mboard = 0 );
+  void set_time_now( const ::osmosdr::time_spec_t &time_spec, size_t mboard = 0 );
+
 private:
   static int _hackrf_rx_callback(hackrf_transfer* transfer);
   int hackrf_rx_callback(unsigned char *buf, uint32_t len);
 
   std::vector<float> _lut;
+  size_t _item_size; /* complex float, int16 or int8 */
 
   unsigned char **_buf;
   unsigned int _buf_num;
@@ -138,6 +151,20 @@ private:
 
   double _lna_gain;
   double _vga_gain;
+
+  std::vector<retune_mark> _buf_mark;
+  retune_tracker _retune;
+  double _settle_ms;
+
+  std::atomic<uint64_t> _overflows{0};
+
+  std::vector<uint64_t> _buf_time; /* arrival of each buffer */
+  stream_stats _stats;
+
+  std::vector<uint64_t> _buf_count; /* sample count of each buffer */
+  host_clock _clock;
+
+  io_sched _sched;
 };
 
 #endif /* INCLUDED_HACKRF_SOURCE_C_H */
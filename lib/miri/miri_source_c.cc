@@ -38,9 +38,12 @@
 #include <iostream>
 #include <stdio.h>
 
+static const pmt::pmt_t RX_TIME_KEY = pmt::string_to_symbol("rx_time");
+
 #include <mirisdr.h>
 
 #include "arg_helpers.h"
+#include "convert_helpers.h"
 
 using namespace boost::assign;
 
@@ -51,6 +54,15 @@ using namespace boost::assign;
 #define BYTES_PER_SAMPLE  4 // mirisdr device delivers 16 bit signed IQ data
                             // containing 12 bits of information
 
+/* short names for the libmirisdr transfer formats, the packed ones
+ * reduce the USB bandwidth and are unpacked by the library */
+static const char *miri_format_names[][2] = {
+  { "8",    "504_S8"  },
+  { "10+2", "384_S16" },
+  { "12",   "336_S16" },
+  { "14",   "252_S16" },
+};
+
 /*
  * Create a new instance of miri_source_c and return
  * a boost shared_ptr.  This is effectively the public constructor.
@@ -79,10 +91,12 @@ static const int MAX_OUT = 1;	// maximum number of output streams
  * The private constructor
  */
 miri_source_c::miri_source_c (const std::string &args)
-  : gr::sync_block ("miri_source_c",
+  : direct_block ("miri_source_c",
         gr::io_signature::make(MIN_IN, MAX_IN, sizeof (gr_complex)),
         gr::io_signature::make(MIN_OUT, MAX_OUT, sizeof (gr_complex))),
     _running(true),
+    _bytes_per_sample(BYTES_PER_SAMPLE),
+    _scale(1.0f/4096.0f),
     _auto_gain(false),
     _skipped(0)
 {
@@ -95,7 +109,6 @@ miri_source_c::miri_source_c (const std::string &args)
     dev_index = boost::lexical_cast< unsigned int >( dict["miri"] );
 
   _buf_num = _buf_head = _buf_used = _buf_offset = 0;
-  _samp_avail = BUF_SIZE / BYTES_PER_SAMPLE;
 
   if (dict.count("buffers"))
     _buf_num = boost::lexical_cast< unsigned int >( dict["buffers"] );
@@ -103,6 +116,13 @@ miri_source_c::miri_source_c (const std::string &args)
   if (0 == _buf_num)
     _buf_num = BUF_NUM;
 
+  if (dict.count("time_period"))
+    _clock.set_tag_period( boost::lexical_cast< double >( dict["time_period"] ) );
+  else
+    _clock.set_tag_period( 1.0 );
+
+  _sched.set( dict );
+
   if ( BUF_NUM != _buf_num ) {
     std::cerr << "Using " << _buf_num << " buffers of size " << BUF_SIZE << "."
               << std::endl;
@@ -119,6 +139,30 @@ miri_source_c::miri_source_c (const std::string &args)
   ret = mirisdr_open( &_dev, dev_index );
   if (ret < 0)
     throw std::runtime_error("Failed to open mirisdr device.");
+
+  if (dict.count("format")) {
+    std::string format = dict["format"];
+
+    for (size_t i = 0; i < sizeof(miri_format_names) / sizeof(miri_format_names[0]); i++)
+      if (format == miri_format_names[i][0])
+        format = miri_format_names[i][1];
+
+    ret = mirisdr_set_sample_format( _dev, (char *)format.c_str() );
+    if (ret < 0)
+      throw std::runtime_error("Failed to set sample format '" + format + "'.");
+
+    std::cerr << "Using sample format " << format << std::endl;
+
+    /* only the 8 bit format is delivered as bytes, everything else
+     * gets expanded to 16 bit by the library */
+    if (format == "504_S8") {
+      _bytes_per_sample = 2;
+      _scale = 1.0f/128.0f;
+    } else if (format == "252_S16") {
+      /* 14 bits of information, the others carry 12 */
+      _scale = 1.0f/8192.0f;
+    }
+  }
 #if 0
   ret = mirisdr_set_sample_rate( _dev, 500000 );
   if (ret < 0)
@@ -134,12 +178,22 @@ miri_source_c::miri_source_c (const std::string &args)
 
   _buf = (unsigned short **) malloc(_buf_num * sizeof(unsigned short *));
   _buf_lens = (unsigned int *) malloc(_buf_num * sizeof(unsigned int));
+  _buf_time.resize(_buf_num);
+  _buf_count.resize(_buf_num);
+
+  /* all buffers in one piece of the pool */
+  unsigned char *mem = (unsigned char *)
+      buffer_pool::get().alloc( _buf_num * BUF_SIZE, args_to_numa_node( dict ) );
+  if ( !mem )
+    throw std::runtime_error("Failed to allocate sample buffers.");
 
   if (_buf && _buf_lens) {
     for(unsigned int i = 0; i < _buf_num; ++i)
-      _buf[i] = (unsigned short *) malloc(BUF_SIZE);
+      _buf[i] = (unsigned short *) ( mem + i * BUF_SIZE );
   }
 
+  _clock.reset( get_sample_rate() );
+
   _thread = gr::thread::thread(_mirisdr_wait, this);
 }
 
@@ -157,9 +211,7 @@ miri_source_c::~miri_source_c ()
   }
 
   if (_buf) {
-    for(unsigned int i = 0; i < _buf_num; ++i) {
-      free(_buf[i]);
-    }
+    buffer_pool::get().release( _buf[0] );
 
     free(_buf);
     _buf = NULL;
@@ -181,6 +233,9 @@ void miri_source_c::mirisdr_callback(unsigned char *buf, uint32_t len)
     return;
   }
 
+  uint64_t now = _stats.arrival();
+  uint64_t count = _clock.arrival( len / _bytes_per_sample );
+
   {
     std::lock_guard<std::mutex> lock( _buf_mutex );
 
@@ -190,13 +245,20 @@ void miri_source_c::mirisdr_callback(unsigned char *buf, uint32_t len)
     int buf_tail = (_buf_head + _buf_used) % _buf_num;
     memcpy(_buf[buf_tail], buf, len);
     _buf_lens[buf_tail] = len;
+    _buf_time[buf_tail] = now;
+    _buf_count[buf_tail] = count;
 
     if (_buf_used == _buf_num) {
+      _overflows++;
       std::cerr << "O" << std::flush;
       _buf_head = (_buf_head + 1) % _buf_num;
     } else {
       _buf_used++;
     }
+
+    /* counted in full transfers, they rarely come shorter */
+    _stats.fill(_buf_used * (BUF_SIZE / _bytes_per_sample),
+                _buf_num * (BUF_SIZE / _bytes_per_sample));
   }
 
   _buf_cond.notify_one();
@@ -209,6 +271,8 @@ void miri_source_c::_mirisdr_wait(miri_source_c *obj)
 
 void miri_source_c::mirisdr_wait()
 {
+  _sched.apply( "miri rx thread" );
+
   int ret = mirisdr_read_async( _dev, _mirisdr_callback, (void *)this, _buf_num, BUF_SIZE );
 
   _running = false;
@@ -224,51 +288,60 @@ int miri_source_c::work( int noutput_items,
                         gr_vector_void_star &output_items )
 {
   gr_complex *out = (gr_complex *)output_items[0];
+  unsigned int buf_used;
 
   {
     std::unique_lock<std::mutex> lock( _buf_mutex );
 
-    while (_buf_used < 3 && _running) // collect at least 3 buffers
+    while (!_buf_used && _running)
       _buf_cond.wait( lock );
+
+    buf_used = _buf_used;
   }
 
   if (!_running)
     return WORK_DONE;
 
-  short *buf = (short *)_buf[_buf_head] + _buf_offset;
-
-  if (noutput_items <= _samp_avail) {
-    for (int i = 0; i < noutput_items; i++)
-      *out++ = gr_complex( float(*(buf + i * 2 + 0)) * (1.0f/4096.0f),
-                           float(*(buf + i * 2 + 1)) * (1.0f/4096.0f) );
+  while (noutput_items && buf_used) {
+    if (!_buf_offset) {
+      _stats.taken(_buf_time[_buf_head]);
 
-    _buf_offset += noutput_items * 2;
-    _samp_avail -= noutput_items;
-  } else {
-    for (int i = 0; i < _samp_avail; i++)
-      *out++ = gr_complex( float(*(buf + i * 2 + 0)) * (1.0f/4096.0f),
-                           float(*(buf + i * 2 + 1)) * (1.0f/4096.0f) );
+      uint64_t count = _buf_count[_buf_head];
+      if (_clock.tag_due(count, _buf_lens[_buf_head] / _bytes_per_sample))
+        add_item_tag(0, nitems_written(0) + (out - (gr_complex *)output_items[0]),
+                     RX_TIME_KEY, time_to_pmt(_clock.time_of(count)));
+    }
 
-    {
-      std::lock_guard<std::mutex> lock( _buf_mutex );
+    const unsigned int samp_avail = _buf_lens[_buf_head] / _bytes_per_sample - _buf_offset;
+    const int nout = std::min(noutput_items, int(samp_avail));
+    const unsigned char *buf = (unsigned char *)_buf[_buf_head] + _buf_offset * _bytes_per_sample;
 
-      _buf_head = (_buf_head + 1) % _buf_num;
-      _buf_used--;
-    }
+    if (_bytes_per_sample == 2)
+      convert_8i_to_32f( (const int8_t *)buf, (float *)out, nout * 2, _scale );
+    else
+      convert_16i_to_32f( (const int16_t *)buf, (float *)out, nout * 2, _scale );
 
-    buf = (short *)_buf[_buf_head];
+    out += nout;
+    noutput_items -= nout;
 
-    int remaining = noutput_items - _samp_avail;
+    if ((unsigned int)nout == samp_avail) {
+      {
+        std::lock_guard<std::mutex> lock( _buf_mutex );
 
-    for (int i = 0; i < remaining; i++)
-      *out++ = gr_complex( float(*(buf + i * 2 + 0)) * (1.0f/4096.0f),
-                           float(*(buf + i * 2 + 1)) * (1.0f/4096.0f) );
+        _buf_head = (_buf_head + 1) % _buf_num;
+        _buf_used--;
 
-    _buf_offset = remaining * 2;
-    _samp_avail = (_buf_lens[_buf_head] / BYTES_PER_SAMPLE) - remaining;
+        _stats.fill(_buf_used * (BUF_SIZE / _bytes_per_sample),
+                    _buf_num * (BUF_SIZE / _bytes_per_sample));
+      }
+      buf_used--;
+      _buf_offset = 0;
+    } else {
+      _buf_offset += nout;
+    }
   }
 
-  return noutput_items;
+  return (out - ((gr_complex *)output_items[0]));
 }
 
 std::vector<std::string> miri_source_c::get_devices()
@@ -289,6 +362,20 @@ size_t miri_source_c::get_num_channels()
   return 1;
 }
 
+uint64_t miri_source_c::get_overflows()
+{
+  return _overflows;
+}
+
+std::map<std::string, double> miri_source_c::get_stats( size_t chan )
+{
+  std::map<std::string, double> stats;
+  _stats.report( stats );
+  _sched.report( stats );
+
+  return stats;
+}
+
 osmosdr::meta_range_t miri_source_c::get_sample_rates()
 {
   osmosdr::meta_range_t range;
@@ -302,6 +389,7 @@ double miri_source_c::set_sample_rate(double rate)
 {
   if (_dev) {
     mirisdr_set_sample_rate( _dev, (uint32_t)rate );
+    _clock.set_rate( get_sample_rate() );
   }
 
   return get_sample_rate();
@@ -449,3 +537,13 @@ std::string miri_source_c::get_antenna( size_t chan )
 {
   return "RX";
 }
+
+::osmosdr::time_spec_t miri_source_c::get_time_now( size_t mboard )
+{
+  return _clock.now();
+}
+
+void miri_source_c::set_time_now( const ::osmosdr::time_spec_t &time_spec, size_t mboard )
+{
+  _clock.set_time( time_spec );
+}
@@ -24,10 +24,16 @@
 
 #include <gnuradio/thread/thread.h>
 
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 
 #include "source_iface.h"
+#include "direct_block.h"
+#include "stats_helpers.h"
+#include "time_helpers.h"
+#include "sched_helpers.h"
+#include "pool_helpers.h"
 
 class miri_source_c;
 typedef struct mirisdr_dev mirisdr_dev_t;
@@ -48,7 +54,7 @@ miri_source_c_sptr make_miri_source_c (const std::string & args = "");
  * \ingroup block
  */
 class miri_source_c :
-    public gr::sync_block,
+    public direct_block,
     public source_iface
 {
 private:
@@ -72,6 +78,8 @@ private:
   static std::vector< std::string > get_devices();
 
   size_t get_num_channels( void );
+  uint64_t get_overflows( void );
+  std::map< std::string, double > get_stats( size_t chan = 0 );
 
   osmosdr::meta_range_t get_sample_rates( void );
   double set_sample_rate( double rate );
@@ -97,6 +105,9 @@ private:
   std::string set_antenna( const std::string & antenna, size_t chan = 0 );
   std::string get_antenna( size_t chan = 0 );
 
+  ::osmosdr::time_spec_t get_time_now( size_t mboard = 0 );
+  void set_time_now( const ::osmosdr::time_spec_t &time_spec, size_t mboard = 0 );
+
 private:
   static void _mirisdr_callback(unsigned char *buf, uint32_t len, void *ctx);
   void mirisdr_callback(unsigned char *buf, uint32_t len);
@@ -115,10 +126,21 @@ private:
   bool _running;
 
   unsigned int _buf_offset;
-  int _samp_avail;
+  unsigned int _bytes_per_sample;
+  float _scale;
 
   bool _auto_gain;
   unsigned int _skipped;
+
+  std::atomic<uint64_t> _overflows{0};
+
+  std::vector<uint64_t> _buf_time; /* arrival of each buffer */
+  stream_stats _stats;
+
+  std::vector<uint64_t> _buf_count; /* sample count of each buffer */
+  host_clock _clock;
+
+  io_sched _sched;
 };
 
 #endif /* INCLUDED_MIRI_SOURCE_C_H */
@@ -0,0 +1,302 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef OSMOSDR_POOL_HELPERS_H
+#define OSMOSDR_POOL_HELPERS_H
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <volk/volk.h>
+
+#include "arg_helpers.h"
+
+/* size of the huge pages tried for large buffers */
+#define BUFFER_POOL_HUGE_PAGE ( 2 * 1024 * 1024 )
+
+/* buffers from this size on get rounded up to huge pages */
+#define BUFFER_POOL_HUGE_MIN ( 1024 * 1024 )
+
+/* released buffers kept for reuse at most, in bytes */
+#define BUFFER_POOL_KEEP ( 256 * 1024 * 1024 )
+
+/* highest NUMA node a buffer can be placed on, plus one */
+#define BUFFER_POOL_MAX_NODES 1024
+
+/*
+ * Memory for the sample rings of the backends, shared by all of them.
+ *
+ * Buffers of a megabyte and more are mapped from 2 MB huge pages if the
+ * system has some reserved, otherwise transparent huge pages are asked
+ * for. Every buffer is placed on the given NUMA node, locked and written
+ * once before it is handed out, so no page faults are left for the first
+ * transfers after start(). Released buffers are kept, faulted in, for the
+ * next request of the same size and node, up to BUFFER_POOL_KEEP bytes.
+ *
+ * Buffers are page aligned, more than any cache line or SIMD width. Where
+ * mmap() is missing they come from volk_malloc() and are only prefaulted.
+ */
+class buffer_pool
+{
+public:
+  /* never destroyed, blocks may release buffers during static destruction */
+  static buffer_pool &get( void )
+  {
+    static buffer_pool *pool = new buffer_pool();
+    return *pool;
+  }
+
+  /* bytes on node, -1 for any, NULL when out of memory */
+  void *alloc( size_t bytes, int node = -1 )
+  {
+    if ( node >= BUFFER_POOL_MAX_NODES )
+      throw std::runtime_error( "numa_node is out of range." );
+
+    size_t unit = bytes >= BUFFER_POOL_HUGE_MIN ? BUFFER_POOL_HUGE_PAGE : page_size();
+    size_t len = ( std::max( bytes, size_t(1) ) + unit - 1 ) / unit * unit;
+
+    std::lock_guard< std::mutex > lock( _mutex );
+
+    std::multimap< size_t, region >::iterator it = _free.find( len );
+    for ( ; it != _free.end() && it->first == len; ++it ) {
+      if ( it->second.node != node )
+        continue;
+
+      void *ptr = it->second.ptr;
+      _used[ ptr ] = it->second;
+      _kept -= len;
+      _free.erase( it );
+
+      return ptr;
+    }
+
+    region reg;
+    reg.len = len;
+    reg.node = node;
+    reg.ptr = map( len, node );
+    if ( !reg.ptr )
+      return NULL;
+
+    _used[ reg.ptr ] = reg;
+
+    return reg.ptr;
+  }
+
+  void release( void *ptr )
+  {
+    if ( !ptr )
+      return;
+
+    std::lock_guard< std::mutex > lock( _mutex );
+
+    std::map< void *, region >::iterator it = _used.find( ptr );
+    if ( it == _used.end() )
+      return;
+
+    region reg = it->second;
+    _used.erase( it );
+
+    if ( _kept + reg.len > BUFFER_POOL_KEEP ) {
+      unmap( reg );
+      return;
+    }
+
+    _free.insert( std::make_pair( reg.len, reg ) );
+    _kept += reg.len;
+  }
+
+private:
+  struct region
+  {
+    void *ptr;
+    size_t len;
+    int node;
+  };
+
+  buffer_pool()
+    : _kept( 0 ), _warned_lock( false ), _warned_node( false )
+  {
+  }
+
+  static size_t page_size( void )
+  {
+#ifdef __linux__
+    return size_t( sysconf( _SC_PAGESIZE ) );
+#else
+    return 4096;
+#endif
+  }
+
+  void *map( size_t len, int node )
+  {
+#ifdef __linux__
+    void *ptr = MAP_FAILED;
+
+    if ( len % BUFFER_POOL_HUGE_PAGE == 0 )
+      ptr = mmap( NULL, len, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+
+    if ( MAP_FAILED == ptr ) {
+      ptr = mmap( NULL, len, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+      if ( MAP_FAILED == ptr )
+        return NULL;
+
+#ifdef MADV_HUGEPAGE
+      if ( len % BUFFER_POOL_HUGE_PAGE == 0 )
+        madvise( ptr, len, MADV_HUGEPAGE );
+#endif
+    }
+
+    if ( node >= 0 ) {
+#ifdef SYS_mbind
+      const size_t bits = 8 * sizeof(unsigned long);
+      unsigned long mask[ BUFFER_POOL_MAX_NODES / bits ];
+      memset( mask, 0, sizeof(mask) );
+      mask[ node / bits ] |= 1UL << ( node % bits );
+
+      /* MPOL_PREFERRED, other nodes are used once the given one is full */
+      if ( syscall( SYS_mbind, ptr, len, 1, mask, BUFFER_POOL_MAX_NODES, 0 ) &&
+           !_warned_node ) {
+        std::cerr << "Could not place sample buffers on NUMA node " << node
+                  << " (" << strerror( errno ) << ")" << std::endl;
+        _warned_node = true;
+      }
+#endif
+    }
+
+    if ( mlock( ptr, len ) && !_warned_lock ) {
+      std::cerr << "Could not lock sample buffers in memory (" << strerror( errno )
+                << "), raise the memlock limit to avoid page faults" << std::endl;
+      _warned_lock = true;
+    }
+#else
+    void *ptr = volk_malloc( len, volk_get_alignment() );
+    if ( !ptr )
+      return NULL;
+#endif
+
+    /* fault every page in now, on the node of the policy */
+    memset( ptr, 0, len );
+
+    return ptr;
+  }
+
+  static void unmap( const region &reg )
+  {
+#ifdef __linux__
+    munmap( reg.ptr, reg.len );
+#else
+    volk_free( reg.ptr );
+#endif
+  }
+
+  std::mutex _mutex;
+  std::map< void *, region > _used;
+  std::multimap< size_t, region > _free;
+  size_t _kept;
+  bool _warned_lock;
+  bool _warned_node;
+};
+
+/* the numa_node= argument of a device, -1 when not given */
+inline int args_to_numa_node( const dict_t &dict )
+{
+  dict_t::const_iterator it = dict.find( "numa_node" );
+  if ( it == dict.end() )
+    return -1;
+
+  return boost::lexical_cast< int >( it->second );
+}
+
+/*
+ * Allocator taking buffer_pool memory, for containers holding a ring such
+ * as boost::circular_buffer.
+ */
+template < typename T >
+class pool_allocator
+{
+public:
+  typedef T value_type;
+  typedef T *pointer;
+  typedef const T *const_pointer;
+  typedef T &reference;
+  typedef const T &const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+
+  template < typename U >
+  struct rebind { typedef pool_allocator< U > other; };
+
+  pool_allocator( int node = -1 ) : _node( node ) {}
+
+  template < typename U >
+  pool_allocator( const pool_allocator< U > &other ) : _node( other.node() ) {}
+
+  int node( void ) const { return _node; }
+
+  T *allocate( size_t n, const void * = 0 )
+  {
+    void *ptr = buffer_pool::get().alloc( n * sizeof(T), _node );
+    if ( !ptr )
+      throw std::bad_alloc();
+
+    return static_cast< T * >( ptr );
+  }
+
+  void deallocate( T *ptr, size_t ) { buffer_pool::get().release( ptr ); }
+
+  size_t max_size( void ) const { return size_t( -1 ) / sizeof(T); }
+
+  T *address( T &x ) const { return &x; }
+  const T *address( const T &x ) const { return &x; }
+
+  template < typename U, typename... Args >
+  void construct( U *ptr, Args &&... args ) { ::new( (void *)ptr ) U( std::forward< Args >( args )... ); }
+
+  template < typename U >
+  void destroy( U *ptr ) { ptr->~U(); }
+
+  template < typename U >
+  bool operator==( const pool_allocator< U > &other ) const { return _node == other.node(); }
+
+  template < typename U >
+  bool operator!=( const pool_allocator< U > &other ) const { return _node != other.node(); }
+
+private:
+  int _node;
+};
+
+#endif // OSMOSDR_POOL_HELPERS_H
@@ -26,17 +26,8 @@ using namespace osmosdr;
 /***********************************************************************
  * range_t implementation code
  **********************************************************************/
-struct range_t::impl{
-    impl(double start, double stop, double step):
-        start(start), stop(stop), step(step)
-    {
-        /* NOP */
-    }
-    double start, stop, step;
-};
-
 range_t::range_t(double value):
-    _impl(OSMOSDR_PIMPL_MAKE(impl, (value, value, 0)))
+    _start(value), _stop(value), _step(0)
 {
     /* NOP */
 }
@@ -44,7 +35,7 @@ range_t::range_t(double value):
 range_t::range_t(
     double start, double stop, double step
 ):
-    _impl(OSMOSDR_PIMPL_MAKE(impl, (start, stop, step)))
+    _start(start), _stop(stop), _step(step)
 {
     if (stop < start){
         throw std::runtime_error("cannot make range where stop < start");
@@ -52,15 +43,15 @@ range_t::range_t(
 }
 
 double range_t::start(void) const{
-    return _impl->start;
+    return _start;
 }
 
 double range_t::stop(void) const{
-    return _impl->stop;
+    return _stop;
 }
 
 double range_t::step(void) const{
-    return _impl->step;
+    return _step;
 }
 
 const std::string range_t::to_pp_string(void) const{
@@ -86,71 +77,128 @@ void check_meta_range_monotonic(const meta_range_t &mr){
     }
 }
 
-meta_range_t::meta_range_t(void){
+meta_range_t::meta_range_t(void):
+    _data(NULL), _size(0), _start(0), _stop(0), _step(0)
+{
     /* NOP */
 }
 
 meta_range_t::meta_range_t(
     double start, double stop, double step
 ):
-    std::vector<range_t > (1, range_t(start, stop, step))
+    std::vector<range_t > (1, range_t(start, stop, step)),
+    _data(NULL), _size(0), _start(0), _stop(0), _step(0)
 {
     /* NOP */
 }
 
+meta_range_t::meta_range_t(const meta_range_t &other):
+    std::vector<range_t >(other),
+    _data(other.validated()? this->data() : NULL), _size(other._size),
+    _start(other._start), _stop(other._stop), _step(other._step)
+{
+    /* NOP */
+}
+
+meta_range_t::meta_range_t(meta_range_t &&other):
+    std::vector<range_t >(std::move(other)),
+    _data(other._data), _size(other._size),
+    _start(other._start), _stop(other._stop), _step(other._step)
+{
+    //the elements and with them the validation moved over
+    other._data = NULL;
+}
+
+meta_range_t &meta_range_t::operator=(const meta_range_t &other){
+    if (this != &other){
+        std::vector<range_t >::operator=(other);
+        _data = other.validated()? this->data() : NULL;
+        _size = other._size;
+        _start = other._start;
+        _stop = other._stop;
+        _step = other._step;
+    }
+    return *this;
+}
+
+meta_range_t &meta_range_t::operator=(meta_range_t &&other){
+    if (this != &other){
+        std::vector<range_t >::operator=(std::move(other));
+        _data = other._data;
+        _size = other._size;
+        _start = other._start;
+        _stop = other._stop;
+        _step = other._step;
+        other._data = NULL;
+    }
+    return *this;
+}
+
+bool meta_range_t::validated(void) const{
+    return _data != NULL && _data == this->data() && _size == this->size();
+}
+
+static double overall_step(const meta_range_t &mr){
+    //steps at each range and in-between ranges, the smallest one counts
+    double step = 0;
+    for (size_t i = 0; i < mr.size(); i++){
+        const range_t &r = mr[i];
+        if (r.step() > 0 && (step == 0 || r.step() < step)) step = r.step();
+        if (i == 0) continue;
+        double ibtw_step = r.start() - mr[i-1].stop();
+        if (ibtw_step > 0 && (step == 0 || ibtw_step < step)) step = ibtw_step;
+    }
+    return step;
+}
+
+void meta_range_t::validate(void){
+    _data = NULL;
+    check_meta_range_monotonic(*this);
+    //monotonic, so the first range starts lowest and the last stops highest
+    _start = this->front().start();
+    _stop = this->back().stop();
+    _step = overall_step(*this);
+    _data = this->data();
+    _size = this->size();
+}
+
 double meta_range_t::start(void) const{
+    if (validated()) return _start;
     check_meta_range_monotonic(*this);
-    double min_start = this->front().start();
-    for (const range_t &r : (*this)){
-        min_start = std::min(min_start, r.start());
-    }
-    return min_start;
+    return this->front().start();
 }
 
 double meta_range_t::stop(void) const{
+    if (validated()) return _stop;
     check_meta_range_monotonic(*this);
-    double max_stop = this->front().stop();
-    for (const range_t &r : (*this)){
-        max_stop = std::max(max_stop, r.stop());
-    }
-    return max_stop;
+    return this->back().stop();
 }
 
 double meta_range_t::step(void) const{
+    if (validated()) return _step;
     check_meta_range_monotonic(*this);
-    std::vector<double> non_zero_steps;
-    range_t last = this->front();
-    for (const range_t &r : (*this)){
-        //steps at each range
-        if (r.step() > 0) non_zero_steps.push_back(r.step());
-        //and steps in-between ranges
-        double ibtw_step = r.start() - last.stop();
-        if (ibtw_step > 0) non_zero_steps.push_back(ibtw_step);
-        //store ref to last
-        last = r;
-    }
-    if (non_zero_steps.empty()) return 0; //all zero steps, its zero...
-    return *std::min_element(non_zero_steps.begin(), non_zero_steps.end());
+    return overall_step(*this);
+}
+
+static bool stops_before(const range_t &r, double value){
+    return r.stop() < value;
 }
 
 double meta_range_t::clip(double value, bool clip_step) const{
-    check_meta_range_monotonic(*this);
-    double last_stop = this->front().stop();
-    for (const range_t &r : (*this)){
-        //in-between ranges, clip to nearest
-        if (value < r.start()){
-            return (std::abs(value - r.start()) < std::abs(value - last_stop))?
-                r.start() : last_stop;
-        }
-        //in this range, clip here
-        if (value <= r.stop()){
-            if (! clip_step || r.step() == 0) return value;
-            return boost::math::round((value - r.start())/r.step())*r.step() + r.start();
-        }
-        //continue on to the next range
-        last_stop = r.stop();
+    if (! validated()) check_meta_range_monotonic(*this);
+    //the stops ascend, find the first range reaching up to the value
+    const_iterator it = std::lower_bound(this->begin(), this->end(), value, stops_before);
+    if (it == this->end()) return this->back().stop();
+    const range_t &r = *it;
+    double last_stop = (it == this->begin())? r.stop() : (it - 1)->stop();
+    //in-between ranges, clip to nearest
+    if (value < r.start()){
+        return (std::abs(value - r.start()) < std::abs(value - last_stop))?
+            r.start() : last_stop;
     }
-    return last_stop;
+    //in this range, clip here
+    if (! clip_step || r.step() == 0) return value;
+    return boost::math::round((value - r.start())/r.step())*r.step() + r.start();
 }
 
 std::vector<double> meta_range_t::values() const {
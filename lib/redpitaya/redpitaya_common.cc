@@ -46,3 +46,61 @@ void redpitaya_send_command( SOCKET socket, uint32_t command )
     throw std::runtime_error( message.str() );
   }
 }
+
+void redpitaya_tune_socket( SOCKET socket, int rcvbuf, int sndbuf, bool nodelay )
+{
+  int flag = nodelay ? 1 : 0;
+
+  if ( rcvbuf > 0 )
+    setsockopt( socket, SOL_SOCKET, SO_RCVBUF, (const char *)&rcvbuf, sizeof(rcvbuf) );
+
+  if ( sndbuf > 0 )
+    setsockopt( socket, SOL_SOCKET, SO_SNDBUF, (const char *)&sndbuf, sizeof(sndbuf) );
+
+  setsockopt( socket, IPPROTO_TCP, TCP_NODELAY, (const char *)&flag, sizeof(flag) );
+}
+
+void redpitaya_quickack( SOCKET socket )
+{
+#ifdef TCP_QUICKACK
+  int flag = 1;
+  setsockopt( socket, IPPROTO_TCP, TCP_QUICKACK, &flag, sizeof(flag) );
+#endif
+}
+
+void redpitaya_set_nonblocking( SOCKET socket )
+{
+#if defined(_WIN32)
+  u_long mode = 1;
+  ioctlsocket( socket, FIONBIO, &mode );
+#else
+  int flags = fcntl( socket, F_GETFL, 0 );
+  fcntl( socket, F_SETFL, flags | O_NONBLOCK );
+#endif
+}
+
+bool redpitaya_would_block( void )
+{
+#if defined(_WIN32)
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+bool redpitaya_wait_socket( SOCKET socket, bool write, int timeout_ms )
+{
+  fd_set fds;
+  struct timeval tv;
+
+  FD_ZERO( &fds );
+  FD_SET( socket, &fds );
+
+  tv.tv_sec = timeout_ms / 1000;
+  tv.tv_usec = ( timeout_ms % 1000 ) * 1000;
+
+  if ( write )
+    return ::select( socket + 1, NULL, &fds, NULL, &tv ) > 0;
+
+  return ::select( socket + 1, &fds, NULL, NULL, &tv ) > 0;
+}
@@ -36,7 +36,9 @@
 #include <sys/socket.h>
 #include <sys/select.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
+#include <errno.h>
 #ifndef SOCKET
 #define SOCKET int
 #define INVSOC (-1)
@@ -51,4 +53,20 @@
 
 void redpitaya_send_command( SOCKET socket, uint32_t command );
 
+/* Apply the rcvbuf=, sndbuf= and nodelay= arguments to a sample socket.
+ * Non-positive buffer sizes keep the operating system default. */
+void redpitaya_tune_socket( SOCKET socket, int rcvbuf, int sndbuf, bool nodelay );
+
+/* TCP_QUICKACK is not sticky on Linux and has to be rearmed after each
+ * receive, this is a no-op on other platforms. */
+void redpitaya_quickack( SOCKET socket );
+
+void redpitaya_set_nonblocking( SOCKET socket );
+
+/* true if the last socket call failed only because it would have blocked */
+bool redpitaya_would_block( void );
+
+/* Wait up to timeout_ms for the socket to become readable or writable */
+bool redpitaya_wait_socket( SOCKET socket, bool write, int timeout_ms );
+
 #endif // REDPITAYA_COMMON_H
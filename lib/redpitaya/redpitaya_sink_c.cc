@@ -23,6 +23,10 @@
 #include <string>
 #include <sstream>
 #include <stdexcept>
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 
 #include <boost/assign.hpp>
 #include <boost/format.hpp>
@@ -36,21 +40,28 @@
 
 using namespace boost::assign;
 
+#define REDPITAYA_BUF_NUM 32
+#define REDPITAYA_BUF_LEN (64 * 1024)
+
 redpitaya_sink_c_sptr make_redpitaya_sink_c(const std::string &args)
 {
   return gnuradio::get_initial_sptr(new redpitaya_sink_c(args));
 }
 
 redpitaya_sink_c::redpitaya_sink_c(const std::string &args) :
-  gr::sync_block("redpitaya_sink_c",
-                 gr::io_signature::make(1, 1, sizeof(gr_complex)),
-                 gr::io_signature::make(0, 0, 0))
+  direct_block("redpitaya_sink_c",
+               gr::io_signature::make(1, 1, sizeof(gr_complex)),
+               gr::io_signature::make(0, 0, 0)),
+  _buf(pool_allocator< char >(args_to_numa_node(params_to_dict(args))))
 {
   std::string host = "192.168.1.100";
   std::stringstream message;
   unsigned short ptt = 0, port = 1001;
   struct sockaddr_in addr;
   uint32_t command;
+  size_t buf_num = REDPITAYA_BUF_NUM;
+  int sndbuf = 0;
+  bool nodelay = true;
 
 #if defined(_WIN32)
   WSADATA wsaData;
@@ -61,6 +72,13 @@ redpitaya_sink_c::redpitaya_sink_c(const std::string &args) :
   _rate = 1.0e5;
   _corr = 0.0;
 
+  _buf_head = _buf_used = 0;
+  _buf_len = REDPITAYA_BUF_LEN;
+  _running = false;
+  _failed = false;
+  _timeout_ms = 100;
+  _late = _short = 0;
+
   dict_t dict = params_to_dict( args );
 
   if ( dict.count( "redpitaya" ) )
@@ -78,12 +96,37 @@ redpitaya_sink_c::redpitaya_sink_c(const std::string &args) :
   if ( dict.count("ptt") )
     ptt = boost::lexical_cast< unsigned short >( dict["ptt"] );
 
+  if ( dict.count( "buffers" ) )
+    buf_num = boost::lexical_cast< size_t >( dict["buffers"] );
+
+  if ( dict.count( "buflen" ) )
+    _buf_len = boost::lexical_cast< size_t >( dict["buflen"] );
+
+  if ( dict.count( "sndbuf" ) )
+    sndbuf = boost::lexical_cast< int >( dict["sndbuf"] );
+
+  if ( dict.count( "nodelay" ) )
+    nodelay = boost::lexical_cast< int >( dict["nodelay"] ) != 0;
+
+  if ( dict.count( "timeout" ) )
+    _timeout_ms = boost::lexical_cast< int >( dict["timeout"] );
+
   if ( !host.length() )
     host = "192.168.1.100";
 
   if ( 0 == port )
     port = 1001;
 
+  /* keep every chunk a whole number of samples */
+  _buf_len -= _buf_len % sizeof(gr_complex);
+  if ( 0 == _buf_len )
+    _buf_len = REDPITAYA_BUF_LEN;
+
+  if ( 0 == buf_num )
+    buf_num = REDPITAYA_BUF_NUM;
+
+  _buf.resize( buf_num * _buf_len );
+
   for ( size_t i = 0; i < 2; ++i )
   {
     if ( ( _sockets[i] = socket( AF_INET, SOCK_STREAM, 0 ) ) < 0 )
@@ -91,6 +134,9 @@ redpitaya_sink_c::redpitaya_sink_c(const std::string &args) :
       throw std::runtime_error( "Could not create TCP socket." );
     }
 
+    if ( 1 == i )
+      redpitaya_tune_socket( _sockets[i], 0, sndbuf, nodelay );
+
     memset( &addr, 0, sizeof(addr) );
     addr.sin_family = AF_INET;
     inet_pton( AF_INET, host.c_str(), &addr.sin_addr );
@@ -108,10 +154,15 @@ redpitaya_sink_c::redpitaya_sink_c(const std::string &args) :
 
   command = ptt ? 2<<28 : 3<<28;
   redpitaya_send_command( _sockets[0], command );
+
+  redpitaya_set_nonblocking( _sockets[1] );
 }
 
 redpitaya_sink_c::~redpitaya_sink_c()
 {
+  if ( _thread.joinable() )
+    stop();
+
 #if defined(_WIN32)
   ::closesocket( _sockets[1] );
   ::closesocket( _sockets[0] );
@@ -122,26 +173,129 @@ redpitaya_sink_c::~redpitaya_sink_c()
 #endif
 }
 
-int redpitaya_sink_c::work( int noutput_items,
-                            gr_vector_const_void_star &input_items,
-                            gr_vector_void_star &output_items )
+bool redpitaya_sink_c::start()
 {
-  const gr_complex *in = (const gr_complex *)input_items[0];
+  {
+    std::lock_guard< std::mutex > lock( _buf_mutex );
+    _buf_head = _buf_used = 0;
+    _failed = false;
+    _running = true;
+  }
+
+  _thread = std::thread( &redpitaya_sink_c::tx_loop, this );
+
+  return true;
+}
+
+bool redpitaya_sink_c::stop()
+{
+  {
+    std::lock_guard< std::mutex > lock( _buf_mutex );
+    _running = false;
+  }
+  _buf_cond.notify_all();
+
+  /* the socket thread drains what is left in the ring before it exits */
+  if ( _thread.joinable() )
+    _thread.join();
+
+  if ( _late || _short )
+    std::cerr << "Red Pitaya Sink: " << _late << " late and "
+              << _short << " short writes" << std::endl;
+
+  return true;
+}
+
+void redpitaya_sink_c::tx_loop()
+{
+  while ( true )
+  {
+    size_t length;
+
+    {
+      std::unique_lock< std::mutex > lock( _buf_mutex );
+
+      while ( _running && 0 == _buf_used )
+        _buf_cond.wait( lock );
 
+      if ( 0 == _buf_used )
+        break;
+
+      length = std::min( _buf_used, _buf.size() - _buf_head );
+      length = std::min( length, _buf_len );
+    }
+
+    if ( !redpitaya_wait_socket( _sockets[1], true, 100 ) )
+    {
+      std::lock_guard< std::mutex > lock( _buf_mutex );
+      if ( !_running )
+        break;
+      continue;
+    }
+
+    /* the region at _buf_head stays untouched by work() until released */
 #if defined(_WIN32)
-  int size;
-  int total = sizeof(gr_complex) * noutput_items;
-  size = ::send( _sockets[1], (char *)in, total, 0 );
+    int size = ::send( _sockets[1], &_buf[_buf_head], (int)length, 0 );
 #else
-  ssize_t size;
-  ssize_t total = sizeof(gr_complex) * noutput_items;
-  size = ::send( _sockets[1], in, total, MSG_NOSIGNAL );
+    int size = ::send( _sockets[1], &_buf[_buf_head], length, MSG_NOSIGNAL );
 #endif
 
-  if ( size != total )
+    if ( size < 0 && redpitaya_would_block() )
+      continue;
+
+    if ( size <= 0 )
+    {
+      std::lock_guard< std::mutex > lock( _buf_mutex );
+      _failed = true;
+      _buf_cond.notify_all();
+      break;
+    }
+
+    {
+      std::lock_guard< std::mutex > lock( _buf_mutex );
+      _buf_head = ( _buf_head + size ) % _buf.size();
+      _buf_used -= size;
+    }
+    _buf_cond.notify_one();
+  }
+}
+
+int redpitaya_sink_c::work( int noutput_items,
+                            gr_vector_const_void_star &input_items,
+                            gr_vector_void_star &output_items )
+{
+  const char *in = (const char *)input_items[0];
+
+  std::unique_lock< std::mutex > lock( _buf_mutex );
+
+  if ( !_buf_cond.wait_for( lock, std::chrono::milliseconds( _timeout_ms ),
+                            [this] { return _failed || _buf.size() - _buf_used >= sizeof(gr_complex); } ) )
+  {
+    _late++;
+    return 0;
+  }
+
+  if ( _failed )
     throw std::runtime_error( "Sending samples failed." );
 
-  consume(0, noutput_items);
+  size_t space = ( _buf.size() - _buf_used ) / sizeof(gr_complex);
+  size_t items = std::min( space, (size_t)noutput_items );
+  size_t total = items * sizeof(gr_complex);
+
+  if ( items < (size_t)noutput_items )
+    _short++;
+
+  size_t tail = ( _buf_head + _buf_used ) % _buf.size();
+  size_t first = std::min( total, _buf.size() - tail );
+  memcpy( &_buf[tail], in, first );
+  memcpy( &_buf[0], in + first, total - first );
+
+  _buf_used += total;
+
+  lock.unlock();
+  _buf_cond.notify_one();
+
+  consume(0, items);
 
   return 0;
 }
@@ -170,6 +324,19 @@ size_t redpitaya_sink_c::get_num_channels( void )
   return 1;
 }
 
+std::map<std::string, double> redpitaya_sink_c::get_stats( size_t chan )
+{
+  std::map<std::string, double> stats;
+
+  std::lock_guard< std::mutex > lock( _buf_mutex );
+  stats["late_writes"] = double( _late );
+  stats["short_writes"] = double( _short );
+  stats["fill"] = double( _buf_used / sizeof(gr_complex) );
+  stats["capacity"] = double( _buf.size() / sizeof(gr_complex) );
+
+  return stats;
+}
+
 osmosdr::meta_range_t redpitaya_sink_c::get_sample_rates( void )
 {
   osmosdr::meta_range_t range;
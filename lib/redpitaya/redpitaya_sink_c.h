@@ -23,7 +23,14 @@
 
 #include <gnuradio/sync_block.h>
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "sink_iface.h"
+#include "direct_block.h"
+#include "pool_helpers.h"
 
 #include "redpitaya_common.h"
 
@@ -34,7 +41,7 @@ typedef std::shared_ptr< redpitaya_sink_c > redpitaya_sink_c_sptr;
 redpitaya_sink_c_sptr make_redpitaya_sink_c( const std::string & args = "" );
 
 class redpitaya_sink_c :
-    public gr::sync_block,
+    public direct_block,
     public sink_iface
 {
 private:
@@ -45,6 +52,9 @@ private:
 public:
   ~redpitaya_sink_c();
 
+  bool start();
+  bool stop();
+
   int work( int noutput_items,
             gr_vector_const_void_star &input_items,
             gr_vector_void_star &output_items );
@@ -55,6 +65,8 @@ public:
 
   size_t get_num_channels( void );
 
+  std::map< std::string, double > get_stats( size_t chan = 0 );
+
   osmosdr::meta_range_t get_sample_rates( void );
   double set_sample_rate( double rate );
   double get_sample_rate( void );
@@ -78,8 +90,27 @@ public:
   std::string get_antenna( size_t chan = 0 );
 
 private:
+  void tx_loop();
+
   double _freq, _rate, _corr;
   SOCKET _sockets[2];
+
+  std::thread _thread;
+  std::mutex _buf_mutex;
+  std::condition_variable _buf_cond;
+
+  /* byte ring between the socket thread and work() */
+  std::vector< char, pool_allocator< char > > _buf;
+  size_t _buf_head;
+  size_t _buf_used;
+  size_t _buf_len;
+
+  bool _running;
+  bool _failed;
+  int _timeout_ms;
+
+  unsigned long long _late;
+  unsigned long long _short;
 };
 
 #endif // REDPITAYA_SINK_C_H
@@ -23,6 +23,10 @@
 #include <string>
 #include <sstream>
 #include <stdexcept>
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 
 #include <boost/assign.hpp>
 #include <boost/format.hpp>
@@ -36,21 +40,28 @@
 
 using namespace boost::assign;
 
+#define REDPITAYA_BUF_NUM 32
+#define REDPITAYA_BUF_LEN (64 * 1024)
+
 redpitaya_source_c_sptr make_redpitaya_source_c(const std::string &args)
 {
   return gnuradio::get_initial_sptr(new redpitaya_source_c(args));
 }
 
 redpitaya_source_c::redpitaya_source_c(const std::string &args) :
-  gr::sync_block("redpitaya_source_c",
-                 gr::io_signature::make(0, 0, 0),
-                 gr::io_signature::make(1, 1, sizeof(gr_complex)))
+  direct_block("redpitaya_source_c",
+               gr::io_signature::make(0, 0, 0),
+               gr::io_signature::make(1, 1, sizeof(gr_complex))),
+  _buf(pool_allocator< char >(args_to_numa_node(params_to_dict(args))))
 {
   std::string host = "192.168.1.100";
   std::stringstream message;
   unsigned short port = 1001;
   struct sockaddr_in addr;
   uint32_t command;
+  size_t buf_num = REDPITAYA_BUF_NUM;
+  int rcvbuf = 0;
+  bool nodelay = true;
 
 #if defined(_WIN32)
   WSADATA wsaData;
@@ -61,6 +72,14 @@ redpitaya_source_c::redpitaya_source_c(const std::string &args) :
   _rate = 1.0e5;
   _corr = 0.0;
 
+  _buf_head = _buf_used = 0;
+  _buf_len = REDPITAYA_BUF_LEN;
+  _running = false;
+  _failed = false;
+  _quickack = false;
+  _timeout_ms = 100;
+  _late = _short = 0;
+
   dict_t dict = params_to_dict( args );
 
   if ( dict.count( "redpitaya" ) )
@@ -75,17 +94,49 @@ redpitaya_source_c::redpitaya_source_c(const std::string &args) :
       port = boost::lexical_cast< unsigned short >( tokens[1] );
   }
 
+  if ( dict.count( "buffers" ) )
+    buf_num = boost::lexical_cast< size_t >( dict["buffers"] );
+
+  if ( dict.count( "buflen" ) )
+    _buf_len = boost::lexical_cast< size_t >( dict["buflen"] );
+
+  if ( dict.count( "rcvbuf" ) )
+    rcvbuf = boost::lexical_cast< int >( dict["rcvbuf"] );
+
+  if ( dict.count( "nodelay" ) )
+    nodelay = boost::lexical_cast< int >( dict["nodelay"] ) != 0;
+
+  if ( dict.count( "quickack" ) )
+    _quickack = boost::lexical_cast< int >( dict["quickack"] ) != 0;
+
+  if ( dict.count( "timeout" ) )
+    _timeout_ms = boost::lexical_cast< int >( dict["timeout"] );
+
   if ( !host.length() )
     host = "192.168.1.100";
 
   if ( 0 == port )
     port = 1001;
 
+  /* keep every chunk a whole number of samples */
+  _buf_len -= _buf_len % sizeof(gr_complex);
+  if ( 0 == _buf_len )
+    _buf_len = REDPITAYA_BUF_LEN;
+
+  if ( 0 == buf_num )
+    buf_num = REDPITAYA_BUF_NUM;
+
+  _buf.resize( buf_num * _buf_len );
+
   for ( size_t i = 0; i < 2; ++i )
   {
     if ( ( _sockets[i] = socket( AF_INET, SOCK_STREAM, 0 ) ) < 0 )
       throw std::runtime_error( "Could not create TCP socket." );
 
+    /* the receive window is negotiated on connect */
+    if ( 1 == i )
+      redpitaya_tune_socket( _sockets[i], rcvbuf, 0, nodelay );
+
     memset( &addr, 0, sizeof(addr) );
     addr.sin_family = AF_INET;
     inet_pton( AF_INET, host.c_str(), &addr.sin_addr );
@@ -100,10 +151,15 @@ redpitaya_source_c::redpitaya_source_c(const std::string &args) :
     command = i;
     redpitaya_send_command( _sockets[i], command );
   }
+
+  redpitaya_set_nonblocking( _sockets[1] );
 }
 
 redpitaya_source_c::~redpitaya_source_c()
 {
+  if ( _thread.joinable() )
+    stop();
+
 #if defined(_WIN32)
   ::closesocket( _sockets[1] );
   ::closesocket( _sockets[0] );
@@ -114,26 +170,123 @@ redpitaya_source_c::~redpitaya_source_c()
 #endif
 }
 
+bool redpitaya_source_c::start()
+{
+  {
+    std::lock_guard< std::mutex > lock( _buf_mutex );
+    _buf_head = _buf_used = 0;
+    _failed = false;
+    _running = true;
+  }
+
+  _thread = std::thread( &redpitaya_source_c::rx_loop, this );
+
+  return true;
+}
+
+bool redpitaya_source_c::stop()
+{
+  {
+    std::lock_guard< std::mutex > lock( _buf_mutex );
+    _running = false;
+  }
+  _buf_cond.notify_all();
+
+  if ( _thread.joinable() )
+    _thread.join();
+
+  if ( _late || _short )
+    std::cerr << "Red Pitaya Source: " << _late << " late and "
+              << _short << " short reads" << std::endl;
+
+  return true;
+}
+
+void redpitaya_source_c::rx_loop()
+{
+  while ( true )
+  {
+    size_t tail, space;
+
+    {
+      std::unique_lock< std::mutex > lock( _buf_mutex );
+
+      /* a full ring pushes back on the server through the tcp window */
+      while ( _running && _buf_used == _buf.size() )
+        _buf_cond.wait( lock );
+
+      if ( !_running )
+        break;
+
+      tail = ( _buf_head + _buf_used ) % _buf.size();
+      space = std::min( _buf.size() - _buf_used, _buf.size() - tail );
+      space = std::min( space, _buf_len );
+    }
+
+    if ( !redpitaya_wait_socket( _sockets[1], false, 100 ) )
+      continue;
+
+    /* the region past _buf_used is owned by this thread until published */
+    int size = ::recv( _sockets[1], &_buf[tail], (int)space, 0 );
+
+    if ( size < 0 && redpitaya_would_block() )
+      continue;
+
+    if ( size <= 0 )
+    {
+      std::lock_guard< std::mutex > lock( _buf_mutex );
+      _failed = true;
+      _buf_cond.notify_all();
+      break;
+    }
+
+    if ( _quickack )
+      redpitaya_quickack( _sockets[1] );
+
+    {
+      std::lock_guard< std::mutex > lock( _buf_mutex );
+      _buf_used += size;
+    }
+    _buf_cond.notify_one();
+  }
+}
+
 int redpitaya_source_c::work( int noutput_items,
                               gr_vector_const_void_star &input_items,
                               gr_vector_void_star &output_items )
 {
-  gr_complex *out = (gr_complex *)output_items[0];
+  char *out = (char *)output_items[0];
 
-#if defined(_WIN32)
-  int size;
-  int total = sizeof(gr_complex) * noutput_items;
-  size = ::recv( _sockets[1], (char *)out, total, MSG_WAITALL );
-#else
-  ssize_t size;
-  ssize_t total = sizeof(gr_complex) * noutput_items;
-  size = ::recv( _sockets[1], out, total, MSG_WAITALL );
-#endif
+  std::unique_lock< std::mutex > lock( _buf_mutex );
+
+  if ( !_buf_cond.wait_for( lock, std::chrono::milliseconds( _timeout_ms ),
+                            [this] { return _failed || _buf_used >= sizeof(gr_complex); } ) )
+  {
+    _late++;
+    return 0;
+  }
 
-  if ( size != total )
+  if ( _buf_used < sizeof(gr_complex) )
     throw std::runtime_error( "Receiving samples failed." );
 
-  return noutput_items;
+  size_t avail = _buf_used / sizeof(gr_complex);
+  size_t items = std::min( avail, (size_t)noutput_items );
+  size_t total = items * sizeof(gr_complex);
+
+  if ( items < (size_t)noutput_items )
+    _short++;
+
+  size_t first = std::min( total, _buf.size() - _buf_head );
+  memcpy( out, &_buf[_buf_head], first );
+  memcpy( out + first, &_buf[0], total - first );
+
+  _buf_head = ( _buf_head + total ) % _buf.size();
+  _buf_used -= total;
+
+  lock.unlock();
+  _buf_cond.notify_one();
+
+  return items;
 }
 
 std::string redpitaya_source_c::name()
@@ -160,6 +313,19 @@ size_t redpitaya_source_c::get_num_channels( void )
   return 1;
 }
 
+std::map<std::string, double> redpitaya_source_c::get_stats( size_t chan )
+{
+  std::map<std::string, double> stats;
+
+  std::lock_guard< std::mutex > lock( _buf_mutex );
+  stats["late_reads"] = double( _late );
+  stats["short_reads"] = double( _short );
+  stats["fill"] = double( _buf_used / sizeof(gr_complex) );
+  stats["capacity"] = double( _buf.size() / sizeof(gr_complex) );
+
+  return stats;
+}
+
 osmosdr::meta_range_t redpitaya_source_c::get_sample_rates( void )
 {
   osmosdr::meta_range_t range;
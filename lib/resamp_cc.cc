@@ -0,0 +1,275 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/fft/window.h>
+
+#include <volk/volk.h>
+
+#include "resamp_cc.h"
+
+/* half-band filter length, has to be 4 * m + 3 */
+#define RESAMP_HB_NTAPS 63
+
+/* largest interpolation of the L/M stage, the number of filter phases */
+#define RESAMP_MAX_INTERP 1024
+
+/* L/M stage filter length per output sample of decimation */
+#define RESAMP_TAPS_PER_DECIM 40
+
+static double sinc( double x )
+{
+  return std::fabs( x ) < 1e-9 ? 1.0 : std::sin( M_PI * x ) / ( M_PI * x );
+}
+
+/* closest num / den to x with den <= max_den, from the continued fraction */
+static void best_fraction( double x, unsigned int max_den,
+                           unsigned int &num, unsigned int &den )
+{
+  uint64_t p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+  double v = x;
+
+  for ( int i = 0; i < 64; i++ ) {
+    double a = std::floor( v );
+    uint64_t p2 = uint64_t( a ) * p1 + p0;
+    uint64_t q2 = uint64_t( a ) * q1 + q0;
+
+    if ( q2 > max_den )
+      break;
+
+    p0 = p1; q0 = q1;
+    p1 = p2; q1 = q2;
+
+    if ( std::fabs( x - double( p1 ) / q1 ) <= x * 1e-12 || v - a < 1e-12 )
+      break;
+
+    v = 1.0 / ( v - a );
+  }
+
+  num = unsigned( p1 );
+  den = unsigned( q1 );
+}
+
+resamp_cc_sptr make_resamp_cc( double ratio )
+{
+  return gnuradio::get_initial_sptr( new resamp_cc( ratio ) );
+}
+
+resamp_cc::resamp_cc( double ratio )
+  : gr::block( "resamp_cc",
+               gr::io_signature::make( 1, 1, sizeof(gr_complex) ),
+               gr::io_signature::make( 1, 1, sizeof(gr_complex) ) ),
+    _halvings( 0 ),
+    _interp( 1 ),
+    _decim( 1 ),
+    _pos( 0 ),
+    _phase( 0 )
+{
+  if ( !( ratio >= 1.0 ) )
+    throw std::runtime_error( "resamp_cc: the rate can only be reduced." );
+
+  /* halve as long as that does not turn an odd integer ratio into a fraction */
+  double rest = ratio;
+  while ( rest >= 2.0 ) {
+    double whole = std::round( rest );
+    bool odd = std::fabs( rest - whole ) < 1e-9 && std::fmod( whole, 2.0 ) == 1.0;
+    if ( odd )
+      break;
+
+    rest /= 2;
+    _halvings++;
+  }
+
+  best_fraction( rest, RESAMP_MAX_INTERP, _decim, _interp );
+
+  if ( _halvings ) {
+    const int center = ( RESAMP_HB_NTAPS - 1 ) / 2;
+    std::vector< float > window = gr::fft::window::blackman_harris( RESAMP_HB_NTAPS );
+    std::vector< double > taps( RESAMP_HB_NTAPS );
+
+    double sum = 0;
+    for ( int j = 0; j < RESAMP_HB_NTAPS; j++ ) {
+      taps[j] = 0.5 * sinc( 0.5 * ( j - center ) ) * window[j];
+      sum += taps[j];
+    }
+
+    /* every other tap is zero, only the even ones and the center are used */
+    for ( int j = 0; j < RESAMP_HB_NTAPS; j += 2 )
+      _hb_taps.push_back( float( taps[j] / sum ) );
+    std::reverse( _hb_taps.begin(), _hb_taps.end() );
+    _hb_center = float( taps[center] / sum );
+
+    _hb.resize( _halvings );
+    for ( halfband &stage : _hb ) {
+      stage.even.assign( _hb_taps.size() - 1, gr_complex( 0, 0 ) );
+      stage.odd.assign( _hb_taps.size() - 1, gr_complex( 0, 0 ) );
+    }
+  }
+
+  if ( _interp != _decim ) {
+    size_t ntaps = ( RESAMP_TAPS_PER_DECIM * _decim + _interp - 1 ) / _interp;
+    size_t len = ntaps * _interp;
+
+    /* the prototype runs at interp times the input rate, the stop band
+     * starts around the output nyquist frequency */
+    double cutoff = 0.5 / _decim - 2.0 / len;
+    std::vector< float > window = gr::fft::window::blackman_harris( len );
+    std::vector< double > taps( len );
+
+    double sum = 0;
+    for ( size_t j = 0; j < len; j++ ) {
+      taps[j] = 2 * cutoff * sinc( 2 * cutoff * ( j - ( len - 1 ) / 2.0 ) ) * window[j];
+      sum += taps[j];
+    }
+
+    _phase_taps.assign( _interp, std::vector< float >( ntaps ) );
+    for ( size_t j = 0; j < len; j++ )
+      _phase_taps[ j % _interp ][ ntaps - 1 - j / _interp ] = float( taps[j] * _interp / sum );
+
+    _hist.assign( ntaps - 1, gr_complex( 0, 0 ) );
+    _pos = ntaps - 1;
+  }
+
+  _stage_out.resize( _halvings + 1 );
+
+  set_relative_rate( _interp, uint64_t( _decim ) << _halvings );
+  set_tag_propagation_policy( TPP_ONE_TO_ONE );
+}
+
+double resamp_cc::rate() const
+{
+  return double( _interp ) / ( double( _decim ) * double( 1 << _halvings ) );
+}
+
+void resamp_cc::forecast( int noutput_items, gr_vector_int &ninput_items_required )
+{
+  uint64_t decim = uint64_t( _decim ) << _halvings;
+
+  /* what is left over from the previous call goes out first */
+  uint64_t needed = size_t( noutput_items ) > _fifo.size() ? noutput_items - _fifo.size() : 0;
+
+  ninput_items_required[0] = int( ( needed * decim + _interp - 1 ) / _interp );
+}
+
+size_t resamp_cc::decimate( halfband &stage, const gr_complex *in, size_t nitems,
+                            std::vector< gr_complex > &out )
+{
+  const size_t ntaps = _hb_taps.size();
+
+  /* the even samples hold one more than the odd ones when a sample is odd */
+  for ( size_t i = 0; i < nitems; i++ ) {
+    if ( stage.even.size() == stage.odd.size() )
+      stage.even.push_back( in[i] );
+    else
+      stage.odd.push_back( in[i] );
+  }
+
+  if ( stage.even.size() < ntaps ) {
+    out.clear();
+    return 0;
+  }
+
+  size_t nout = stage.even.size() - ( ntaps - 1 );
+  out.resize( nout );
+
+  /* out[t] = sum h[2i] x[2t + 2(ntaps - 1) - 2i] + h[c] x[2t + c] */
+  const size_t center = ( ntaps - 2 ) / 2;
+  for ( size_t t = 0; t < nout; t++ ) {
+    gr_complex acc;
+    volk_32fc_32f_dot_prod_32fc( &acc, &stage.even[t], _hb_taps.data(), ntaps );
+    out[t] = acc + stage.odd[ center + t ] * _hb_center;
+  }
+
+  stage.even.erase( stage.even.begin(), stage.even.begin() + nout );
+  stage.odd.erase( stage.odd.begin(), stage.odd.begin() + nout );
+
+  return nout;
+}
+
+size_t resamp_cc::resample( const gr_complex *in, size_t nitems,
+                            std::vector< gr_complex > &out )
+{
+  const size_t ntaps = _phase_taps[0].size();
+
+  _hist.insert( _hist.end(), in, in + nitems );
+
+  out.clear();
+  while ( _pos < _hist.size() ) {
+    gr_complex acc;
+    volk_32fc_32f_dot_prod_32fc( &acc, &_hist[ _pos - ( ntaps - 1 ) ],
+                                 _phase_taps[ _phase ].data(), ntaps );
+    out.push_back( acc );
+
+    _phase += _decim;
+    _pos += _phase / _interp;
+    _phase %= _interp;
+  }
+
+  size_t drop = std::min( _pos - ( ntaps - 1 ), _hist.size() );
+  _hist.erase( _hist.begin(), _hist.begin() + drop );
+  _pos -= drop;
+
+  return out.size();
+}
+
+int resamp_cc::general_work( int noutput_items,
+                             gr_vector_int &ninput_items,
+                             gr_vector_const_void_star &input_items,
+                             gr_vector_void_star &output_items )
+{
+  const gr_complex *in = (const gr_complex *) input_items[0];
+  gr_complex *out = (gr_complex *) output_items[0];
+
+  /* no more than needed for the output, the excess waits in the fifo */
+  gr_vector_int required( 1 );
+  forecast( noutput_items, required );
+  size_t nitems = std::min( ninput_items[0], required[0] );
+
+  const gr_complex *src = in;
+  size_t n = nitems;
+
+  for ( unsigned int i = 0; i < _halvings; i++ ) {
+    n = decimate( _hb[i], src, n, _stage_out[i] );
+    src = _stage_out[i].data();
+  }
+
+  if ( _interp != _decim ) {
+    n = resample( src, n, _stage_out[ _halvings ] );
+    src = _stage_out[ _halvings ].data();
+  }
+
+  _fifo.insert( _fifo.end(), src, src + n );
+
+  size_t nout = std::min( size_t( noutput_items ), _fifo.size() );
+  memcpy( out, _fifo.data(), nout * sizeof(gr_complex) );
+  _fifo.erase( _fifo.begin(), _fifo.begin() + nout );
+
+  consume_each( nitems );
+
+  return int( nout );
+}
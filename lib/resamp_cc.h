@@ -0,0 +1,94 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_RESAMP_CC_H
+#define INCLUDED_RESAMP_CC_H
+
+#include <gnuradio/block.h>
+
+#include <vector>
+
+class resamp_cc;
+
+typedef std::shared_ptr< resamp_cc > resamp_cc_sptr;
+
+resamp_cc_sptr make_resamp_cc( double ratio );
+
+/*!
+ * Rate reduction by an arbitrary ratio >= 1, used by the source to deliver
+ * sample rates the device does not support natively.
+ *
+ * The ratio is split into a cascade of half-band decimators by 2, followed
+ * by a polyphase L/M resampler for whatever is left, which lies between 1
+ * and 2. L/M is the closest fraction with L up to RESAMP_MAX_INTERP, exact
+ * for the ratios of typical sample rates. Both stages run on the polyphase
+ * components of their filters, so no multiplication by a zero tap or an
+ * inserted zero sample is done.
+ *
+ * Tags pass with their offsets scaled to the output rate.
+ */
+class resamp_cc : public gr::block
+{
+private:
+  friend resamp_cc_sptr make_resamp_cc( double ratio );
+
+  resamp_cc( double ratio );
+
+public:
+  void forecast( int noutput_items, gr_vector_int &ninput_items_required );
+
+  int general_work( int noutput_items,
+                    gr_vector_int &ninput_items,
+                    gr_vector_const_void_star &input_items,
+                    gr_vector_void_star &output_items );
+
+  /* output rate over input rate actually implemented */
+  double rate( void ) const;
+
+private:
+  struct halfband
+  {
+    /* even and odd input samples, with the history the filter needs */
+    std::vector< gr_complex > even;
+    std::vector< gr_complex > odd;
+  };
+
+  size_t decimate( halfband &stage, const gr_complex *in, size_t nitems,
+                   std::vector< gr_complex > &out );
+  size_t resample( const gr_complex *in, size_t nitems,
+                   std::vector< gr_complex > &out );
+
+  unsigned int _halvings;
+  unsigned int _interp;
+  unsigned int _decim;
+
+  std::vector< float > _hb_taps;  /* the nonzero taps off center, reversed */
+  float _hb_center;
+  std::vector< halfband > _hb;
+
+  std::vector< std::vector< float > > _phase_taps;  /* reversed */
+  std::vector< gr_complex > _hist;
+  size_t _pos;                    /* in _hist, of the newest sample in use */
+  unsigned int _phase;
+
+  std::vector< std::vector< gr_complex > > _stage_out;
+  std::vector< gr_complex > _fifo;  /* output that did not fit */
+};
+
+#endif /* INCLUDED_RESAMP_CC_H */
@@ -0,0 +1,98 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef OSMOSDR_RETUNE_HELPERS_H
+#define OSMOSDR_RETUNE_HELPERS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * What a streaming backend needs to know about one transfer after a retune.
+ * When valid, the sample at index skip is the first one tagged with freq,
+ * dropped counts the settling samples discarded in front of it.
+ */
+struct retune_mark
+{
+  bool valid;
+  double freq;
+  size_t skip;
+  uint64_t dropped;
+};
+
+/*
+ * Bookkeeping for rx_freq tagging with an optional settling window.
+ *
+ * The tuning call arms the tracker once the device accepted the new
+ * frequency, the streaming callback then asks it about every transfer in
+ * the order they are queued. Both sides are expected to hold the lock of
+ * the backend's sample ring.
+ */
+class retune_tracker
+{
+public:
+  retune_tracker()
+    : _pending( false ), _freq( 0 ), _drop_left( 0 ), _dropped( 0 )
+  {
+  }
+
+  void arm( double freq, double rate, double settle_ms )
+  {
+    _pending = true;
+    _freq = freq;
+    _drop_left = settle_ms > 0 ? uint64_t( settle_ms * rate / 1000.0 ) : 0;
+  }
+
+  /* A transfer consisting of nothing but settling samples comes back with
+   * skip == nitems and has to be dropped entirely by the caller. */
+  retune_mark transfer( size_t nitems )
+  {
+    retune_mark mark = { false, 0, 0, 0 };
+
+    if ( !_pending )
+      return mark;
+
+    if ( _drop_left >= nitems ) {
+      _drop_left -= nitems;
+      _dropped += nitems;
+      mark.skip = nitems;
+      return mark;
+    }
+
+    mark.valid = true;
+    mark.freq = _freq;
+    mark.skip = _drop_left;
+    mark.dropped = _dropped + _drop_left;
+
+    _pending = false;
+    _drop_left = 0;
+    _dropped = 0;
+
+    return mark;
+  }
+
+private:
+  bool _pending;
+  double _freq;
+  uint64_t _drop_left;
+  uint64_t _dropped;
+};
+
+#endif // OSMOSDR_RETUNE_HELPERS_H
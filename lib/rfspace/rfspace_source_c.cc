@@ -63,6 +63,8 @@ using namespace boost::assign;
 #define DEFAULT_HOST  "127.0.0.1" /* We assume a running "siqs" from CuteSDR project */
 #define DEFAULT_PORT  50000
 
+static const pmt::pmt_t RX_TIME_KEY = pmt::string_to_symbol("rx_time");
+
 /*
  * Create a new instance of rfspace_source_c and return
  * a boost shared_ptr.  This is effectively the public constructor.
@@ -90,7 +92,7 @@ static const int MAX_OUT = 1;	// maximum number of output streams
  * The private constructor
  */
 rfspace_source_c::rfspace_source_c (const std::string &args)
-  : gr::sync_block ("rfspace_source_c",
+  : direct_block ("rfspace_source_c",
                     gr::io_signature::make (MIN_IN, MAX_IN, sizeof (gr_complex)),
                     gr::io_signature::make (MIN_OUT, MAX_OUT, sizeof (gr_complex))),
     _radio(RADIO_UNKNOWN),
@@ -103,7 +105,8 @@ rfspace_source_c::rfspace_source_c (const std::string &args)
     _nchan(1),
     _sample_rate(NAN),
     _bandwidth(0.0f),
-    _fifo(NULL)
+    _fifo(NULL),
+    _fifo_in(0)
 {
   std::string host = "";
   unsigned short port = 0;
@@ -170,6 +173,13 @@ rfspace_source_c::rfspace_source_c (const std::string &args)
   if (dict.count("nchan"))
     _nchan = boost::lexical_cast< size_t >( dict["nchan"] );
 
+  if ( dict.count( "time_period" ) )
+    _clock.set_tag_period( boost::lexical_cast< double >( dict["time_period"] ) );
+  else
+    _clock.set_tag_period( 1.0 );
+
+  _sched.set( dict );
+
   if ( _nchan < 1 || _nchan > 2 )
     throw std::runtime_error("Number of channels (nchan) must be 1 or 2");
 
@@ -216,7 +226,8 @@ rfspace_source_c::rfspace_source_c (const std::string &args)
 
     _radio = RFSPACE_SDR_IQ; /* legitimate assumption */
 
-    _fifo = new boost::circular_buffer<gr_complex>( 200000 );
+    _fifo = new fifo_t( 200000,
+                        pool_allocator< gr_complex >( args_to_numa_node( dict ) ) );
     if ( ! _fifo )
       throw std::runtime_error( "Failed to allocate sample FIFO" );
 
@@ -428,6 +439,18 @@ rfspace_source_c::rfspace_source_c (const std::string &args)
       std::cerr << "NetSDR receiver required for dual channel support." << std::endl;
   }
 
+  /* neither changes while open, spare the radio the repeated queries */
+  _sample_rates = query_sample_rates();
+  if ( !_sample_rates.empty() )
+    _sample_rates.validate();
+
+  for ( size_t chan = 0; chan < _nchan; chan++ )
+  {
+    _freq_ranges.push_back( query_freq_range( chan ) );
+    if ( !_freq_ranges.back().empty() )
+      _freq_ranges.back().validate();
+  }
+
   /* preset reasonable defaults */
 
   if ( RFSPACE_SDR_IQ == _radio )
@@ -631,6 +654,8 @@ void rfspace_source_c::usb_read_task()
   if ( -1 == _usb )
     return;
 
+  _sched.apply( "rfspace usb read thread" );
+
   while ( _run_usb_read_task )
   {
     size_t nbytes = read_bytes( _usb, data, 2, _run_usb_read_task );
@@ -662,9 +687,13 @@ void rfspace_source_c::usb_read_task()
     {
       /* push samples into the fifo */
 
+      size_t num_samples = length / 4;
+
+      uint64_t now = _stats.arrival();
+      uint64_t count = _clock.arrival( num_samples );
+
       _fifo_lock.lock();
 
-      size_t num_samples = length / 4;
       n_avail = _fifo->capacity() - _fifo->size();
       to_copy = (n_avail < num_samples ? n_avail : num_samples);
 
@@ -684,6 +713,16 @@ void rfspace_source_c::usb_read_task()
 
       #undef SCALE_16
 
+      if ( to_copy ) {
+        time_mark tmark = { _fifo_in, count, to_copy };
+        _time_marks.push_back( tmark );
+      }
+
+      _fifo_in += to_copy;
+
+      _arrivals.queued( to_copy, now );
+      _stats.fill( _fifo->size(), _fifo->capacity() );
+
       _fifo_lock.unlock();
 
       /* We have made some new samples available to the consumer in work() */
@@ -693,8 +732,10 @@ void rfspace_source_c::usb_read_task()
       }
 
       /* Indicate overrun, if neccesary */
-      if (to_copy < num_samples)
+      if (to_copy < num_samples) {
+        _overflows++;
         std::cerr << "O" << std::flush;
+      }
     }
     else
     {
@@ -735,6 +776,8 @@ bool rfspace_source_c::start()
   _running = true;
   _keep_running = false;
 
+  _clock.reset( _sample_rate );
+
   /* SDR-IP 4.2.1 Receiver State */
   /* NETSDR 4.2.1 Receiver State */
   unsigned char start[] = { 0x08, 0x00, 0x18, 0x00, 0x80, 0x02, 0x00, 0x00 };
@@ -762,8 +805,13 @@ bool rfspace_source_c::stop()
     _running = false;
   _keep_running = false;
 
-  if ( _fifo )
+  if ( _fifo ) {
+    std::lock_guard<std::mutex> lock(_fifo_lock);
     _fifo->clear();
+    _arrivals.clear();
+    _time_marks.clear();
+    _fifo_in = nitems_written(0);
+  }
 
   /* SDR-IP 4.2.1 Receiver State */
   /* NETSDR 4.2.1 Receiver State */
@@ -809,6 +857,25 @@ int rfspace_source_c::work( int noutput_items,
         _fifo->pop_front();
       }
 
+      _arrivals.taken( noutput_items, _stats );
+      _stats.fill( _fifo->size(), _fifo->capacity() );
+
+      /* the fifo position of a sample equals its output position */
+      uint64_t first = nitems_written(0);
+
+      while ( !_time_marks.empty() &&
+              _time_marks.front().pos < first + noutput_items )
+      {
+        const time_mark &tmark = _time_marks.front();
+        uint64_t offset = std::max( tmark.pos, first );
+
+        if ( _clock.tag_due( tmark.count, tmark.nitems ) )
+          add_item_tag(0, offset, RX_TIME_KEY,
+                       time_to_pmt(_clock.time_of( tmark.count + offset - tmark.pos )));
+
+        _time_marks.pop_front();
+      }
+
 //      std::cerr << "-" << std::flush;
     }
 
@@ -1211,11 +1278,30 @@ size_t rfspace_source_c::get_num_channels()
   return _nchan;
 }
 
+uint64_t rfspace_source_c::get_overflows()
+{
+  return _overflows;
+}
+
+std::map<std::string, double> rfspace_source_c::get_stats( size_t chan )
+{
+  std::map<std::string, double> stats;
+  _stats.report( stats );
+  _sched.report( stats );
+
+  return stats;
+}
+
 #define NETSDR_MAX_RATE  2e6  /* same for SDR-IP & NETSDR */
 #define NETSDR_ADC_CLOCK 80e6 /* same for SDR-IP & NETSDR */
 #define SDR_IQ_ADC_CLOCK 66666667 /* SDR-IQ 5.2.4 I/Q Data Output Sample Rate */
 
 osmosdr::meta_range_t rfspace_source_c::get_sample_rates()
+{
+  return _sample_rates;
+}
+
+osmosdr::meta_range_t rfspace_source_c::query_sample_rates()
 {
   osmosdr::meta_range_t range;
 
@@ -1302,7 +1388,7 @@ double rfspace_source_c::set_sample_rate( double rate )
   {
     /* does not support arbitrary rates, pick closest from hardcoded values above */
 
-    double closest_rate = get_sample_rates().clip( rate, true );
+    double closest_rate = _sample_rates.clip( rate, true );
 
     if ( closest_rate != rate )
       std::cerr << "Picked closest supported sample rate of " << (uint32_t)closest_rate << " Hz"
@@ -1347,6 +1433,9 @@ double rfspace_source_c::set_sample_rate( double rate )
 
   _sample_rate = u32_rate;
 
+  /* start() above still had the previous rate */
+  _clock.set_rate( _sample_rate );
+
   if ( rate != _sample_rate )
     std::cerr << "Radio reported a sample rate of " << (uint32_t)_sample_rate << " Hz"
               << std::endl;
@@ -1360,6 +1449,14 @@ double rfspace_source_c::get_sample_rate()
 }
 
 osmosdr::freq_range_t rfspace_source_c::get_freq_range( size_t chan )
+{
+  if ( chan < _freq_ranges.size() )
+    return _freq_ranges[ chan ];
+
+  return query_freq_range( chan );
+}
+
+osmosdr::freq_range_t rfspace_source_c::query_freq_range( size_t chan )
 {
   osmosdr::freq_range_t range;
 
@@ -1628,3 +1725,13 @@ osmosdr::freq_range_t rfspace_source_c::get_bandwidth_range( size_t chan )
 
   return bandwidths;
 }
+
+::osmosdr::time_spec_t rfspace_source_c::get_time_now( size_t mboard )
+{
+  return _clock.now();
+}
+
+void rfspace_source_c::set_time_now( const ::osmosdr::time_spec_t &time_spec, size_t mboard )
+{
+  _clock.set_time( time_spec );
+}
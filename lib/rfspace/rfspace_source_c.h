@@ -26,11 +26,17 @@
 
 #include <boost/circular_buffer.hpp>
 
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 
 #include "osmosdr/ranges.h"
 #include "source_iface.h"
+#include "direct_block.h"
+#include "stats_helpers.h"
+#include "time_helpers.h"
+#include "sched_helpers.h"
+#include "pool_helpers.h"
 class rfspace_source_c;
 
 #ifndef SOCKET
@@ -60,7 +66,7 @@ typedef std::shared_ptr<rfspace_source_c> rfspace_source_c_sptr;
 rfspace_source_c_sptr make_rfspace_source_c (const std::string & args = "");
 
 class rfspace_source_c :
-    public gr::sync_block,
+    public direct_block,
     public source_iface
 {
 private:
@@ -83,6 +89,8 @@ public:
   static std::vector< std::string > get_devices( bool fake = false );
 
   size_t get_num_channels( void );
+  uint64_t get_overflows( void );
+  std::map< std::string, double > get_stats( size_t chan = 0 );
 
   osmosdr::meta_range_t get_sample_rates( void );
   double set_sample_rate( double rate );
@@ -112,6 +120,9 @@ public:
   double get_bandwidth( size_t chan = 0 );
   osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 );
 
+  ::osmosdr::time_spec_t get_time_now( size_t mboard = 0 );
+  void set_time_now( const ::osmosdr::time_spec_t &time_spec, size_t mboard = 0 );
+
 private: /* functions */
   void apply_channel( unsigned char *cmd, size_t chan = 0 );
 
@@ -123,6 +134,9 @@ private: /* functions */
   void usb_read_task();
   void tcp_keepalive_task();
 
+  osmosdr::meta_range_t query_sample_rates();
+  osmosdr::freq_range_t query_freq_range( size_t chan );
+
 private: /* members */
   enum radio_type
   {
@@ -144,6 +158,11 @@ private: /* members */
   uint16_t _sequence;
 
   size_t _nchan;
+
+  /* fixed once the radio and the channels are known, queried once */
+  osmosdr::meta_range_t _sample_rates;
+  std::vector< osmosdr::freq_range_t > _freq_ranges;
+
   double _sample_rate;
   double _bandwidth;
 
@@ -152,13 +171,26 @@ private: /* members */
   bool _run_tcp_keepalive_task;
   std::mutex _tcp_lock;
 
-  boost::circular_buffer<gr_complex> *_fifo;
+  typedef boost::circular_buffer< gr_complex, pool_allocator< gr_complex > > fifo_t;
+  fifo_t *_fifo;
   std::mutex _fifo_lock;
   std::condition_variable _samp_avail;
 
   std::vector< unsigned char > _resp;
   std::mutex _resp_lock;
   std::condition_variable _resp_avail;
+
+  std::atomic<uint64_t> _overflows{0};
+
+  /* of the SDR-IQ fifo */
+  fifo_arrivals _arrivals;
+  stream_stats _stats;
+
+  uint64_t _fifo_in;    /* output position of the next sample queued */
+  std::deque< time_mark > _time_marks;
+  host_clock _clock;
+
+  io_sched _sched;
 };
 
 #endif /* INCLUDED_RFSPACE_SOURCE_C_H */
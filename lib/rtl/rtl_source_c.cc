@@ -40,10 +40,17 @@
 
 #include <rtl-sdr.h>
 
+#include <pmt/pmt.h>
+
 #include "arg_helpers.h"
+#include "convert_helpers.h"
 
 using namespace boost::assign;
 
+static const pmt::pmt_t RX_FREQ_KEY = pmt::string_to_symbol("rx_freq");
+static const pmt::pmt_t RX_DROPPED_KEY = pmt::string_to_symbol("rx_dropped");
+static const pmt::pmt_t RX_TIME_KEY = pmt::string_to_symbol("rx_time");
+
 #define BUF_LEN  (16 * 32 * 512) /* must be multiple of 512 */
 #define BUF_NUM   15
 #define BUF_SKIP  1 // buffers to skip due to initial garbage
@@ -78,16 +85,18 @@ static const int MAX_OUT = 1;	// maximum number of output streams
  * The private constructor
  */
 rtl_source_c::rtl_source_c (const std::string &args)
-  : gr::sync_block ("rtl_source_c",
+  : direct_block ("rtl_source_c",
         gr::io_signature::make(MIN_IN, MAX_IN, sizeof (gr_complex)),
-        gr::io_signature::make(MIN_OUT, MAX_OUT, sizeof (gr_complex))),
+        gr::io_signature::make(MIN_OUT, MAX_OUT, args_to_item_size(args))),
+    _item_size(args_to_item_size(args)),
     _dev(NULL),
     _buf(NULL),
     _running(false),
     _no_tuner(false),
     _auto_gain(false),
     _if_gain(0),
-    _skipped(0)
+    _skipped(0),
+    _settle_ms(0)
 {
   int ret;
   int index;
@@ -153,6 +162,16 @@ rtl_source_c::rtl_source_c (const std::string &args)
   if (dict.count("bias"))
     bias_tee = boost::lexical_cast<bool>( dict["bias"] );
 
+  if (dict.count("settle_ms"))
+    _settle_ms = boost::lexical_cast< double >( dict["settle_ms"] );
+
+  if (dict.count("time_period"))
+    _clock.set_tag_period( boost::lexical_cast< double >( dict["time_period"] ) );
+  else
+    _clock.set_tag_period( 1.0 );
+
+  _sched.set( dict );
+
   _buf_num = _buf_len = _buf_head = _buf_used = _buf_offset = 0;
 
   if (dict.count("buffers"))
@@ -173,6 +192,9 @@ rtl_source_c::rtl_source_c (const std::string &args)
   }
 
   _samp_avail = _buf_len / BYTES_PER_SAMPLE;
+  _buf_mark.resize( _buf_num );
+  _buf_time.resize( _buf_num );
+  _buf_count.resize( _buf_num );
 
   // create a lookup table for gr_complex values
   for (unsigned int i = 0; i < 0x100; i++)
@@ -228,13 +250,43 @@ rtl_source_c::rtl_source_c (const std::string &args)
   if (ret < 0)
     throw std::runtime_error("Failed to reset usb buffers.");
 
+  _sample_rates += osmosdr::range_t( 250000 ); // known to work
+  _sample_rates += osmosdr::range_t( 1000000 ); // known to work
+  _sample_rates += osmosdr::range_t( 1024000 ); // known to work
+  _sample_rates += osmosdr::range_t( 1800000 ); // known to work
+  _sample_rates += osmosdr::range_t( 1920000 ); // known to work
+  _sample_rates += osmosdr::range_t( 2000000 ); // known to work
+  _sample_rates += osmosdr::range_t( 2048000 ); // known to work
+  _sample_rates += osmosdr::range_t( 2400000 ); // known to work
+  _sample_rates += osmosdr::range_t( 2560000 ); // known to work
+//  _sample_rates += osmosdr::range_t( 2600000 ); // may work
+//  _sample_rates += osmosdr::range_t( 2800000 ); // may work
+//  _sample_rates += osmosdr::range_t( 3000000 ); // may work
+//  _sample_rates += osmosdr::range_t( 3200000 ); // max rate
+  _sample_rates.validate();
+
+  /* the tuner and the usb strings do not change, ask for them only once */
+  _freq_range = query_freq_range();
+  if ( !_freq_range.empty() )
+    _freq_range.validate();
+
+  _gain_range = query_gain_range();
+  if ( !_gain_range.empty() )
+    _gain_range.validate();
+
   set_if_gain( 24 ); /* preset to a reasonable default (non-GRC use case) */
 
   _buf = (unsigned char **)malloc(_buf_num * sizeof(unsigned char *));
 
+  /* all buffers in one piece of the pool */
+  unsigned char *mem = (unsigned char *)
+      buffer_pool::get().alloc( _buf_num * _buf_len, args_to_numa_node( dict ) );
+  if ( !mem )
+    throw std::runtime_error("Failed to allocate sample buffers.");
+
   if (_buf) {
     for(unsigned int i = 0; i < _buf_num; ++i)
-      _buf[i] = (unsigned char *)malloc(_buf_len);
+      _buf[i] = mem + i * _buf_len;
   }
 }
 
@@ -256,9 +308,7 @@ rtl_source_c::~rtl_source_c ()
   }
 
   if (_buf) {
-    for(unsigned int i = 0; i < _buf_num; ++i) {
-      free(_buf[i]);
-    }
+    buffer_pool::get().release( _buf[0] );
 
     free(_buf);
     _buf = NULL;
@@ -267,6 +317,14 @@ rtl_source_c::~rtl_source_c ()
 
 bool rtl_source_c::start()
 {
+  {
+    /* the first sample carries the frequency we start on */
+    std::lock_guard<std::mutex> lock( _buf_mutex );
+    _retune.arm( get_center_freq(), get_sample_rate(), 0 );
+  }
+
+  _clock.reset( get_sample_rate() );
+
   _running = true;
   _thread = gr::thread::thread(_rtlsdr_wait, this);
 
@@ -296,18 +354,32 @@ void rtl_source_c::rtlsdr_callback(unsigned char *buf, uint32_t len)
     return;
   }
 
+  uint64_t now = _stats.arrival();
+  uint64_t count = _clock.arrival( len / BYTES_PER_SAMPLE );
+
   {
     std::lock_guard<std::mutex> lock( _buf_mutex );
 
+    retune_mark mark = _retune.transfer( len / BYTES_PER_SAMPLE );
+    if (mark.skip * BYTES_PER_SAMPLE == len)
+      return; /* still settling */
+
     int buf_tail = (_buf_head + _buf_used) % _buf_num;
     memcpy(_buf[buf_tail], buf, len);
+    _buf_mark[buf_tail] = mark;
+    _buf_time[buf_tail] = now;
+    _buf_count[buf_tail] = count;
 
     if (_buf_used == _buf_num) {
+      _overflows++;
       std::cerr << "O" << std::flush;
       _buf_head = (_buf_head + 1) % _buf_num;
     } else {
       _buf_used++;
     }
+
+    _stats.fill(_buf_used * (_buf_len / BYTES_PER_SAMPLE),
+                _buf_num * (_buf_len / BYTES_PER_SAMPLE));
   }
 
   _buf_cond.notify_one();
@@ -320,6 +392,8 @@ void rtl_source_c::_rtlsdr_wait(rtl_source_c *obj)
 
 void rtl_source_c::rtlsdr_wait()
 {
+  _sched.apply( "rtl rx thread" );
+
   int ret = rtlsdr_read_async( _dev, _rtlsdr_callback, (void *)this, _buf_num, _buf_len );
 
   _running = false;
@@ -334,7 +408,7 @@ int rtl_source_c::work( int noutput_items,
                         gr_vector_const_void_star &input_items,
                         gr_vector_void_star &output_items )
 {
-  gr_complex *out = (gr_complex *)output_items[0];
+  uint8_t *out = (uint8_t *)output_items[0];
 
   {
     std::unique_lock<std::mutex> lock( _buf_mutex );
@@ -347,11 +421,47 @@ int rtl_source_c::work( int noutput_items,
     return WORK_DONE;
 
   while (noutput_items && _buf_used) {
+    if (!_buf_offset) {
+      retune_mark mark;
+      uint64_t count;
+      {
+        std::lock_guard<std::mutex> lock( _buf_mutex );
+        mark = _buf_mark[_buf_head];
+        _buf_mark[_buf_head].valid = false;
+        count = _buf_count[_buf_head];
+        _stats.taken(_buf_time[_buf_head]);
+      }
+
+      uint64_t offset = nitems_written(0) + (out - ((uint8_t *)output_items[0])) / _item_size;
+
+      if (mark.valid) {
+        add_item_tag(0, offset, RX_FREQ_KEY, pmt::from_double(mark.freq));
+        if (mark.dropped)
+          add_item_tag(0, offset, RX_DROPPED_KEY, pmt::from_uint64(mark.dropped));
+
+        _buf_offset = mark.skip;
+        _samp_avail -= mark.skip;
+      }
+
+      /* trimmed settling samples are a gap as well */
+      if (_clock.tag_due(count, _buf_len / BYTES_PER_SAMPLE) || _buf_offset)
+        add_item_tag(0, offset, RX_TIME_KEY,
+                     time_to_pmt(_clock.time_of(count + _buf_offset)));
+    }
+
     const int nout = std::min(noutput_items, _samp_avail);
     const unsigned char *buf = _buf[_buf_head] + _buf_offset * 2;
 
-    for (int i = 0; i < nout; ++i)
-      *out++ = gr_complex(_lut[buf[i * 2]], _lut[buf[i * 2 + 1]]);
+    if (_item_size == sizeof(gr_complex)) {
+      gr_complex *cout = (gr_complex *)out;
+      for (int i = 0; i < nout; ++i)
+        cout[i] = gr_complex(_lut[buf[i * 2]], _lut[buf[i * 2 + 1]]);
+    } else if (_item_size == 2 * sizeof(int16_t)) {
+      convert_8u_to_16i(buf, (int16_t *)out, 2 * nout);
+    } else {
+      convert_8u_to_8i(buf, (int8_t *)out, 2 * nout);
+    }
+    out += nout * _item_size;
 
     noutput_items -= nout;
     _samp_avail -= nout;
@@ -362,6 +472,9 @@ int rtl_source_c::work( int noutput_items,
 
         _buf_head = (_buf_head + 1) % _buf_num;
         _buf_used--;
+
+        _stats.fill(_buf_used * (_buf_len / BYTES_PER_SAMPLE),
+                    _buf_num * (_buf_len / BYTES_PER_SAMPLE));
       }
       _samp_avail = _buf_len / BYTES_PER_SAMPLE;
       _buf_offset = 0;
@@ -370,7 +483,7 @@ int rtl_source_c::work( int noutput_items,
     }
   }
 
-  return (out - ((gr_complex *)output_items[0]));
+  return (out - ((uint8_t *)output_items[0])) / _item_size;
 }
 
 std::vector<std::string> rtl_source_c::get_devices()
@@ -414,31 +527,30 @@ size_t rtl_source_c::get_num_channels()
   return 1;
 }
 
-osmosdr::meta_range_t rtl_source_c::get_sample_rates()
+uint64_t rtl_source_c::get_overflows()
 {
-  osmosdr::meta_range_t range;
-
-  range += osmosdr::range_t( 250000 ); // known to work
-  range += osmosdr::range_t( 1000000 ); // known to work
-  range += osmosdr::range_t( 1024000 ); // known to work
-  range += osmosdr::range_t( 1800000 ); // known to work
-  range += osmosdr::range_t( 1920000 ); // known to work
-  range += osmosdr::range_t( 2000000 ); // known to work
-  range += osmosdr::range_t( 2048000 ); // known to work
-  range += osmosdr::range_t( 2400000 ); // known to work
-  range += osmosdr::range_t( 2560000 ); // known to work
-//  range += osmosdr::range_t( 2600000 ); // may work
-//  range += osmosdr::range_t( 2800000 ); // may work
-//  range += osmosdr::range_t( 3000000 ); // may work
-//  range += osmosdr::range_t( 3200000 ); // max rate
+  return _overflows;
+}
 
-  return range;
+std::map<std::string, double> rtl_source_c::get_stats( size_t chan )
+{
+  std::map<std::string, double> stats;
+  _stats.report( stats );
+  _sched.report( stats );
+
+  return stats;
+}
+
+osmosdr::meta_range_t rtl_source_c::get_sample_rates()
+{
+  return _sample_rates;
 }
 
 double rtl_source_c::set_sample_rate(double rate)
 {
   if (_dev) {
     rtlsdr_set_sample_rate( _dev, (uint32_t)rate );
+    _clock.set_rate( get_sample_rate() );
   }
 
   return get_sample_rate();
@@ -453,6 +565,11 @@ double rtl_source_c::get_sample_rate()
 }
 
 osmosdr::freq_range_t rtl_source_c::get_freq_range( size_t chan )
+{
+  return _freq_range;
+}
+
+osmosdr::freq_range_t rtl_source_c::query_freq_range()
 {
   osmosdr::freq_range_t range;
   char manufact[256];
@@ -494,8 +611,12 @@ osmosdr::freq_range_t rtl_source_c::get_freq_range( size_t chan )
 
 double rtl_source_c::set_center_freq( double freq, size_t chan )
 {
-  if (_dev)
-    rtlsdr_set_center_freq( _dev, (uint32_t)freq );
+  if (_dev && !rtlsdr_set_center_freq( _dev, (uint32_t)freq )) {
+    double actual = get_center_freq( chan ), rate = get_sample_rate();
+
+    std::lock_guard<std::mutex> lock( _buf_mutex );
+    _retune.arm( actual, rate, _settle_ms );
+  }
 
   return get_center_freq( chan );
 }
@@ -540,6 +661,11 @@ std::vector<std::string> rtl_source_c::get_gain_names( size_t chan )
 }
 
 osmosdr::gain_range_t rtl_source_c::get_gain_range( size_t chan )
+{
+  return _gain_range;
+}
+
+osmosdr::gain_range_t rtl_source_c::query_gain_range()
 {
   osmosdr::gain_range_t range;
 
@@ -592,10 +718,8 @@ bool rtl_source_c::get_gain_mode( size_t chan )
 
 double rtl_source_c::set_gain( double gain, size_t chan )
 {
-  osmosdr::gain_range_t rf_gains = rtl_source_c::get_gain_range( chan );
-
   if (_dev) {
-    rtlsdr_set_tuner_gain( _dev, int(rf_gains.clip(gain) * 10.0) );
+    rtlsdr_set_tuner_gain( _dev, int(_gain_range.clip(gain) * 10.0) );
   }
 
   return get_gain( chan );
@@ -710,3 +834,13 @@ std::string rtl_source_c::get_antenna( size_t chan )
 {
   return "RX";
 }
+
+::osmosdr::time_spec_t rtl_source_c::get_time_now( size_t mboard )
+{
+  return _clock.now();
+}
+
+void rtl_source_c::set_time_now( const ::osmosdr::time_spec_t &time_spec, size_t mboard )
+{
+  _clock.set_time( time_spec );
+}
@@ -26,10 +26,17 @@
 
 #include <gnuradio/thread/thread.h>
 
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 
 #include "source_iface.h"
+#include "direct_block.h"
+#include "retune_helpers.h"
+#include "stats_helpers.h"
+#include "time_helpers.h"
+#include "sched_helpers.h"
+#include "pool_helpers.h"
 
 class rtl_source_c;
 typedef struct rtlsdr_dev rtlsdr_dev_t;
@@ -62,7 +69,7 @@ rtl_source_c_sptr make_rtl_source_c (const std::string & args = "");
  *
  */
 class rtl_source_c :
-    public gr::sync_block,
+    public direct_block,
     public source_iface
 {
 private:
@@ -86,6 +93,8 @@ public:
   static std::vector< std::string > get_devices();
 
   size_t get_num_channels( void );
+  uint64_t get_overflows( void );
+  std::map< std::string, double > get_stats( size_t chan = 0 );
 
   osmosdr::meta_range_t get_sample_rates( void );
   double set_sample_rate( double rate );
@@ -113,6 +122,9 @@ public:
   std::string set_antenna( const std::string & antenna, size_t chan = 0 );
   std::string get_antenna( size_t chan = 0 );
 
+  ::osmosdr::time_spec_t get_time_now( size_t mboard = 0 );
+  void set_time_now( const ::osmosdr::time_spec_t &time_spec, size_t mboard = 0 );
+
 protected:
   bool start();
   bool stop();
@@ -123,7 +135,11 @@ private:
   static void _rtlsdr_wait(rtl_source_c *obj);
   void rtlsdr_wait();
 
+  osmosdr::freq_range_t query_freq_range();
+  osmosdr::gain_range_t query_gain_range();
+
   std::vector<float> _lut;
+  size_t _item_size; /* complex float, int16 or int8 */
 
   rtlsdr_dev_t *_dev;
   gr::thread::thread _thread;
@@ -141,8 +157,27 @@ private:
 
   bool _no_tuner;
   bool _auto_gain;
+
+  /* fixed while the device is open, queried once */
+  osmosdr::meta_range_t _sample_rates;
+  osmosdr::freq_range_t _freq_range;
+  osmosdr::gain_range_t _gain_range;
   double _if_gain;
   unsigned int _skipped;
+
+  std::vector<retune_mark> _buf_mark;
+  retune_tracker _retune;
+  double _settle_ms;
+
+  std::atomic<uint64_t> _overflows{0};
+
+  std::vector<uint64_t> _buf_time; /* arrival of each buffer */
+  stream_stats _stats;
+
+  std::vector<uint64_t> _buf_count; /* sample count of each buffer */
+  host_clock _clock;
+
+  io_sched _sched;
 };
 
 #endif /* INCLUDED_RTLSDR_SOURCE_C_H */
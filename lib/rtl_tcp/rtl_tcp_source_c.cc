@@ -143,9 +143,9 @@ rtl_tcp_source_c_sptr make_rtl_tcp_source_c(const std::string &args)
 }
 
 rtl_tcp_source_c::rtl_tcp_source_c(const std::string &args) :
-  gr::sync_block("rtl_tcp_source_c",
-                 gr::io_signature::make(0, 0, 0),
-                 gr::io_signature::make(1, 1, sizeof (gr_complex))),
+  direct_block("rtl_tcp_source_c",
+               gr::io_signature::make(0, 0, 0),
+               gr::io_signature::make(1, 1, sizeof (gr_complex))),
   d_socket(-1),
   _no_tuner(false),
   _auto_gain(false),
@@ -23,6 +23,7 @@
 #include <gnuradio/sync_block.h>
 
 #include "source_iface.h"
+#include "direct_block.h"
 
 class rtl_tcp_source_c;
 
@@ -31,7 +32,7 @@ typedef std::shared_ptr< rtl_tcp_source_c > rtl_tcp_source_c_sptr;
 rtl_tcp_source_c_sptr make_rtl_tcp_source_c( const std::string & args = "" );
 
 class rtl_tcp_source_c :
-    public gr::sync_block,
+    public direct_block,
     public source_iface
 {
 private:
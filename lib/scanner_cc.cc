@@ -0,0 +1,306 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include <gnuradio/io_signature.h>
+
+#include "scanner_cc.h"
+
+/* an rx_freq tag this close to the requested frequency marks the retune */
+#define SCAN_FREQ_TOL 1e3
+
+/* seconds dropped after untagged retunes, beyond what was queued already */
+#define SCAN_FLUSH 0.1
+
+static const pmt::pmt_t RX_FREQ_KEY = pmt::string_to_symbol("rx_freq");
+static const pmt::pmt_t RX_TIME_KEY = pmt::string_to_symbol("rx_time");
+static const pmt::pmt_t SCAN_PORT = pmt::string_to_symbol("scan");
+static const pmt::pmt_t HOLD_CMD = pmt::string_to_symbol("hold");
+static const pmt::pmt_t RESUME_CMD = pmt::string_to_symbol("resume");
+
+scanner_cc_sptr make_scanner_cc( size_t nchan, scanner_tune_fn tune )
+{
+  return gnuradio::get_initial_sptr( new scanner_cc( nchan, tune ) );
+}
+
+scanner_cc::scanner_cc( size_t nchan, scanner_tune_fn tune )
+  : gr::block( "scanner_cc",
+               gr::io_signature::make( nchan, nchan, sizeof(gr_complex) ),
+               gr::io_signature::make( nchan, nchan, sizeof(gr_complex) ) ),
+    _tune( tune ),
+    _running( false ),
+    _next( 0 ), _rate( 0 ), _dwell_time( 0 ), _settle_time( 0 ),
+    _dwell( 0 ), _settle( 0 ), _hold( false ),
+    _state( SCAN_TUNING ),
+    _hop_pending( false ), _tuned( false ), _tagged( false ),
+    _anchored( false ), _anchor( 0 ), _start( 0 ), _left( 0 ), _waited( 0 ),
+    _freq( 0 )
+{
+  /* samples are dropped between segments, general_work() moves the tags */
+  set_tag_propagation_policy( TPP_DONT );
+
+  message_port_register_in( SCAN_PORT );
+  set_msg_handler( SCAN_PORT, [this]( pmt::pmt_t msg ) { handle_msg( msg ); } );
+}
+
+scanner_cc::~scanner_cc()
+{
+  if ( _thread.joinable() )
+    stop();
+}
+
+void scanner_cc::set_schedule( const std::vector< double > &freqs, double rate,
+                               double dwell, double settle )
+{
+  std::lock_guard< std::mutex > lock( _lock );
+
+  _freqs = freqs;
+  _next = 0;
+  _dwell_time = dwell;
+  _settle_time = settle;
+  update_rate( rate );
+
+  /* a running scan restarts from the top of the new list */
+  if ( _running )
+    request_hop();
+}
+
+void scanner_cc::set_rate( double rate )
+{
+  std::lock_guard< std::mutex > lock( _lock );
+
+  update_rate( rate );
+}
+
+void scanner_cc::update_rate( double rate )
+{
+  _rate = rate;
+  _dwell = std::max( uint64_t(1), uint64_t( std::llround( _dwell_time * rate ) ) );
+  _settle = _settle_time > 0 ? uint64_t( std::llround( _settle_time * rate ) ) : 0;
+}
+
+void scanner_cc::hold( bool on )
+{
+  std::lock_guard< std::mutex > lock( _lock );
+
+  _hold = on;
+}
+
+void scanner_cc::handle_msg( pmt::pmt_t msg )
+{
+  if ( pmt::eqv( msg, HOLD_CMD ) )
+    hold( true );
+  else if ( pmt::eqv( msg, RESUME_CMD ) )
+    hold( false );
+  else
+    std::cerr << "scanner: ignoring message " << msg << std::endl;
+}
+
+bool scanner_cc::start()
+{
+  std::lock_guard< std::mutex > lock( _lock );
+
+  _running = true;
+  _tagged = false;
+  request_hop();
+
+  _thread = std::thread( &scanner_cc::hop_loop, this );
+
+  return true;
+}
+
+bool scanner_cc::stop()
+{
+  {
+    std::lock_guard< std::mutex > lock( _lock );
+    _running = false;
+  }
+  _cond.notify_all();
+
+  if ( _thread.joinable() )
+    _thread.join();
+
+  return true;
+}
+
+/* called with _lock held */
+void scanner_cc::request_hop()
+{
+  _state = SCAN_TUNING;
+  _hop_pending = true;
+  _tuned = false;
+  _anchored = false;
+  _waited = 0;
+
+  _cond.notify_one();
+}
+
+void scanner_cc::hop_loop()
+{
+  std::unique_lock< std::mutex > lock( _lock );
+
+  while ( _running ) {
+    if ( !_hop_pending || _freqs.empty() ) {
+      _cond.wait( lock );
+      continue;
+    }
+
+    _hop_pending = false;
+    _next %= _freqs.size();
+    double freq = _freqs[ _next++ ];
+    _freq = freq;
+
+    /* the device call may block for a while, work() keeps dropping */
+    lock.unlock();
+    _tune( freq );
+    osmosdr::time_spec_t now = osmosdr::time_spec_t::get_system_time();
+    lock.lock();
+
+    /* a new schedule may have been set in the meantime */
+    if ( !_hop_pending && SCAN_TUNING == _state ) {
+      _tuned = true;
+      _tune_time = now;
+    }
+  }
+}
+
+/* called with _lock held */
+bool scanner_cc::find_anchor( uint64_t from, uint64_t to )
+{
+  std::vector< gr::tag_t > tags;
+  get_tags_in_range( tags, 0, from, to, RX_FREQ_KEY );
+
+  for ( const gr::tag_t &tag : tags ) {
+    _tagged = true;
+
+    if ( std::abs( pmt::to_double( tag.value ) - _freq ) < SCAN_FREQ_TOL ) {
+      _anchor = tag.offset;
+      _anchored = true;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+int scanner_cc::general_work( int noutput_items,
+                              gr_vector_int &ninput_items,
+                              gr_vector_const_void_star &input_items,
+                              gr_vector_void_star &output_items )
+{
+  size_t nchan = input_items.size();
+  int nin = ninput_items[0];
+  for ( size_t i = 1; i < nchan; i++ )
+    nin = std::min( nin, ninput_items[i] );
+
+  const uint64_t base = nitems_read( 0 );
+  int consumed = 0, produced = 0;
+
+  std::lock_guard< std::mutex > lock( _lock );
+
+  while ( consumed < nin && produced < noutput_items ) {
+    uint64_t pos = base + consumed;
+
+    if ( SCAN_TUNING == _state ) {
+      if ( !_anchored && !_hop_pending )
+        find_anchor( pos, base + nin );
+
+      /* give tagging backends a second before falling back to counting,
+       * past what is queued and a flush for what the device still holds */
+      if ( _tuned && !_anchored && ( !_tagged || _waited >= _rate ) ) {
+        _anchor = base + nin + uint64_t( std::llround( SCAN_FLUSH * _rate ) );
+        _anchored = true;
+        _tune_time += osmosdr::time_spec_t( double( _anchor - pos ) / _rate );
+      }
+
+      if ( !_tuned || !_anchored ) {
+        if ( _tuned )
+          _waited += nin - consumed;
+        consumed = nin;
+        break;
+      }
+
+      _start = _anchor + _settle;
+      _state = SCAN_SETTLING;
+    }
+
+    if ( SCAN_SETTLING == _state ) {
+      if ( pos < _start ) {
+        consumed += int( std::min( _start - pos, uint64_t( nin - consumed ) ) );
+        continue;
+      }
+
+      osmosdr::time_spec_t time = _tune_time +
+          osmosdr::time_spec_t( double( _start - _anchor ) / _rate );
+      pmt::pmt_t time_val = pmt::make_tuple(
+          pmt::from_uint64( time.get_full_secs() ),
+          pmt::from_double( time.get_frac_secs() ) );
+
+      for ( size_t i = 0; i < nchan; i++ ) {
+        uint64_t offset = nitems_written( i ) + produced;
+        add_item_tag( i, offset, RX_FREQ_KEY, pmt::from_double( _freq ) );
+        add_item_tag( i, offset, RX_TIME_KEY, time_val );
+      }
+
+      _left = _dwell;
+      _state = SCAN_DWELL;
+    }
+
+    int n = std::min( nin - consumed, noutput_items - produced );
+    if ( !_hold )
+      n = int( std::min( uint64_t( n ), _left ) );
+
+    /* upstream tags go along, except the retunes this block tags itself */
+    uint64_t from = base + consumed;
+    for ( size_t i = 0; i < nchan; i++ ) {
+      memcpy( (gr_complex *) output_items[i] + produced,
+              (const gr_complex *) input_items[i] + consumed,
+              n * sizeof(gr_complex) );
+
+      std::vector< gr::tag_t > tags;
+      get_tags_in_range( tags, i, from, from + n );
+      for ( const gr::tag_t &tag : tags )
+        if ( ! pmt::eqv( tag.key, RX_FREQ_KEY ) )
+          add_item_tag( i, nitems_written( i ) + produced + ( tag.offset - from ),
+                        tag.key, tag.value, tag.srcid );
+    }
+
+    consumed += n;
+    produced += n;
+
+    if ( !_hold ) {
+      _left -= n;
+      if ( !_left )
+        request_hop();
+    }
+  }
+
+  consume_each( consumed );
+
+  return produced;
+}
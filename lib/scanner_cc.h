@@ -0,0 +1,124 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_SCANNER_CC_H
+#define INCLUDED_SCANNER_CC_H
+
+#include <gnuradio/block.h>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <osmosdr/time_spec.h>
+
+class scanner_cc;
+
+typedef std::shared_ptr< scanner_cc > scanner_cc_sptr;
+
+/* retunes every channel of the source, called from the hop thread */
+typedef std::function< void ( double freq ) > scanner_tune_fn;
+
+scanner_cc_sptr make_scanner_cc( size_t nchan, scanner_tune_fn tune );
+
+/*!
+ * Frequency hopping engine behind source::start_scan(). source_impl splices
+ * it into all channels while a scan is active.
+ *
+ * Hops are counted in samples: once a dwell segment has been passed on, the
+ * block asks its hop thread to retune and drops everything until the new
+ * frequency shows up in the stream. That is the rx_freq tag for backends
+ * which tag retunes. For the others it is a guess: everything queued when
+ * the tuning call has returned is dropped and another 100 ms on top, for
+ * the samples still buffered in the device; deeper buffers need a settle
+ * time to match. The settling time is dropped from there and the next
+ * segment starts with rx_freq and rx_time tags on every output. Other
+ * upstream tags within the segments are passed on.
+ *
+ * The "scan" message port takes the symbols hold and resume. A hold keeps
+ * passing samples at the current frequency until resumed, the interrupted
+ * segment then runs to its end.
+ */
+class scanner_cc : public gr::block
+{
+private:
+  friend scanner_cc_sptr make_scanner_cc( size_t nchan, scanner_tune_fn tune );
+
+  scanner_cc( size_t nchan, scanner_tune_fn tune );
+
+public:
+  ~scanner_cc();
+
+  void set_schedule( const std::vector< double > &freqs, double rate,
+                     double dwell, double settle );
+
+  /* the sample rate changed, dwell and settle keep their length in time */
+  void set_rate( double rate );
+
+  void hold( bool on );
+
+  bool start();
+  bool stop();
+
+  int general_work( int noutput_items,
+                    gr_vector_int &ninput_items,
+                    gr_vector_const_void_star &input_items,
+                    gr_vector_void_star &output_items );
+
+private:
+  enum state_t { SCAN_TUNING, SCAN_SETTLING, SCAN_DWELL };
+
+  void handle_msg( pmt::pmt_t msg );
+  void hop_loop();
+  void request_hop();
+  void update_rate( double rate );
+  bool find_anchor( uint64_t from, uint64_t to );
+
+  scanner_tune_fn _tune;
+
+  std::mutex _lock;
+  std::condition_variable _cond;
+  std::thread _thread;
+  bool _running;
+
+  std::vector< double > _freqs;
+  size_t _next;
+  double _rate;
+  double _dwell_time;
+  double _settle_time;
+  uint64_t _dwell;
+  uint64_t _settle;
+  bool _hold;
+
+  state_t _state;
+  bool _hop_pending;  /* hop thread has work to do */
+  bool _tuned;        /* tuning call for the pending hop returned */
+  bool _tagged;       /* upstream marks retunes with rx_freq tags */
+  bool _anchored;     /* first sample at the new frequency is known */
+  uint64_t _anchor;   /* its absolute input offset */
+  uint64_t _start;    /* input offset where the next segment starts */
+  uint64_t _left;     /* samples left in the current segment */
+  uint64_t _waited;   /* samples dropped since the tuning call returned */
+  double _freq;
+  osmosdr::time_spec_t _tune_time;
+};
+
+#endif /* INCLUDED_SCANNER_CC_H */
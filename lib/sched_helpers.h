@@ -0,0 +1,193 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef OSMOSDR_SCHED_HELPERS_H
+#define OSMOSDR_SCHED_HELPERS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#include "arg_helpers.h"
+#include "stats_helpers.h"
+
+/*
+ * CPU affinity and real-time scheduling of the thread a backend receives
+ * on, from the rx_cpu=, rx_prio= and rx_policy=fifo|rr device arguments.
+ *
+ * Threads the backend starts itself call apply() first thing. Threads of
+ * a vendor library only show up in the streaming callback, which calls
+ * apply_once(): it does the work on the first call from every new thread
+ * and is a comparison of thread ids after that.
+ *
+ * Failures are reported and otherwise ignored, real-time priorities need
+ * CAP_SYS_NICE or an rtprio limit. What got applied shows in get_stats()
+ * as rx_cpu and rx_prio.
+ */
+class io_sched
+{
+public:
+  io_sched()
+    : _cpu( -1 ), _prio( 0 ), _rr( false ), _have_thread( false ),
+      _cpu_set( -1 ), _prio_set( 0 )
+  {
+  }
+
+  void set( const dict_t &dict )
+  {
+    dict_t::const_iterator it;
+
+    if ( ( it = dict.find( "rx_cpu" ) ) != dict.end() ) {
+      _cpu = boost::lexical_cast< int >( it->second );
+      check_cpu( _cpu );
+    }
+
+    if ( ( it = dict.find( "rx_prio" ) ) != dict.end() )
+      _prio = boost::lexical_cast< int >( it->second );
+
+    if ( ( it = dict.find( "rx_policy" ) ) != dict.end() ) {
+      if ( it->second == "rr" )
+        _rr = true;
+      else if ( it->second != "fifo" )
+        throw std::runtime_error( "rx_policy has to be fifo or rr." );
+    }
+  }
+
+  bool wanted( void ) const { return _cpu >= 0 || _prio > 0; }
+
+  /* to be called by the thread itself */
+  void apply( const char *name )
+  {
+    if ( !wanted() )
+      return;
+
+#ifndef _WIN32
+    pthread_t self = pthread_self();
+
+#ifdef __linux__
+    if ( _cpu >= 0 && _cpu < CPU_SETSIZE ) {
+      cpu_set_t cpus;
+      CPU_ZERO( &cpus );
+      CPU_SET( _cpu, &cpus );
+
+      int ret = pthread_setaffinity_np( self, sizeof(cpus), &cpus );
+      if ( ret )
+        std::cerr << name << ": could not pin to cpu " << _cpu
+                  << " (" << strerror( ret ) << ")" << std::endl;
+      else {
+        _cpu_set = _cpu;
+        std::cerr << name << ": pinned to cpu " << _cpu << std::endl;
+      }
+    }
+#else
+    if ( _cpu >= 0 )
+      std::cerr << name << ": rx_cpu is not supported here" << std::endl;
+#endif
+
+    if ( _prio > 0 ) {
+      int policy = _rr ? SCHED_RR : SCHED_FIFO;
+      const char *policy_name = _rr ? "SCHED_RR" : "SCHED_FIFO";
+
+      struct sched_param param;
+      memset( &param, 0, sizeof(param) );
+      param.sched_priority = std::max( sched_get_priority_min( policy ),
+                                       std::min( _prio, sched_get_priority_max( policy ) ) );
+
+      int ret = pthread_setschedparam( self, policy, &param );
+      if ( ret )
+        std::cerr << name << ": could not set " << policy_name << " priority "
+                  << param.sched_priority << " (" << strerror( ret ) << ")" << std::endl;
+      else {
+        _prio_set = param.sched_priority;
+        std::cerr << name << ": " << policy_name << " priority "
+                  << param.sched_priority << std::endl;
+      }
+    }
+#else
+    std::cerr << name << ": rx_cpu and rx_prio are not supported here" << std::endl;
+#endif
+  }
+
+  /* to be called by every streaming callback of a vendor library thread */
+  void apply_once( const char *name )
+  {
+    if ( !wanted() )
+      return;
+
+#ifndef _WIN32
+    pthread_t self = pthread_self();
+    if ( _have_thread && pthread_equal( self, _thread ) )
+      return;
+
+    _thread = self;
+#else
+    if ( _have_thread )
+      return;
+#endif
+
+    _have_thread = true;
+    apply( name );
+  }
+
+  void report( stats_t &stats ) const
+  {
+    stats["rx_cpu"] = double( _cpu_set.load( std::memory_order_relaxed ) );
+    stats["rx_prio"] = double( _prio_set.load( std::memory_order_relaxed ) );
+  }
+
+private:
+  /* an index past the cpu_set_t would be written out of bounds */
+  static void check_cpu( int cpu )
+  {
+    if ( cpu < 0 )
+      throw std::runtime_error( "rx_cpu has to be a cpu index of 0 or more." );
+
+#ifdef __linux__
+    long ncpus = sysconf( _SC_NPROCESSORS_CONF );
+    if ( cpu >= CPU_SETSIZE || ( ncpus > 0 && cpu >= ncpus ) )
+      throw std::runtime_error( "rx_cpu=" + std::to_string( cpu ) +
+                                " is beyond the " + std::to_string( ncpus ) +
+                                " cpus of this system." );
+#endif
+  }
+
+  int _cpu;
+  int _prio;
+  bool _rr;
+
+#ifndef _WIN32
+  pthread_t _thread;   /* the last one seen by apply_once() */
+#endif
+  bool _have_thread;
+
+  std::atomic< int > _cpu_set;
+  std::atomic< int > _prio_set;
+};
+
+#endif // OSMOSDR_SCHED_HELPERS_H
@@ -35,7 +35,9 @@
 
 #include <boost/assign.hpp>
 #include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
 
+#include <algorithm>
 #include <stdexcept>
 #include <iostream>
 #include <stdio.h>
@@ -44,6 +46,7 @@
 #include <mirsdrapi-rsp.h>
 
 #include "arg_helpers.h"
+#include "convert_helpers.h"
 
 #define MAX_SUPPORTED_DEVICES   4
 
@@ -78,6 +81,7 @@ using namespace boost::assign;
 #define SDRPLAY_L_MAX     1675e6
 
 #define SDRPLAY_MAX_BUF_SIZE 504
+#define SDRPLAY_BUF_NUM      512 /* packets queued between reader and work() */
 
 /*
  * Create a new instance of sdrplay_source_c and return
@@ -107,13 +111,28 @@ static const int MAX_OUT = 1;	// maximum number of output streams
  * The private constructor
  */
 sdrplay_source_c::sdrplay_source_c (const std::string &args)
-  : gr::sync_block ("sdrplay_source_c",
+  : direct_block ("sdrplay_source_c",
         gr::io_signature::make(MIN_IN, MAX_IN, sizeof (gr_complex)),
         gr::io_signature::make(MIN_OUT, MAX_OUT, sizeof (gr_complex))),
+    _bufi(pool_allocator< short >(args_to_numa_node(params_to_dict(args)))),
+    _bufq(_bufi.get_allocator()),
+    _buf_num(SDRPLAY_BUF_NUM),
+    _buf_head(0),
+    _buf_used(0),
+    _buf_offset(0),
     _running(false),
-    _uninit(false),
-    _auto_gain(false)
+    _auto_gain(false),
+    _defer_reinit(false),
+    _reinit_due(false)
 {
+   dict_t dict = params_to_dict(args);
+
+   if (dict.count("buffers"))
+      _buf_num = boost::lexical_cast< unsigned int >( dict["buffers"] );
+
+   if (0 == _buf_num)
+      _buf_num = SDRPLAY_BUF_NUM;
+
    _dev = (sdrplay_dev_t *)malloc(sizeof(sdrplay_dev_t));
    if (_dev == NULL)
    {
@@ -128,13 +147,11 @@ sdrplay_source_c::sdrplay_source_c (const std::string &args)
    _dev->gRdB = 60;
    set_gain_limits(_dev->rfHz);
    _dev->gain_dB = _dev->maxGain - _dev->gRdB;
-   
-   _bufi.reserve(SDRPLAY_MAX_BUF_SIZE);
-   _bufq.reserve(SDRPLAY_MAX_BUF_SIZE);   
 
-   _buf_mutex.lock();
-   _buf_offset = 0;
-   _buf_mutex.unlock();
+   /* packets are kept planar, the I/Q interleave happens in work() */
+   _bufi.resize(_buf_num * SDRPLAY_MAX_BUF_SIZE);
+   _bufq.resize(_buf_num * SDRPLAY_MAX_BUF_SIZE);
+   _buf_len.resize(_buf_num);
 }
 
 /*
@@ -142,40 +159,142 @@ sdrplay_source_c::sdrplay_source_c (const std::string &args)
  */
 sdrplay_source_c::~sdrplay_source_c ()
 {
-   free(_dev);
-   _dev = NULL;
-   _buf_mutex.lock();
    if (_running)
    {
-      _running = false;
+      stop();
    }
-   _uninit = true;
-   _buf_mutex.unlock();
+   free(_dev);
+   _dev = NULL;
 }
 
+/*
+ * Full API re-initialisation. Only needed for changes the streaming API
+ * can't apply on the fly (bandwidth, IF mode, out of band retunes).
+ * The reader thread keeps running and simply waits on _dev_mutex.
+ */
 void sdrplay_source_c::reinit_device()
 {
-   std::cerr << "reinit_device started" << std::endl;
-   _buf_mutex.lock();
-   std::cerr << "after mutex.lock" << std::endl;
+   if (_defer_reinit)
+   {
+      _reinit_due = true;
+      return;
+   }
+
+   std::lock_guard<std::mutex> lock( _dev_mutex );
+
    if (_running)
    {
-      std::cerr << "mir_sdr_Uninit started" << std::endl;
       mir_sdr_Uninit();
    }
 
-   std::cerr << "mir_sdr_Init started" << std::endl;
+   /* the reader sizes its packet buffers to what this reports */
    mir_sdr_Init(_dev->gRdB, _dev->fsHz / 1e6, _dev->rfHz / 1e6, _dev->bwType, _dev->ifType, &_dev->samplesPerPacket);
 
    if (_dev->dcMode)
    {
-      std::cerr << "mir_sdr_SetDcMode started" << std::endl;
       mir_sdr_SetDcMode(4, 1);
    }
+}
+
+bool sdrplay_source_c::start()
+{
+   reinit_device();
+
+   {
+      std::lock_guard<std::mutex> lock( _buf_mutex );
+      _buf_head = _buf_used = 0;
+      _buf_offset = 0;
+      _running = true;
+   }
+
+   _thread = gr::thread::thread(_sdrplay_wait, this);
+
+   return true;
+}
+
+bool sdrplay_source_c::stop()
+{
+   {
+      std::lock_guard<std::mutex> lock( _buf_mutex );
+      _running = false;
+   }
+   _buf_cond.notify_one();
+
+   if (_thread.joinable())
+   {
+      _thread.join();
+   }
+
+   std::lock_guard<std::mutex> lock( _dev_mutex );
+   mir_sdr_Uninit();
+
+   return true;
+}
+
+void sdrplay_source_c::_sdrplay_wait(sdrplay_source_c *obj)
+{
+   obj->sdrplay_wait();
+}
+
+void sdrplay_source_c::sdrplay_wait()
+{
+   std::vector< short > xi(SDRPLAY_MAX_BUF_SIZE);
+   std::vector< short > xq(SDRPLAY_MAX_BUF_SIZE);
+   unsigned int sampNum;
+   int grChanged;
+   int rfChanged;
+   int fsChanged;
+
+   while (_running)
+   {
+      mir_sdr_ErrT err;
+      int len;
+
+      {
+         std::lock_guard<std::mutex> lock( _dev_mutex );
+         len = _dev->samplesPerPacket;
+         if (xi.size() < size_t(len))
+         {
+            /* mir_sdr_ReadPacket() writes all of them */
+            xi.resize(len);
+            xq.resize(len);
+         }
+         err = mir_sdr_ReadPacket(xi.data(), xq.data(), &sampNum, &grChanged, &rfChanged, &fsChanged);
+      }
+
+      if (err != mir_sdr_Success)
+      {
+         boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+         continue;
+      }
+
+      {
+         std::lock_guard<std::mutex> lock( _buf_mutex );
+
+         /* packets longer than a slot take several of them */
+         unsigned int slots = (len + SDRPLAY_MAX_BUF_SIZE - 1) / SDRPLAY_MAX_BUF_SIZE;
+
+         if (_buf_used + slots > _buf_num)
+         {
+            /* drop the new packet, work() may be reading the oldest one */
+            _overflows++;
+            std::cerr << "O" << std::flush;
+            continue;
+         }
+
+         for (int offset = 0; offset < len; offset += SDRPLAY_MAX_BUF_SIZE)
+         {
+            int part = std::min(len - offset, SDRPLAY_MAX_BUF_SIZE);
+            unsigned int buf_tail = (_buf_head + _buf_used) % _buf_num;
+            memcpy(&_bufi[buf_tail * SDRPLAY_MAX_BUF_SIZE], xi.data() + offset, part * sizeof(short));
+            memcpy(&_bufq[buf_tail * SDRPLAY_MAX_BUF_SIZE], xq.data() + offset, part * sizeof(short));
+            _buf_len[buf_tail] = part;
+            _buf_used++;
+         }
+      }
 
-   _buf_offset = 0;
-   _buf_mutex.unlock();
-   std::cerr << "reinit_device end" << std::endl;
+      _buf_cond.notify_one();
+   }
 }
 
 void sdrplay_source_c::set_gain_limits(double freq)
@@ -212,57 +331,50 @@ int sdrplay_source_c::work( int noutput_items,
                             gr_vector_void_star &output_items )
 {
    gr_complex *out = (gr_complex *)output_items[0];
-   int cnt = noutput_items;
-   unsigned int sampNum;
-   int grChanged;
-   int rfChanged;
-   int fsChanged;
+   unsigned int buf_used;
 
-   if (_uninit)
    {
-      return WORK_DONE;
+      std::unique_lock<std::mutex> lock( _buf_mutex );
+
+      while (!_buf_used && _running)
+         _buf_cond.wait( lock );
+
+      buf_used = _buf_used;
    }
 
    if (!_running)
    {
-      reinit_device();
-      _running = true;
+      return WORK_DONE;
    }
 
-   _buf_mutex.lock();
-
-   if (_buf_offset)
+   /* the reader only ever appends, so the packets counted above are ours */
+   while (noutput_items && buf_used)
    {
-      for (int i = _buf_offset; i < _dev->samplesPerPacket; i++)
-      {
-         *out++ = gr_complex( float(_bufi[i]) * (1.0f/2048.0f), float(_bufq[i]) * (1.0f/2048.0f) );
-      }
-      cnt -= (_dev->samplesPerPacket - _buf_offset);
-   }
+      const unsigned int slot = _buf_head;
+      const int nout = std::min(noutput_items, _buf_len[slot] - _buf_offset);
+      const size_t base = slot * SDRPLAY_MAX_BUF_SIZE + _buf_offset;
 
-   while ((cnt - _dev->samplesPerPacket) >= 0)
-   {
-      mir_sdr_ReadPacket(_bufi.data(), _bufq.data(), &sampNum, &grChanged, &rfChanged, &fsChanged);
-      for (int i = 0; i < _dev->samplesPerPacket; i++)
-      {
-         *out++ = gr_complex( float(_bufi[i]) * (1.0f/2048.0f), float(_bufq[i]) * (1.0f/2048.0f) );
-      }
-      cnt -= _dev->samplesPerPacket;
-   }
+      convert_16i_planar_to_32fc(&_bufi[base], &_bufq[base], (float *)out,
+                                 nout, 1.0f/2048.0f);
 
-   _buf_offset = 0;
-   if (cnt)
-   {
-      mir_sdr_ReadPacket(_bufi.data(), _bufq.data(), &sampNum, &grChanged, &rfChanged, &fsChanged);
-      for (int i = 0; i < cnt; i++)
+      out += nout;
+      noutput_items -= nout;
+      _buf_offset += nout;
+
+      if (_buf_offset == _buf_len[slot])
       {
-         *out++ = gr_complex( float(_bufi[i]) * (1.0f/2048.0f), float(_bufq[i]) * (1.0f/2048.0f) );
+         {
+            std::lock_guard<std::mutex> lock( _buf_mutex );
+
+            _buf_head = (_buf_head + 1) % _buf_num;
+            _buf_used--;
+         }
+         buf_used--;
+         _buf_offset = 0;
       }
-      _buf_offset = cnt;
    }
-   _buf_mutex.unlock();
 
-   return noutput_items;
+   return (out - ((gr_complex *)output_items[0]));
 }
 
 std::vector<std::string> sdrplay_source_c::get_devices()
@@ -298,6 +410,11 @@ size_t sdrplay_source_c::get_num_channels()
    return 1;
 }
 
+uint64_t sdrplay_source_c::get_overflows()
+{
+   return _overflows;
+}
+
 osmosdr::meta_range_t sdrplay_source_c::get_sample_rates()
 {
    osmosdr::meta_range_t range;
@@ -309,26 +426,20 @@ osmosdr::meta_range_t sdrplay_source_c::get_sample_rates()
 
 double sdrplay_source_c::set_sample_rate(double rate)
 {
-   std::cerr << "set_sample_rate start" << std::endl;
-   double diff = rate - _dev->fsHz;
    _dev->fsHz = rate;
 
-   std::cerr << "rate = " << rate << std::endl;
-   std::cerr << "diff = " << diff << std::endl;
-   if (_running) 
+   if (_running)
    {
-      if (fabs(diff) < 10000.0)
+      mir_sdr_ErrT err;
       {
-         std::cerr << "mir_sdr_SetFs started" << std::endl;
-         mir_sdr_SetFs(diff, 0, 0, 0);
+         std::lock_guard<std::mutex> lock( _dev_mutex );
+         err = mir_sdr_SetFs(rate, 1, 0, 0); /* absolute update */
       }
-      else
+      if (err != mir_sdr_Success)
       {
-         std::cerr << "reinit_device started" << std::endl;
          reinit_device();
       }
    }
-   std::cerr << "set_sample_rate end" << std::endl;
 
    return get_sample_rate();
 }
@@ -359,27 +470,23 @@ osmosdr::freq_range_t sdrplay_source_c::get_freq_range( size_t chan )
 
 double sdrplay_source_c::set_center_freq( double freq, size_t chan )
 {
-   std::cerr << "set_center_freq start" << std::endl;
-   std::cerr << "freq = " << freq << std::endl;
-   double diff = freq - _dev->rfHz;
-   std::cerr << "diff = " << diff << std::endl;
    _dev->rfHz = freq;
    set_gain_limits(freq);
-   if (_running) 
+   if (_running)
    {
-      if (fabs(diff) < 10000.0)
+      /* absolute retunes stay within the streaming API, only a band
+       * change rejected by the tuner needs the full re-initialisation */
+      mir_sdr_ErrT err;
       {
-         std::cerr << "mir_sdr_SetRf started" << std::endl;
-         mir_sdr_SetRf(diff, 0, 0);
+         std::lock_guard<std::mutex> lock( _dev_mutex );
+         err = mir_sdr_SetRf(freq, 1, 0);
       }
-      else
+      if (err != mir_sdr_Success)
       {
-         std::cerr << "reinit_device started" << std::endl;
          reinit_device();
       }
    }
 
-   std::cerr << "set_center_freq end" << std::endl;
    return get_center_freq( chan );
 }
 
@@ -452,9 +559,7 @@ bool sdrplay_source_c::get_gain_mode( size_t chan )
 
 double sdrplay_source_c::set_gain( double gain, size_t chan )
 {
-   std::cerr << "set_gain started" << std::endl;
    _dev->gain_dB = gain;
-   std::cerr << "gain = " << gain << std::endl;
    if (gain < _dev->minGain)
    {
       _dev->gain_dB = _dev->minGain;
@@ -465,14 +570,13 @@ double sdrplay_source_c::set_gain( double gain, size_t chan )
    }
    _dev->gRdB = (int)(_dev->maxGain - gain);
 
-   if (_running) 
+   if (_running)
    {
-      std::cerr << "mir_sdr_SetGr started" << std::endl;
+      std::lock_guard<std::mutex> lock( _dev_mutex );
       mir_sdr_SetGr(_dev->gRdB, 1, 0);
    }
 
-std::cerr << "set_gain end" << std::endl;
-return get_gain( chan );
+   return get_gain( chan );
 }
 
 double sdrplay_source_c::set_gain( double gain, const std::string & name, size_t chan)
@@ -522,6 +626,7 @@ void sdrplay_source_c::set_dc_offset_mode( int mode, size_t chan )
       _dev->dcMode = 0;
       if (_running)
       {
+         std::lock_guard<std::mutex> lock( _dev_mutex );
          mir_sdr_SetDcMode(4, 1);
       }
    }
@@ -531,6 +636,7 @@ void sdrplay_source_c::set_dc_offset_mode( int mode, size_t chan )
       _dev->dcMode = 0;
       if (_running)
       {
+         std::lock_guard<std::mutex> lock( _dev_mutex );
          mir_sdr_SetDcMode(4, 1);
       }
    }
@@ -539,6 +645,7 @@ void sdrplay_source_c::set_dc_offset_mode( int mode, size_t chan )
       _dev->dcMode = 1;
       if (_running)
       {
+         std::lock_guard<std::mutex> lock( _dev_mutex );
          mir_sdr_SetDcMode(4, 1);
       }
    }
@@ -598,3 +705,35 @@ osmosdr::freq_range_t sdrplay_source_c::get_bandwidth_range( size_t chan )
 
    return range;
 }
+
+/*
+ * The settings of a profile switch go into _dev one by one, the full
+ * re-initialisation some of them need happens once at the end.
+ */
+void sdrplay_source_c::configure( const channel_config &config, size_t chan )
+{
+   _defer_reinit = true;
+   _reinit_due = false;
+
+   try
+   {
+      apply_channel_config( *this, config, chan );
+   }
+   catch (...)
+   {
+      /* what was applied before the failure still reaches the device */
+      _defer_reinit = false;
+      if (_reinit_due)
+      {
+         reinit_device();
+      }
+      throw;
+   }
+
+   _defer_reinit = false;
+
+   if (_reinit_due)
+   {
+      reinit_device();
+   }
+}
@@ -25,12 +25,15 @@
 
 #include <gnuradio/thread/thread.h>
 
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 
 #include "osmosdr/ranges.h"
 
 #include "source_iface.h"
+#include "direct_block.h"
+#include "pool_helpers.h"
 
 class sdrplay_source_c;
 typedef struct sdrplay_dev sdrplay_dev_t;
@@ -62,7 +65,7 @@ sdrplay_source_c_sptr make_sdrplay_source_c (const std::string & args = "");
  * \ingroup block
  */
 class sdrplay_source_c :
-    public gr::sync_block,
+    public direct_block,
     public source_iface
 {
 private:
@@ -86,6 +89,7 @@ public:
    static std::vector< std::string > get_devices();
 
    size_t get_num_channels( void );
+   uint64_t get_overflows( void );
 
    osmosdr::meta_range_t get_sample_rates( void );
    double set_sample_rate( double rate );
@@ -112,26 +116,47 @@ public:
    std::string get_antenna( size_t chan = 0 );
 
    void set_dc_offset_mode( int mode, size_t chan = 0 );
+   bool has_dc_offset_mode( size_t chan = 0 ) { return true; }
    void set_dc_offset( const std::complex<double> &offset, size_t chan = 0 );
 
    double set_bandwidth( double bandwidth, size_t chan = 0 );
    double get_bandwidth( size_t chan = 0 );
    osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 );
 
+   void configure( const channel_config &config, size_t chan = 0 );
+
+protected:
+   bool start();
+   bool stop();
+
 private:
+   static void _sdrplay_wait(sdrplay_source_c *obj);
+   void sdrplay_wait();
    void reinit_device(void);
    void set_gain_limits(double freq);
 
    sdrplay_dev_t *_dev;
-
-   std::vector< short > _bufi;
-   std::vector< short > _bufq;
+   std::mutex _dev_mutex;
+
+   gr::thread::thread _thread;
+   typedef std::vector< short, pool_allocator< short > > plane_t;
+   plane_t _bufi;
+   plane_t _bufq;
+   std::vector< int > _buf_len;
+   unsigned int _buf_num;
+   unsigned int _buf_head;
+   unsigned int _buf_used;
    int _buf_offset;
    std::mutex _buf_mutex;
+   std::condition_variable _buf_cond;
 
-   bool _running;
-   bool _uninit;
+   std::atomic<bool> _running;
    bool _auto_gain;
+
+   std::atomic<bool> _defer_reinit;  /* within configure(), note a reinit_device() as due */
+   std::atomic<bool> _reinit_due;
+
+   std::atomic<uint64_t> _overflows{0};
 };
 
 #endif /* INCLUDED_SDRPLAY_SOURCE_C_H */
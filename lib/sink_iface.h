@@ -25,6 +25,10 @@
 #include <osmosdr/time_spec.h>
 #include <gnuradio/basic_block.h>
 
+#include <map>
+
+#include "config_helpers.h"
+
 /*!
  * TODO: document
  *
@@ -40,6 +44,16 @@ public:
    */
   virtual size_t get_num_channels( void ) = 0;
 
+  /*!
+   * Get the streaming statistics of the device, see stats_helpers.h.
+   * \param chan the channel index 0 to N-1
+   * \return the figures by name, empty for backends not keeping them
+   */
+  virtual std::map< std::string, double > get_stats( size_t chan = 0 )
+  {
+    return std::map< std::string, double >();
+  }
+
   /*!
    * Get the possible sample rates for the underlying radio hardware.
    * \return a range of rates in Sps
@@ -258,6 +272,17 @@ public:
   virtual osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 )
     { return osmosdr::freq_range_t(); }
 
+  /*!
+   * Apply several settings of a channel at once.
+   * Goes through the single setters by default, backends reconfiguring
+   * the hardware or restarting the stream on more than one of them
+   * override this to do so only once.
+   * \param config the settings given, see config_helpers.h
+   * \param chan the channel index 0 to N-1
+   */
+  virtual void configure( const channel_config &config, size_t chan = 0 )
+    { apply_channel_config( *this, config, chan ); }
+
   /*!
    * Set the time source for the device.
    * This sets the method of time synchronization,
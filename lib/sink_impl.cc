@@ -45,6 +45,9 @@
 #ifdef ENABLE_REDPITAYA
 #include "redpitaya_sink_c.h"
 #endif
+#ifdef ENABLE_VRT
+#include "vrt_sink_c.h"
+#endif
 #ifdef ENABLE_FREESRP
 #include <freesrp_sink_c.h>
 #endif
@@ -56,28 +59,15 @@
 #endif
 
 #include "arg_helpers.h"
+#include "worker_helpers.h"
 #include "sink_impl.h"
 
 /*
- * Create a new instance of sink_impl and return
- * a boost shared_ptr.  This is effectively the public constructor.
+ * The device arguments given in args, the first device found is appended
+ * when none of them names a built-in device type.
  */
-osmosdr::sink::sptr
-osmosdr::sink::make( const std::string &args )
+std::vector< std::string > sink_device_args( const std::string &args )
 {
-  return gnuradio::get_initial_sptr( new sink_impl(args) );
-}
-
-/*
- * The private constructor
- */
-sink_impl::sink_impl( const std::string &args )
-  : gr::hier_block2 ("sink_impl",
-        args_to_io_signature(args),
-        gr::io_signature::make(0, 0, 0)),
-    _sample_rate(NAN)
-{
-  size_t channel = 0;
   bool device_specified = false;
 
   std::vector< std::string > arg_list = args_to_vector(args);
@@ -99,6 +89,9 @@ sink_impl::sink_impl( const std::string &args )
 #ifdef ENABLE_REDPITAYA
   dev_types.push_back("redpitaya");
 #endif
+#ifdef ENABLE_VRT
+  dev_types.push_back("vrt");
+#endif
 #ifdef ENABLE_FREESRP
   dev_types.push_back("freesrp");
 #endif
@@ -149,6 +142,10 @@ sink_impl::sink_impl( const std::string &args )
     for (std::string dev : redpitaya_sink_c::get_devices())
       dev_list.push_back( dev );
 #endif
+#ifdef ENABLE_VRT
+    for (std::string dev : vrt_sink_c::get_devices())
+      dev_list.push_back( dev );
+#endif
 #ifdef ENABLE_FREESRP
     for (std::string dev : freesrp_sink_c::get_devices())
       dev_list.push_back( dev );
@@ -172,71 +169,134 @@ sink_impl::sink_impl( const std::string &args )
       throw std::runtime_error("No supported devices found (check the connection and/or udev rules).");
   }
 
-  for (std::string arg : arg_list) {
+  return arg_list;
+}
 
-    dict_t dict = params_to_dict(arg);
+/*
+ * Create the backend for a single device argument, block and iface are
+ * left empty when it names none.
+ */
+gr::basic_block_sptr make_sink_device( const std::string &arg, sink_iface *&iface )
+{
+  dict_t dict = params_to_dict(arg);
 
-//    std::cerr << std::endl;
-//    for (dict_t::value_type &entry : dict)
-//      std::cerr << "'" << entry.first << "' = '" << entry.second << "'" << std::endl;
+//  std::cerr << std::endl;
+//  for (dict_t::value_type &entry : dict)
+//    std::cerr << "'" << entry.first << "' = '" << entry.second << "'" << std::endl;
 
-    sink_iface *iface = NULL;
-    gr::basic_block_sptr block;
+  gr::basic_block_sptr block;
+  iface = NULL;
 
 #ifdef ENABLE_UHD
-    if ( dict.count("uhd") ) {
-      uhd_sink_c_sptr sink = make_uhd_sink_c( arg );
-      block = sink; iface = sink.get();
-    }
+  if ( dict.count("uhd") ) {
+    uhd_sink_c_sptr sink = make_uhd_sink_c( arg );
+    block = sink; iface = sink.get();
+  }
 #endif
 #ifdef ENABLE_HACKRF
-    if ( dict.count("hackrf") ) {
-      hackrf_sink_c_sptr sink = make_hackrf_sink_c( arg );
-      block = sink; iface = sink.get();
-    }
+  if ( dict.count("hackrf") ) {
+    hackrf_sink_c_sptr sink = make_hackrf_sink_c( arg );
+    block = sink; iface = sink.get();
+  }
 #endif
 #ifdef ENABLE_BLADERF
-    if ( dict.count("bladerf") ) {
-      bladerf_sink_c_sptr sink = make_bladerf_sink_c( arg );
-      block = sink; iface = sink.get();
-    }
+  if ( dict.count("bladerf") ) {
+    bladerf_sink_c_sptr sink = make_bladerf_sink_c( arg );
+    block = sink; iface = sink.get();
+  }
 #endif
 #ifdef ENABLE_SOAPY
-    if ( dict.count("soapy") ) {
-      soapy_sink_c_sptr sink = make_soapy_sink_c( arg );
-      block = sink; iface = sink.get();
-    }
+  if ( dict.count("soapy") ) {
+    soapy_sink_c_sptr sink = make_soapy_sink_c( arg );
+    block = sink; iface = sink.get();
+  }
 #endif
 #ifdef ENABLE_REDPITAYA
-    if ( dict.count("redpitaya") ) {
-      redpitaya_sink_c_sptr sink = make_redpitaya_sink_c( arg );
-      block = sink; iface = sink.get();
-    }
+  if ( dict.count("redpitaya") ) {
+    redpitaya_sink_c_sptr sink = make_redpitaya_sink_c( arg );
+    block = sink; iface = sink.get();
+  }
+#endif
+#ifdef ENABLE_VRT
+  if ( dict.count("vrt") ) {
+    vrt_sink_c_sptr sink = make_vrt_sink_c( arg );
+    block = sink; iface = sink.get();
+  }
 #endif
 #ifdef ENABLE_FREESRP
-    if ( dict.count("freesrp") ) {
-      freesrp_sink_c_sptr sink = make_freesrp_sink_c( arg );
-      block = sink; iface = sink.get();
-    }
+  if ( dict.count("freesrp") ) {
+    freesrp_sink_c_sptr sink = make_freesrp_sink_c( arg );
+    block = sink; iface = sink.get();
+  }
 #endif
 #ifdef ENABLE_XTRX
-    if ( dict.count("xtrx") ) {
-      xtrx_sink_c_sptr sink = make_xtrx_sink_c( arg );
-      block = sink; iface = sink.get();
-    }
+  if ( dict.count("xtrx") ) {
+    xtrx_sink_c_sptr sink = make_xtrx_sink_c( arg );
+    block = sink; iface = sink.get();
+  }
 #endif
 #ifdef ENABLE_FILE
-    if ( dict.count("file") ) {
-      file_sink_c_sptr sink = make_file_sink_c( arg );
-      block = sink; iface = sink.get();
-    }
+  if ( dict.count("file") ) {
+    file_sink_c_sptr sink = make_file_sink_c( arg );
+    block = sink; iface = sink.get();
+  }
 #endif
 
+  return block;
+}
+
+/*
+ * Create a new instance of sink_impl and return
+ * a boost shared_ptr.  This is effectively the public constructor.
+ */
+osmosdr::sink::sptr
+osmosdr::sink::make( const std::string &args )
+{
+  return gnuradio::get_initial_sptr( new sink_impl(args) );
+}
+
+/*
+ * The private constructor
+ */
+sink_impl::sink_impl( const std::string &args )
+  : gr::hier_block2 ("sink_impl",
+        args_to_io_signature(args),
+        gr::io_signature::make(0, 0, 0)),
+    _sample_rate(NAN)
+{
+  size_t channel = 0;
+
+  std::vector< std::string > arg_list = sink_device_args(args);
+  std::string item_type = args_to_item_type(args);
+  size_t item_size = args_to_item_size(args);
+
+  /* the backends take integer items themselves where they can */
+  for (std::string &arg : arg_list)
+    if ( item_size != sizeof(gr_complex) && ! is_global_argument()( arg ) &&
+         ! params_to_dict( arg ).count("item_type") )
+      arg += ",item_type=" + item_type;
+
+  /* opened all at once, wired up in the order given */
+  std::vector< gr::basic_block_sptr > blocks;
+  std::vector< sink_iface * > ifaces;
+  open_devices( arg_list, args_to_open_threads(args), make_sink_device, blocks, ifaces );
+
+  for (size_t dev = 0; dev < arg_list.size(); dev++) {
+    sink_iface *iface = ifaces[dev];
+    gr::basic_block_sptr block = blocks[dev];
+
     if (iface != NULL && reinterpret_cast<std::intptr_t>(block.get()) != 0) {
       _devs.push_back( iface );
 
       for (size_t i = 0; i < iface->get_num_channels(); i++) {
-        connect(self(), channel++, block, i);
+        /* the others get converted to complex float */
+        if ( block->input_signature()->sizeof_stream_item( i ) != int(item_size) ) {
+          gr::basic_block_sptr conv = make_convert_ic( item_size );
+          connect(self(), channel++, conv, 0);
+          connect(conv, 0, block, i);
+        } else {
+          connect(self(), channel++, block, i);
+        }
       }
     } else if ((iface != NULL) || (reinterpret_cast<std::intptr_t>(block.get()) != 0))
       throw std::runtime_error("Either iface or block are NULL.");
@@ -603,6 +663,90 @@ osmosdr::freq_range_t sink_impl::get_bandwidth_range( size_t chan )
   return osmosdr::freq_range_t();
 }
 
+void sink_impl::configure( const std::map< std::string, std::string > &settings,
+                           size_t chan )
+{
+  channel_config config = dict_to_channel_config( settings );
+
+  sink_iface *target = NULL;
+  size_t target_chan = 0;
+
+  size_t channel = 0;
+  for (sink_iface *dev : _devs)
+    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
+      if ( chan == channel++ ) {
+        target = dev;
+        target_chan = dev_chan;
+      }
+
+  if ( ! target )
+    return;
+
+  /* drop what is in effect already, as the single setters do */
+  if ( config.has_freq ) {
+    config.has_freq = _center_freq[ chan ] != config.freq;
+    _center_freq[ chan ] = config.freq;
+  }
+
+  if ( config.has_corr ) {
+    config.has_corr = _freq_corr[ chan ] != config.corr;
+    _freq_corr[ chan ] = config.corr;
+  }
+
+  if ( config.has_bandwidth ) {
+    config.has_bandwidth = _bandwidth[ chan ] != config.bandwidth ||
+                           0.0f == config.bandwidth;
+    _bandwidth[ chan ] = config.bandwidth;
+  }
+
+  if ( config.has_antenna ) {
+    config.has_antenna = _antenna[ chan ] != config.antenna;
+    _antenna[ chan ] = config.antenna;
+  }
+
+  bool to_manual = false;
+  if ( config.has_gain_mode ) {
+    config.has_gain_mode = ( _gain_mode.count( chan ) == 0 ) ||
+                           ( _gain_mode[ chan ] != config.gain_mode );
+    _gain_mode[ chan ] = config.gain_mode;
+    to_manual = config.has_gain_mode && ! config.gain_mode;
+  }
+
+  if ( config.has_gain ) {
+    config.has_gain = _gain[ chan ] != config.gain;
+    _gain[ chan ] = config.gain;
+  }
+
+  if ( to_manual ) { /* reapply the gain value when switched to manual mode */
+    config.has_gain = true;
+    config.gain = _gain[ chan ];
+  }
+
+  if ( config.has_if_gain ) {
+    config.has_if_gain = _if_gain[ chan ] != config.if_gain;
+    _if_gain[ chan ] = config.if_gain;
+  }
+
+  if ( config.has_bb_gain ) {
+    config.has_bb_gain = _bb_gain[ chan ] != config.bb_gain;
+    _bb_gain[ chan ] = config.bb_gain;
+  }
+
+  /* the rate is shared, the other devices of the group get it on its own */
+  if ( config.has_rate && _sample_rate != config.rate ) {
+    for (sink_iface *dev : _devs)
+      if ( dev != target )
+        dev->set_sample_rate( config.rate );
+  } else {
+    config.has_rate = false;
+  }
+
+  target->configure( config, target_chan );
+
+  if ( config.has_rate )
+    _sample_rate = target->get_sample_rate();
+}
+
 void sink_impl::set_time_source(const std::string &source, const size_t mboard)
 {
   if (mboard != osmosdr::ALL_MBOARDS){
@@ -701,3 +845,14 @@ void sink_impl::set_time_unknown_pps(const osmosdr::time_spec_t &time_spec)
     dev->set_time_unknown_pps( time_spec );
   }
 }
+
+std::map< std::string, double > sink_impl::get_stats( size_t chan )
+{
+  size_t channel = 0;
+  for (sink_iface *dev : _devs)
+    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
+      if ( chan == channel++ )
+        return dev->get_stats( dev_chan );
+
+  return std::map< std::string, double >();
+}
@@ -24,8 +24,14 @@
 
 #include "sink_iface.h"
 
+#include "convert_ic.h"
+
 #include <map>
 
+/* device argument handling shared with osmosdr::stream */
+std::vector< std::string > sink_device_args( const std::string &args );
+gr::basic_block_sptr make_sink_device( const std::string &arg, sink_iface *&iface );
+
 class sink_impl : public osmosdr::sink
 {
 public:
@@ -68,6 +74,9 @@ public:
   double get_bandwidth( size_t chan = 0 );
   osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 );
 
+  void configure( const std::map< std::string, std::string > &settings,
+                  size_t chan = 0 );
+
   void set_time_source(const std::string &source, const size_t mboard = 0);
   std::string get_time_source(const size_t mboard);
   std::vector<std::string> get_time_sources(const size_t mboard);
@@ -82,6 +91,8 @@ public:
   void set_time_next_pps(const ::osmosdr::time_spec_t &time_spec);
   void set_time_unknown_pps(const ::osmosdr::time_spec_t &time_spec);
 
+  std::map< std::string, double > get_stats( size_t chan = 0 );
+
 private:
   std::vector< sink_iface * > _devs;
 
@@ -34,17 +34,40 @@
 #include <boost/assign.hpp>
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string.hpp>
 
 #include <gnuradio/io_signature.h>
 
 #include "arg_helpers.h"
+#include "convert_helpers.h"
 #include "soapy_sink_c.h"
 #include "soapy_common.h"
 #include <SoapySDR/Device.hpp>
+#include <SoapySDR/Formats.hpp>
 #include <SoapySDR/Version.hpp>
 
 using namespace boost::assign;
 
+static const pmt::pmt_t SOB_KEY = pmt::string_to_symbol("tx_sob");
+static const pmt::pmt_t EOB_KEY = pmt::string_to_symbol("tx_eob");
+static const pmt::pmt_t TIME_KEY = pmt::string_to_symbol("tx_time");
+
+/* by offset, and at the same offset tx_time before tx_sob before tx_eob */
+static int burst_tag_rank(const gr::tag_t &tag)
+{
+    if (pmt::equal(tag.key, TIME_KEY)) return 0;
+    if (pmt::equal(tag.key, SOB_KEY)) return 1;
+    if (pmt::equal(tag.key, EOB_KEY)) return 3;
+    return 2;
+}
+
+static bool burst_tag_compare(const gr::tag_t &a, const gr::tag_t &b)
+{
+    if (a.offset != b.offset)
+        return a.offset < b.offset;
+    return burst_tag_rank(a) < burst_tag_rank(b);
+}
+
 /*
  * Create a new instance of soapy_sink_c and return
  * a boost shared_ptr.  This is effectively the public constructor.
@@ -58,18 +81,68 @@ soapy_sink_c_sptr make_soapy_sink_c (const std::string &args)
  * The private constructor
  */
 soapy_sink_c::soapy_sink_c (const std::string &args)
-  : gr::sync_block ("soapy_sink_c",
+  : direct_block ("soapy_sink_c",
                     args_to_io_signature(args),
-                    gr::io_signature::make (0, 0, 0))
+                    gr::io_signature::make (0, 0, 0)),
+    _has_time(false),
+    _time_ns(0)
 {
+    dict_t dict = params_to_dict(args);
     {
         std::lock_guard<std::mutex> l(get_soapy_maker_mutex());
-        _device = SoapySDR::Device::make(params_to_dict(args));
+        _device = SoapySDR::Device::make(dict);
     }
     _nchan = std::max(1, args_to_io_signature(args)->max_streams());
     std::vector<size_t> channels;
     for (size_t i = 0; i < _nchan; i++) channels.push_back(i);
-    _stream = _device->setupStream(SOAPY_SDR_TX, "CF32", channels);
+
+    /* prefer the native integer format of the device to save the driver
+     * a conversion pass, format=CF32|CS16|CS8 overrides the choice. Integer
+     * items go out in their own format. */
+    double full_scale = 0.0;
+    const std::string native = _device->getNativeStreamFormat(SOAPY_SDR_TX, 0, full_scale);
+    const std::vector<std::string> formats = _device->getStreamFormats(SOAPY_SDR_TX, 0);
+    const std::string item_type = args_to_item_type(args);
+
+    _item_size = item_type_size(item_type);
+
+    _format = SOAPY_SDR_CF32;
+    if (item_type == "sc16")
+        _format = SOAPY_SDR_CS16;
+    else if (item_type == "sc8")
+        _format = SOAPY_SDR_CS8;
+    else if (dict.count("format"))
+        _format = boost::to_upper_copy(dict["format"]);
+    else if (native == SOAPY_SDR_CS16 || native == SOAPY_SDR_CS8)
+        _format = native;
+
+    if (_format != SOAPY_SDR_CF32 &&
+        _format != SOAPY_SDR_CS16 &&
+        _format != SOAPY_SDR_CS8)
+        throw std::runtime_error("Unsupported TX stream format " + _format);
+
+    if (std::find(formats.begin(), formats.end(), _format) == formats.end()) {
+        const std::string fallback = (_item_size == sizeof(gr_complex)) ?
+                                     SOAPY_SDR_CF32 : SOAPY_SDR_CS16;
+        if (_item_size == 2 * sizeof(int16_t))
+            throw std::runtime_error("SoapySDR TX stream does not offer " + _format);
+
+        std::cerr << "SoapySDR TX stream does not offer " << _format
+                  << ", using " << fallback << std::endl;
+        _format = fallback;
+    }
+
+    if (_format == SOAPY_SDR_CF32)
+        _scale = 1.0f;
+    else if (_format == native && full_scale > 0.0)
+        _scale = float(full_scale);
+    else
+        _scale = (_format == SOAPY_SDR_CS16) ? 32767.0f : 127.0f;
+
+    _convbuf.resize(_nchan);
+    _bufs.resize(_nchan);
+
+    _stream = _device->setupStream(SOAPY_SDR_TX, _format, channels);
 }
 
 soapy_sink_c::~soapy_sink_c(void)
@@ -93,16 +166,98 @@ int soapy_sink_c::work( int noutput_items,
                             gr_vector_const_void_star &input_items,
                             gr_vector_void_star &output_items )
 {
+    const uint64_t samp0_count = nitems_read(0);
+    int nitems = noutput_items;
+    bool eob = false;
+
+    get_tags_in_range(_tags, 0, samp0_count, samp0_count + noutput_items);
+    std::stable_sort(_tags.begin(), _tags.end(), burst_tag_compare);
+
+    /* Each write covers at most one burst segment: a tx_sob or tx_time tag
+     * starts a new write, a tx_eob tag ends it on the tagged sample. */
+    for (const gr::tag_t &tag : _tags) {
+        const int offset = int(tag.offset - samp0_count);
+
+        if (pmt::equal(tag.key, SOB_KEY) || pmt::equal(tag.key, TIME_KEY)) {
+            if (offset > 0) {
+                nitems = offset;
+                break;
+            }
+            if (pmt::equal(tag.key, TIME_KEY)) {
+                ::osmosdr::time_spec_t time(
+                    time_t(pmt::to_uint64(pmt::tuple_ref(tag.value, 0))),
+                    pmt::to_double(pmt::tuple_ref(tag.value, 1)));
+                _time_ns = time.to_ticks(1e9);
+                _has_time = true;
+            }
+        } else if (pmt::equal(tag.key, EOB_KEY)) {
+            nitems = offset + 1;
+            eob = true;
+            break;
+        }
+    }
+
+    /* keep the burst end within a single MTU so that a partial write
+     * can never consume the END_BURST flag early */
+    const int mtu = int(_device->getStreamMTU(_stream));
+    if (eob && mtu > 0 && nitems > mtu) {
+        nitems -= mtu;
+        eob = false;
+    }
+
     int flags = 0;
-    long long timeNs = 0;
-    int ret = _device->writeStream(
-        _stream, &input_items[0],
-        noutput_items, flags, timeNs);
+    if (_has_time) flags |= SOAPY_SDR_HAS_TIME;
+    if (eob) flags |= SOAPY_SDR_END_BURST;
+
+    int ret = write_burst(input_items, nitems, flags, _time_ns);
+
+    if (ret == SOAPY_SDR_UNDERFLOW)
+        std::cerr << "U" << std::flush;
+    if (ret <= 0) return 0; //call again
+
+    /* the timestamp only applies to the first sample written */
+    _has_time = false;
 
-    if (ret < 0) return 0; //call again
     return ret;
 }
 
+int soapy_sink_c::write_burst( gr_vector_const_void_star &input_items,
+                               int nitems, int flags, long long timeNs )
+{
+    const bool cs16 = (_format == SOAPY_SDR_CS16);
+    const size_t format_size = (_format == SOAPY_SDR_CF32) ? sizeof(gr_complex) :
+                               2 * (cs16 ? sizeof(int16_t) : sizeof(int8_t));
+
+    /* the items are in the stream format already */
+    if (format_size == _item_size)
+        return _device->writeStream(_stream, &input_items[0],
+                                    nitems, flags, timeNs);
+
+    const size_t nbytes = size_t(nitems) * format_size;
+
+    for (size_t i = 0; i < _nchan; i++) {
+        std::vector<char> &buf = _convbuf[i];
+        if (buf.size() < nbytes)
+            buf.resize(nbytes);
+
+        if (_item_size == 2 * sizeof(int8_t)) {
+            /* sc8 items for a device without CS8 */
+            convert_8i_to_16i((const int8_t *) input_items[i], (int16_t *) &buf[0],
+                              2 * nitems, 8);
+        } else {
+            const float *in = (const float *) input_items[i];
+            if (cs16)
+                convert_32f_to_16i(in, (int16_t *) &buf[0], 2 * nitems, _scale);
+            else
+                convert_32f_to_8i(in, (int8_t *) &buf[0], 2 * nitems, _scale);
+        }
+
+        _bufs[i] = &buf[0];
+    }
+
+    return _device->writeStream(_stream, &_bufs[0], nitems, flags, timeNs);
+}
+
 std::vector<std::string> soapy_sink_c::get_devices()
 {
     std::vector<std::string> result;
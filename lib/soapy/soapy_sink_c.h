@@ -26,6 +26,9 @@
 
 #include "osmosdr/ranges.h"
 #include "sink_iface.h"
+#include "direct_block.h"
+
+#include <vector>
 
 class soapy_sink_c;
 
@@ -58,7 +61,7 @@ typedef std::shared_ptr<soapy_sink_c> soapy_sink_c_sptr;
 soapy_sink_c_sptr make_soapy_sink_c (const std::string & args = "");
 
 class soapy_sink_c :
-    public gr::sync_block,
+    public direct_block,
     public sink_iface
 {
 private:
@@ -130,9 +133,23 @@ void set_time_next_pps(const ::osmosdr::time_spec_t &time_spec);
 void set_time_unknown_pps(const ::osmosdr::time_spec_t &time_spec);
 
 private:
+    int write_burst( gr_vector_const_void_star &input_items,
+                     int nitems, int flags, long long timeNs );
+
     SoapySDR::Device *_device;
     SoapySDR::Stream *_stream;
     size_t _nchan;
+
+    /* wire format negotiated with the driver: CF32, CS16 or CS8 */
+    size_t _item_size;
+    std::string _format;
+    float _scale;
+    std::vector< std::vector<char> > _convbuf;
+    std::vector< const void * > _bufs;
+
+    std::vector< gr::tag_t > _tags;
+    bool _has_time;
+    long long _time_ns;
 };
 
 #endif /* INCLUDED_SOAPY_SINK_C_H */
@@ -37,11 +37,15 @@
 
 #include <gnuradio/io_signature.h>
 
+#include <volk/volk.h>
+
 #include "arg_helpers.h"
+#include "convert_helpers.h"
 #include "soapy_source_c.h"
 #include "soapy_common.h"
 #include "osmosdr/source.h"
 #include <SoapySDR/Device.hpp>
+#include <SoapySDR/Formats.hpp>
 #include <SoapySDR/Version.hpp>
 
 using namespace boost::assign;
@@ -59,9 +63,9 @@ soapy_source_c_sptr make_soapy_source_c (const std::string &args)
  * The private constructor
  */
 soapy_source_c::soapy_source_c (const std::string &args)
-  : gr::sync_block ("soapy_source_c",
-                    gr::io_signature::make (0, 0, 0),
-                    args_to_io_signature(args))
+  : direct_block ("soapy_source_c",
+                  gr::io_signature::make (0, 0, 0),
+                  args_to_io_signature(args))
 {
     {
         std::lock_guard<std::mutex> l(get_soapy_maker_mutex());
@@ -70,7 +74,46 @@ soapy_source_c::soapy_source_c (const std::string &args)
     _nchan = std::max(1, args_to_io_signature(args)->max_streams());
     std::vector<size_t> channels;
     for (size_t i = 0; i < _nchan; i++) channels.push_back(i);
-    _stream = _device->setupStream(SOAPY_SDR_RX, "CF32", channels);
+
+    /* integer item types are read as such, CS8 from CS16 for the devices
+     * which do not offer it */
+    const std::string item_type = args_to_item_type(args);
+    const std::vector<std::string> formats = _device->getStreamFormats(SOAPY_SDR_RX, 0);
+
+    _format = SOAPY_SDR_CF32;
+    if (item_type == "sc16")
+        _format = SOAPY_SDR_CS16;
+    else if (item_type == "sc8")
+        _format = SOAPY_SDR_CS8;
+
+    _narrow = false;
+    if (_format == SOAPY_SDR_CS8 &&
+        std::find(formats.begin(), formats.end(), _format) == formats.end()) {
+        _format = SOAPY_SDR_CS16;
+        _narrow = true;
+    }
+
+    /* with convert_threads=N complex float is converted here on N threads
+     * from a native CS16 stream, instead of by the driver in readStream() */
+    _workers.reset(new chunk_workers(args_to_convert_threads(params_to_dict(args))));
+
+    _widen = false;
+    if (_format == SOAPY_SDR_CF32 && _workers->threads() > 1) {
+        double full_scale = 0;
+        std::string native = _device->getNativeStreamFormat(SOAPY_SDR_RX, 0, full_scale);
+        if (native == SOAPY_SDR_CS16 && full_scale > 0) {
+            _format = SOAPY_SDR_CS16;
+            _widen = true;
+            _full_scale = float(full_scale);
+        }
+    }
+
+    if (_narrow || _widen) {
+        _convbuf.resize(_nchan);
+        _bufs.resize(_nchan);
+    }
+
+    _stream = _device->setupStream(SOAPY_SDR_RX, _format, channels);
 }
 
 soapy_source_c::~soapy_source_c(void)
@@ -99,13 +142,39 @@ int soapy_source_c::work( int noutput_items,
     int ret;
     int retries = 1;
 
+    void * const *bufs = &output_items[0];
+    if (_narrow || _widen) {
+        for (size_t i = 0; i < _nchan; i++) {
+            _convbuf[i].resize(2 * noutput_items);
+            _bufs[i] = &_convbuf[i][0];
+        }
+        bufs = &_bufs[0];
+    }
+
     do {
         ret = _device->readStream(
-            _stream, &output_items[0],
+            _stream, bufs,
             noutput_items, flags, timeNs);
     } while (retries-- && (ret == SOAPY_SDR_OVERFLOW));
 
     if (ret < 0) return 0; //call again
+
+    if (_narrow || _widen) {
+        for (size_t i = 0; i < _nchan; i++) {
+            const int16_t *conv = &_convbuf[i][0];
+            void *out = output_items[i];
+
+            _workers->run(ret, CONVERT_CHUNK, [&](size_t begin, size_t end) {
+                if (_widen)
+                    volk_16i_s32f_convert_32f((float *) out + 2 * begin, conv + 2 * begin,
+                                              _full_scale, 2 * (end - begin));
+                else
+                    convert_16i_to_8i(conv + 2 * begin, (int8_t *) out + 2 * begin,
+                                      2 * (end - begin), 8);
+            });
+        }
+    }
+
     return ret;
 }
 
@@ -309,12 +378,22 @@ void soapy_source_c::set_dc_offset( const std::complex<double> &offset, size_t c
     _device->setDCOffset(SOAPY_SDR_RX, chan, offset);
 }
 
+bool soapy_source_c::has_dc_offset_mode( size_t chan )
+{
+    return _device->hasDCOffsetMode(SOAPY_SDR_RX, chan);
+}
+
 void soapy_source_c::set_iq_balance_mode( int mode, size_t chan )
 {
     if (mode == osmosdr::source::IQBalanceOff) return; //no error on disable
     throw std::runtime_error("soapy_source_c::set_iq_balance_mode() not supported");
 }
 
+bool soapy_source_c::has_iq_balance_mode( size_t chan )
+{
+    return _device->hasIQBalance(SOAPY_SDR_RX, chan);
+}
+
 void soapy_source_c::set_iq_balance( const std::complex<double> &balance, size_t chan )
 {
     _device->setIQBalance(SOAPY_SDR_RX, chan, balance);
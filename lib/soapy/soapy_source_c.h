@@ -26,6 +26,8 @@
 
 #include "osmosdr/ranges.h"
 #include "source_iface.h"
+#include "direct_block.h"
+#include "worker_helpers.h"
 
 class soapy_source_c;
 
@@ -58,7 +60,7 @@ typedef std::shared_ptr<soapy_source_c> soapy_source_c_sptr;
 soapy_source_c_sptr make_soapy_source_c (const std::string & args = "");
 
 class soapy_source_c :
-    public gr::sync_block,
+    public direct_block,
     public source_iface
 {
 private:
@@ -108,8 +110,10 @@ std::string set_antenna( const std::string & antenna,
                                    size_t chan );
 std::string get_antenna( size_t chan );
 void set_dc_offset_mode( int mode, size_t chan );
+bool has_dc_offset_mode( size_t chan );
 void set_dc_offset( const std::complex<double> &offset, size_t chan );
 void set_iq_balance_mode( int mode, size_t chan );
+bool has_iq_balance_mode( size_t chan );
 void set_iq_balance( const std::complex<double> &balance, size_t chan );
 double set_bandwidth( double bandwidth, size_t chan );
 double get_bandwidth( size_t chan ) ;
@@ -135,6 +139,13 @@ private:
     SoapySDR::Device *_device;
     SoapySDR::Stream *_stream;
     size_t _nchan;
+    std::string _format;
+    bool _narrow;   /* sc8 items from a CS16 stream */
+    bool _widen;    /* complex float items from a native CS16 stream */
+    float _full_scale;
+    std::vector< std::vector<int16_t> > _convbuf;
+    std::vector< void * > _bufs;
+    std::unique_ptr< chunk_workers > _workers;
 };
 
 #endif /* INCLUDED_SOAPY_SOURCE_C_H */
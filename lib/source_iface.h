@@ -25,6 +25,10 @@
 #include <osmosdr/time_spec.h>
 #include <gnuradio/basic_block.h>
 
+#include <map>
+
+#include "config_helpers.h"
+
 /*!
  * TODO: document
  *
@@ -50,6 +54,23 @@ public:
    */
   virtual bool seek( long seek_point, int whence, size_t chan = 0 ) { return false; }
 
+  /*!
+   * Get the number of times the backend's sample ring overflowed and
+   * samples were lost since the device was opened.
+   * \return the overflow count, 0 for backends not counting them
+   */
+  virtual uint64_t get_overflows( void ) { return 0; }
+
+  /*!
+   * Get the streaming statistics of the device, see stats_helpers.h.
+   * \param chan the channel index 0 to N-1
+   * \return the figures by name, empty for backends not keeping them
+   */
+  virtual std::map< std::string, double > get_stats( size_t chan = 0 )
+  {
+    return std::map< std::string, double >();
+  }
+
   /*!
    * Get the possible sample rates for the underlying radio hardware.
    * \return a range of rates in Sps
@@ -241,6 +262,15 @@ public:
    */
   virtual void set_dc_offset_mode( int mode, size_t chan = 0 ) { }
 
+  /*!
+   * Whether the device corrects DC offset itself.
+   * Channels of devices without it are corrected in software.
+   *
+   * \param chan the channel index 0 to N-1
+   * \return true if set_dc_offset_mode is handled by the device
+   */
+  virtual bool has_dc_offset_mode( size_t chan = 0 ) { return false; }
+
   /*!
    * Set a constant DC offset value.
    * The value is complex to control both I and Q.
@@ -259,6 +289,15 @@ public:
    */
   virtual void set_iq_balance_mode( int mode, size_t chan = 0 ) { }
 
+  /*!
+   * Whether the device corrects IQ imbalance itself.
+   * Channels of devices without it are corrected in software.
+   *
+   * \param chan the channel index 0 to N-1
+   * \return true if set_iq_balance_mode is handled by the device
+   */
+  virtual bool has_iq_balance_mode( size_t chan = 0 ) { return false; }
+
   /*!
    * Set the RX frontend IQ balance correction.
    * Use this to adjust the magnitude and phase of I and Q.
@@ -291,6 +330,17 @@ public:
   virtual osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 )
     { return osmosdr::freq_range_t(); }
 
+  /*!
+   * Apply several settings of a channel at once.
+   * Goes through the single setters by default, backends reconfiguring
+   * the hardware or restarting the stream on more than one of them
+   * override this to do so only once.
+   * \param config the settings given, see config_helpers.h
+   * \param chan the channel index 0 to N-1
+   */
+  virtual void configure( const channel_config &config, size_t chan = 0 )
+    { apply_channel_config( *this, config, chan ); }
+
   /*!
    * Set the time source for the device.
    * This sets the method of time synchronization,
@@ -27,6 +27,8 @@
 #include "config.h"
 #endif
 
+#include <cmath>
+
 #include <gnuradio/io_signature.h>
 #include <gnuradio/blocks/null_source.h>
 #include <gnuradio/blocks/throttle.h>
@@ -88,6 +90,10 @@
 #include <redpitaya_source_c.h>
 #endif
 
+#ifdef ENABLE_VRT
+#include <vrt_source_c.h>
+#endif
+
 #ifdef ENABLE_FREESRP
 #include <freesrp_source_c.h>
 #endif
@@ -97,28 +103,17 @@
 #endif
 
 #include "arg_helpers.h"
+#include "worker_helpers.h"
 #include "source_impl.h"
 
-/*
- * Create a new instance of source_impl and return
- * a boost shared_ptr.  This is effectively the public constructor.
- */
-osmosdr::source::sptr
-osmosdr::source::make( const std::string &args )
-{
-  return gnuradio::get_initial_sptr( new source_impl(args) );
-}
+static const pmt::pmt_t SCAN_PORT = pmt::string_to_symbol("scan");
 
 /*
- * The private constructor
+ * The device arguments given in args, the first device found is appended
+ * when none of them names a built-in device type.
  */
-source_impl::source_impl( const std::string &args )
-  : gr::hier_block2 ("source_impl",
-        gr::io_signature::make(0, 0, 0),
-        args_to_io_signature(args)),
-    _sample_rate(NAN)
+std::vector< std::string > source_device_args( const std::string &args )
 {
-  size_t channel = 0;
   bool device_specified = false;
 
   std::vector< std::string > arg_list = args_to_vector(args);
@@ -167,6 +162,9 @@ source_impl::source_impl( const std::string &args )
 #ifdef ENABLE_REDPITAYA
   dev_types.push_back("redpitaya");
 #endif
+#ifdef ENABLE_VRT
+  dev_types.push_back("vrt");
+#endif
 #ifdef ENABLE_FREESRP
   dev_types.push_back("freesrp");
 #endif
@@ -249,6 +247,10 @@ source_impl::source_impl( const std::string &args )
     for (std::string dev : redpitaya_source_c::get_devices())
       dev_list.push_back( dev );
 #endif
+#ifdef ENABLE_VRT
+    for (std::string dev : vrt_source_c::get_devices())
+      dev_list.push_back( dev );
+#endif
 #ifdef ENABLE_FREESRP
     for (std::string dev : freesrp_source_c::get_devices())
       dev_list.push_back( dev );
@@ -268,153 +270,216 @@ source_impl::source_impl( const std::string &args )
       throw std::runtime_error("No supported devices found (check the connection and/or udev rules).");
   }
 
-  for (std::string arg : arg_list) {
+  return arg_list;
+}
 
-    dict_t dict = params_to_dict(arg);
+/*
+ * Create the backend for a single device argument, block and iface are
+ * left empty when it names none.
+ */
+gr::basic_block_sptr make_source_device( const std::string &arg, source_iface *&iface )
+{
+  dict_t dict = params_to_dict(arg);
 
-//    std::cerr << std::endl;
-//    for (dict_t::value_type &entry : dict)
-//      std::cerr << "'" << entry.first << "' = '" << entry.second << "'" << std::endl;
+//  std::cerr << std::endl;
+//  for (dict_t::value_type &entry : dict)
+//    std::cerr << "'" << entry.first << "' = '" << entry.second << "'" << std::endl;
 
-    source_iface *iface = NULL;
-    gr::basic_block_sptr block;
+  gr::basic_block_sptr block;
+  iface = NULL;
 
 #ifdef ENABLE_FCD
-    if ( dict.count("fcd") ) {
-      fcd_source_c_sptr src = make_fcd_source_c( arg );
-      block = src; iface = src.get();
-    }
+  if ( dict.count("fcd") ) {
+    fcd_source_c_sptr src = make_fcd_source_c( arg );
+    block = src; iface = src.get();
+  }
 #endif
 
 #ifdef ENABLE_FILE
-    if ( dict.count("file") ) {
-      file_source_c_sptr src = make_file_source_c( arg );
-      block = src; iface = src.get();
-    }
+  if ( dict.count("file") ) {
+    file_source_c_sptr src = make_file_source_c( arg );
+    block = src; iface = src.get();
+  }
 #endif
 
 #ifdef ENABLE_RTL
-    if ( dict.count("rtl") ) {
-      rtl_source_c_sptr src = make_rtl_source_c( arg );
-      block = src; iface = src.get();
-    }
+  if ( dict.count("rtl") ) {
+    rtl_source_c_sptr src = make_rtl_source_c( arg );
+    block = src; iface = src.get();
+  }
 #endif
 
 #ifdef ENABLE_RTL_TCP
-    if ( dict.count("rtl_tcp") ) {
-      rtl_tcp_source_c_sptr src = make_rtl_tcp_source_c( arg );
-      block = src; iface = src.get();
-    }
+  if ( dict.count("rtl_tcp") ) {
+    rtl_tcp_source_c_sptr src = make_rtl_tcp_source_c( arg );
+    block = src; iface = src.get();
+  }
 #endif
 
 #ifdef ENABLE_UHD
-    if ( dict.count("uhd") ) {
-      uhd_source_c_sptr src = make_uhd_source_c( arg );
-      block = src; iface = src.get();
-    }
+  if ( dict.count("uhd") ) {
+    uhd_source_c_sptr src = make_uhd_source_c( arg );
+    block = src; iface = src.get();
+  }
 #endif
 
 #ifdef ENABLE_MIRI
-    if ( dict.count("miri") ) {
-      miri_source_c_sptr src = make_miri_source_c( arg );
-      block = src; iface = src.get();
-    }
+  if ( dict.count("miri") ) {
+    miri_source_c_sptr src = make_miri_source_c( arg );
+    block = src; iface = src.get();
+  }
 #endif
 
 #ifdef ENABLE_SDRPLAY
-    if ( dict.count("sdrplay") ) {
-      sdrplay_source_c_sptr src = make_sdrplay_source_c( arg );
-      block = src; iface = src.get();
-    }
+  if ( dict.count("sdrplay") ) {
+    sdrplay_source_c_sptr src = make_sdrplay_source_c( arg );
+    block = src; iface = src.get();
+  }
 #endif
 
 #ifdef ENABLE_HACKRF
-    if ( dict.count("hackrf") ) {
-      hackrf_source_c_sptr src = make_hackrf_source_c( arg );
-      block = src; iface = src.get();
-    }
+  if ( dict.count("hackrf") ) {
+    hackrf_source_c_sptr src = make_hackrf_source_c( arg );
+    block = src; iface = src.get();
+  }
 #endif
 
 #ifdef ENABLE_BLADERF
-    if ( dict.count("bladerf") ) {
-      bladerf_source_c_sptr src = make_bladerf_source_c( arg );
-      block = src; iface = src.get();
-    }
+  if ( dict.count("bladerf") ) {
+    bladerf_source_c_sptr src = make_bladerf_source_c( arg );
+    block = src; iface = src.get();
+  }
 #endif
 
 #ifdef ENABLE_RFSPACE
-    if ( dict.count("rfspace") ||
-         dict.count("sdr-iq") ||
-         dict.count("sdr-ip") ||
-         dict.count("netsdr") ||
-         dict.count("cloudiq") ||
-         dict.count("cloudsdr") ) {
-      rfspace_source_c_sptr src = make_rfspace_source_c( arg );
-      block = src; iface = src.get();
-    }
+  if ( dict.count("rfspace") ||
+       dict.count("sdr-iq") ||
+       dict.count("sdr-ip") ||
+       dict.count("netsdr") ||
+       dict.count("cloudiq") ||
+       dict.count("cloudsdr") ) {
+    rfspace_source_c_sptr src = make_rfspace_source_c( arg );
+    block = src; iface = src.get();
+  }
 #endif
 
 #ifdef ENABLE_AIRSPY
-    if ( dict.count("airspy") ) {
-      airspy_source_c_sptr src = make_airspy_source_c( arg );
-      block = src; iface = src.get();
-    }
+  if ( dict.count("airspy") ) {
+    airspy_source_c_sptr src = make_airspy_source_c( arg );
+    block = src; iface = src.get();
+  }
 #endif
 
 #ifdef ENABLE_AIRSPYHF
-    if ( dict.count("airspyhf") ) {
-      airspyhf_source_c_sptr src = make_airspyhf_source_c( arg );
-      block = src; iface = src.get();
-    }
+  if ( dict.count("airspyhf") ) {
+    airspyhf_source_c_sptr src = make_airspyhf_source_c( arg );
+    block = src; iface = src.get();
+  }
 #endif
 
 #ifdef ENABLE_SOAPY
-    if ( dict.count("soapy") ) {
-      soapy_source_c_sptr src = make_soapy_source_c( arg );
-      block = src; iface = src.get();
-    }
+  if ( dict.count("soapy") ) {
+    soapy_source_c_sptr src = make_soapy_source_c( arg );
+    block = src; iface = src.get();
+  }
 #endif
 
 #ifdef ENABLE_REDPITAYA
-    if ( dict.count("redpitaya") ) {
-      redpitaya_source_c_sptr src = make_redpitaya_source_c( arg );
-      block = src; iface = src.get();
-    }
+  if ( dict.count("redpitaya") ) {
+    redpitaya_source_c_sptr src = make_redpitaya_source_c( arg );
+    block = src; iface = src.get();
+  }
+#endif
+
+#ifdef ENABLE_VRT
+  if ( dict.count("vrt") ) {
+    vrt_source_c_sptr src = make_vrt_source_c( arg );
+    block = src; iface = src.get();
+  }
 #endif
 
 #ifdef ENABLE_FREESRP
-    if ( dict.count("freesrp") ) {
-      freesrp_source_c_sptr src = make_freesrp_source_c( arg );
-      block = src; iface = src.get();
-    }
+  if ( dict.count("freesrp") ) {
+    freesrp_source_c_sptr src = make_freesrp_source_c( arg );
+    block = src; iface = src.get();
+  }
 #endif
 
 #ifdef ENABLE_XTRX
-    if ( dict.count("xtrx") ) {
-      xtrx_source_c_sptr src = make_xtrx_source_c( arg );
-      block = src; iface = src.get();
-    }
+  if ( dict.count("xtrx") ) {
+    xtrx_source_c_sptr src = make_xtrx_source_c( arg );
+    block = src; iface = src.get();
+  }
 #endif
 
+  return block;
+}
+
+/*
+ * Create a new instance of source_impl and return
+ * a boost shared_ptr.  This is effectively the public constructor.
+ */
+osmosdr::source::sptr
+osmosdr::source::make( const std::string &args )
+{
+  return gnuradio::get_initial_sptr( new source_impl(args) );
+}
+
+/*
+ * The private constructor
+ */
+source_impl::source_impl( const std::string &args )
+  : gr::hier_block2 ("source_impl",
+        gr::io_signature::make(0, 0, 0),
+        args_to_io_signature(args)),
+    _item_size(args_to_item_size(args)),
+    _resample(true),
+    _native_rate(0),
+    _resamp_ratio(1.0),
+    _iqbal(false),
+    _scan_connected(false),
+    _align_period(0),
+    _ddc_chan(0),
+    _sample_rate(NAN)
+{
+  size_t channel = 0;
+
+  std::vector< std::string > arg_list = source_device_args(args);
+  std::string item_type = args_to_item_type(args);
+
+  /* the backends deliver integer items themselves where they can */
+  for (std::string &arg : arg_list)
+    if ( _item_size != sizeof(gr_complex) && ! is_global_argument()( arg ) &&
+         ! params_to_dict( arg ).count("item_type") )
+      arg += ",item_type=" + item_type;
+
+  /* opened all at once, wired up in the order given */
+  std::vector< gr::basic_block_sptr > blocks;
+  std::vector< source_iface * > ifaces;
+  open_devices( arg_list, args_to_open_threads(args), make_source_device, blocks, ifaces );
+
+  for (size_t dev = 0; dev < arg_list.size(); dev++) {
+    source_iface *iface = ifaces[dev];
+    gr::basic_block_sptr block = blocks[dev];
+
     if (iface != NULL && reinterpret_cast<std::intptr_t>(block.get()) != 0 ) {
       _devs.push_back( iface );
 
       for (size_t i = 0; i < iface->get_num_channels(); i++) {
-#ifdef HAVE_IQBALANCE
-        gr::iqbalance::optimize_c::sptr iq_opt = gr::iqbalance::optimize_c::make( 0 );
-        gr::iqbalance::fix_cc::sptr     iq_fix = gr::iqbalance::fix_cc::make();
-
-        connect(block, i, iq_fix, 0);
-        connect(iq_fix, 0, self(), channel++);
+        gr::basic_block_sptr out = block;
+        int port = i;
+
+        /* the others get converted from complex float */
+        if ( block->output_signature()->sizeof_stream_item( i ) != int(_item_size) ) {
+          out = make_convert_ci( _item_size );
+          port = 0;
+          connect(block, i, out, 0);
+        }
 
-        connect(block, i, iq_opt, 0);
-        msg_connect(iq_opt, "iqbal_corr", iq_fix, "iqbal_corr");
+        connect(out, port, self(), channel++);
 
-        _iq_opt.push_back( iq_opt.get() );
-        _iq_fix.push_back( iq_fix.get() );
-#else
-        connect(block, i, self(), channel++);
-#endif
+        _chan_block.push_back( out );
+        _chan_port.push_back( port );
       }
     } else if ((iface != NULL) || (reinterpret_cast<std::intptr_t>(block.get()) != 0))
       throw std::runtime_error("Either iface or block are NULL.");
@@ -424,6 +489,94 @@ source_impl::source_impl( const std::string &args )
   if (!_devs.size())
     throw std::runtime_error("No devices specified via device arguments.");
 
+  _corr.resize( channel );
+  _corr_connected.resize( channel, false );
+  _iqbal_on.resize( channel, false );
+  _iqbal_connected.resize( channel, false );
+#ifdef HAVE_IQBALANCE
+  _iq_fix.resize( channel );
+  _iq_opt.resize( channel );
+#endif
+
+  for (std::string arg : arg_list) {
+    dict_t dict = params_to_dict(arg);
+    if ( dict.count("resample") )
+      _resample = boost::lexical_cast< bool >( dict["resample"] );
+
+    if ( dict.count("ddc") ) {
+      size_t nddc = boost::lexical_cast< size_t >( dict["ddc"] );
+      size_t decim = 64, taps = 32, threads = 1;
+
+      if ( dict.count("ddc_decim") )
+        decim = boost::lexical_cast< size_t >( dict["ddc_decim"] );
+      if ( dict.count("ddc_taps") )
+        taps = boost::lexical_cast< size_t >( dict["ddc_taps"] );
+      if ( dict.count("ddc_threads") )
+        threads = boost::lexical_cast< size_t >( dict["ddc_threads"] );
+      if ( dict.count("ddc_chan") )
+        _ddc_chan = boost::lexical_cast< size_t >( dict["ddc_chan"] );
+
+      if ( _ddc_chan >= channel )
+        throw std::runtime_error("The ddc_chan channel does not exist.");
+
+      _ddc = make_ddc_cc( nddc, decim, taps, threads );
+      _ddc_offset.assign( nddc, 0.0 );
+    }
+
+    if ( dict.count("iq_corr") ) {
+      if ( dict["iq_corr"] == "iqbalance" ) {
+#ifdef HAVE_IQBALANCE
+        _iqbal = true;
+#else
+        throw std::runtime_error("iq_corr=iqbalance needs gr-osmosdr built with gr-iqbalance.");
+#endif
+      } else if ( dict["iq_corr"] != "native" ) {
+        throw std::runtime_error("Unsupported IQ correction '" + dict["iq_corr"] + "', use iq_corr=native or iq_corr=iqbalance.");
+      }
+    }
+
+    if ( ! dict.count("align") )
+      continue;
+
+    if ( dict["align"] != "xcorr" )
+      throw std::runtime_error("Unsupported channel alignment '" + dict["align"] + "', use align=xcorr.");
+
+    size_t align_len = 65536;
+    if ( dict.count("align_len") )
+      align_len = boost::lexical_cast< size_t >( dict["align_len"] );
+
+    if ( align_len < 1024 )
+      throw std::runtime_error("align_len has to be at least 1024 samples.");
+
+    if ( dict.count("align_period") )
+      _align_period = boost::lexical_cast< double >( dict["align_period"] );
+
+    _align = make_align_cc( channel, align_len, 0 );
+  }
+
+  /* the processing in the chain only works on complex float */
+  if ( _item_size != sizeof(gr_complex) ) {
+    if ( _align || _ddc )
+      throw std::runtime_error("align= and ddc= need item_type=fc32.");
+
+    _resample = false;
+  }
+
+  /* the narrowband channels follow the ones of the devices */
+  for ( size_t i = 0; i < _ddc_offset.size(); i++ )
+    connect( _ddc, i, self(), channel + i );
+
+  if ( _align || _ddc ) {
+    for (size_t chan = 0; chan < channel; chan++) {
+      disconnect( _chan_block[chan], _chan_port[chan], self(), chan );
+      wire_chain( chan, false, false, false, true );
+    }
+
+    update_align_period();
+  }
+
+  message_port_register_hier_in( SCAN_PORT );
+
   /* Populate the _gain and _gain_mode arrays with the hardware state */
   for ( source_iface *dev : _devs )
     for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++) {
@@ -466,6 +619,104 @@ osmosdr::meta_range_t source_impl::get_sample_rates()
   return osmosdr::meta_range_t();;
 }
 
+/* relative difference below which two sample rates are the same */
+#define RATE_TOL 1e-9
+
+static bool same_rate( double a, double b )
+{
+  return std::fabs( a - b ) <= RATE_TOL * b;
+}
+
+/*
+ * The device rate to deliver the given one from. That is the rate itself
+ * when the device supports it, otherwise the smallest supported multiple of
+ * it, which the resampler reaches by decimation alone, otherwise the
+ * smallest supported rate above it. Without any rate above it is returned
+ * unchanged and left to the device.
+ */
+static double native_sample_rate( const osmosdr::meta_range_t &rates, double rate )
+{
+  double multiple = 0, above = 0;
+
+  for ( const osmosdr::range_t &r : rates ) {
+    /* the lowest rate of this range not below the requested one */
+    double lowest = rate;
+    if ( rate <= r.start() )
+      lowest = r.start();
+    else if ( r.step() != 0 )
+      lowest = r.start() + std::ceil( ( rate - r.start() ) / r.step() - RATE_TOL ) * r.step();
+
+    if ( lowest > r.stop() && !same_rate( lowest, r.stop() ) )
+      continue;
+
+    if ( same_rate( lowest, rate ) )
+      return rate;
+
+    if ( !above || lowest < above )
+      above = lowest;
+
+    double n = std::ceil( lowest / rate - RATE_TOL );
+    for ( int i = 0; i < 1024 && n * rate <= r.stop() * ( 1 + RATE_TOL ); i++, n++ ) {
+      if ( r.step() != 0 ) {
+        double k = ( n * rate - r.start() ) / r.step();
+        if ( std::fabs( k - std::round( k ) ) > 1e-6 )
+          continue;
+      }
+
+      if ( !multiple || n * rate < multiple )
+        multiple = n * rate;
+      break;
+    }
+  }
+
+  if ( multiple )
+    return multiple;
+
+  return above ? above : rate;
+}
+
+double source_impl::device_sample_rate( double rate )
+{
+  if ( _resample && ! _devs.empty() )
+    return native_sample_rate( _devs[0]->get_sample_rates(), rate );
+
+  return rate;
+}
+
+void source_impl::sample_rate_changed( double rate, double native, double sample_rate )
+{
+  /* resample from the nominal rate unless the device picked another one */
+  double ratio = 1.0;
+  if ( native != rate ) {
+    _native_rate = same_rate( sample_rate, native ) ? native : sample_rate;
+    if ( _native_rate > rate && ! same_rate( _native_rate, rate ) )
+      ratio = _native_rate / rate;
+  }
+
+  update_resampler( ratio );
+
+  _sample_rate = get_sample_rate();
+
+  update_align_period();
+
+  /* a scan keeps its dwell and settle times at the new rate */
+  if ( _scan && _sample_rate > 0 )
+    _scan->set_rate( _sample_rate );
+
+#ifdef HAVE_IQBALANCE
+  for ( gr::iqbalance::optimize_c::sptr &opt : _iq_opt )
+    if ( opt && opt->period() > 0 ) { /* optimize is enabled */
+      opt->set_period( _sample_rate / 5 );
+      opt->reset();
+    }
+#endif
+
+  /* the narrowband channels keep their offsets in Hz */
+  for ( size_t ddc = 0; ddc < _ddc_offset.size(); ddc++ )
+    if ( _sample_rate > 0 )
+      _ddc->set_offset( ddc, _ddc_offset[ ddc ] / _sample_rate );
+}
+
 double source_impl::set_sample_rate(double rate)
 {
   double sample_rate = 0;
@@ -475,34 +726,26 @@ double source_impl::set_sample_rate(double rate)
     if (_devs.empty())
       throw std::runtime_error(NO_DEVICES_MSG);
 #endif
-    for (source_iface *dev : _devs)
-      sample_rate = dev->set_sample_rate(rate);
+    double native = device_sample_rate( rate );
 
-#ifdef HAVE_IQBALANCE
-    size_t channel = 0;
-    for (source_iface *dev : _devs) {
-      for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++) {
-        if ( channel < _iq_opt.size() ) {
-          gr::iqbalance::optimize_c *opt = _iq_opt[channel];
-
-          if ( opt->period() > 0 ) { /* optimize is enabled */
-            opt->set_period( dev->get_sample_rate() / 5 );
-            opt->reset();
-          }
-        }
-
-        channel++;
-      }
-    }
-#endif
+    for (source_iface *dev : _devs)
+      sample_rate = dev->set_sample_rate(native);
 
-    _sample_rate = sample_rate;
+    sample_rate_changed( rate, native, sample_rate );
   }
 
   return _sample_rate;
 }
 
 double source_impl::get_sample_rate()
+{
+  if ( ! _resamp.empty() )
+    return _native_rate * _resamp[0]->rate();
+
+  return get_native_sample_rate();
+}
+
+double source_impl::get_native_sample_rate()
 {
   double sample_rate = 0;
 
@@ -755,13 +998,172 @@ std::string source_impl::get_antenna( size_t chan )
   return "";
 }
 
+dc_iq_corr_cc_sptr source_impl::corrector( size_t chan )
+{
+  if ( !_corr[chan] )
+    _corr[chan] = make_dc_iq_corr_cc();
+
+  return _corr[chan];
+}
+
+void source_impl::wire_chain( size_t chan, bool corr, bool iqbal, bool scan, bool make )
+{
+  /* every hop uses the same port number on its input and output side */
+  std::vector< std::pair< gr::basic_block_sptr, int > > hops;
+
+  hops.push_back( std::make_pair( _chan_block[chan], _chan_port[chan] ) );
+  if ( ! _resamp.empty() )
+    hops.push_back( std::make_pair( _resamp[chan], 0 ) );
+  if ( corr )
+    hops.push_back( std::make_pair( _corr[chan], 0 ) );
+#ifdef HAVE_IQBALANCE
+  /* the optimizer looks at what goes into the fix and steers it by message */
+  if ( iqbal ) {
+    const std::pair< gr::basic_block_sptr, int > &tap = hops.back();
+    if ( make ) {
+      connect( tap.first, tap.second, _iq_opt[chan], 0 );
+      msg_connect( _iq_opt[chan], "iqbal_corr", _iq_fix[chan], "iqbal_corr" );
+    } else {
+      disconnect( tap.first, tap.second, _iq_opt[chan], 0 );
+      msg_disconnect( _iq_opt[chan], "iqbal_corr", _iq_fix[chan], "iqbal_corr" );
+    }
+    hops.push_back( std::make_pair( _iq_fix[chan], 0 ) );
+  }
+#endif
+  if ( _align )
+    hops.push_back( std::make_pair( _align, int(chan) ) );
+  if ( scan )
+    hops.push_back( std::make_pair( _scan, int(chan) ) );
+  hops.push_back( std::make_pair( self(), int(chan) ) );
+
+  for ( size_t i = 0; i + 1 < hops.size(); i++ ) {
+    if ( make )
+      connect( hops[i].first, hops[i].second, hops[i + 1].first, hops[i + 1].second );
+    else
+      disconnect( hops[i].first, hops[i].second, hops[i + 1].first, hops[i + 1].second );
+  }
+
+  /* the narrowband channels are taken where the channel leaves the chain */
+  if ( _ddc && chan == _ddc_chan ) {
+    const std::pair< gr::basic_block_sptr, int > &tap = hops[ hops.size() - 2 ];
+    if ( make )
+      connect( tap.first, tap.second, _ddc, 0 );
+    else
+      disconnect( tap.first, tap.second, _ddc, 0 );
+  }
+}
+
+void source_impl::update_chain( bool scan )
+{
+  std::vector< bool > corr( _chan_block.size() );
+  bool changed = ( scan != _scan_connected );
+
+  for ( size_t chan = 0; chan < _chan_block.size(); chan++ ) {
+    corr[chan] = _corr[chan] && _corr[chan]->enabled();
+    changed |= ( corr[chan] != _corr_connected[chan] );
+    changed |= ( _iqbal_on[chan] != _iqbal_connected[chan] );
+  }
+
+  if ( !changed )
+    return;
+
+  bool locked = chain_running();
+  if ( locked )
+    lock();
+
+  for ( size_t chan = 0; chan < _chan_block.size(); chan++ ) {
+    if ( corr[chan] == _corr_connected[chan] &&
+         _iqbal_on[chan] == _iqbal_connected[chan] && scan == _scan_connected )
+      continue;
+
+    wire_chain( chan, _corr_connected[chan], _iqbal_connected[chan], _scan_connected, false );
+    wire_chain( chan, corr[chan], _iqbal_on[chan], scan, true );
+
+    _corr_connected[chan] = corr[chan];
+    _iqbal_connected[chan] = _iqbal_on[chan];
+  }
+
+  if ( scan != _scan_connected ) {
+    if ( scan )
+      msg_connect( self(), SCAN_PORT, _scan, SCAN_PORT );
+    else
+      msg_disconnect( self(), SCAN_PORT, _scan, SCAN_PORT );
+
+    _scan_connected = scan;
+  }
+
+  if ( locked )
+    unlock();
+}
+
+bool source_impl::chain_running()
+{
+  /* blocks get their detail when the flowgraph is set up, from then on the
+   * rewiring has to happen under the lock of the top block */
+  bool running = ( _scan && _scan->detail() ) || ( _ddc && _ddc->detail() );
+  for ( size_t chan = 0; chan < _chan_block.size(); chan++ ) {
+    gr::block_sptr blk = std::dynamic_pointer_cast< gr::block >( _chan_block[chan] );
+    running |= ( blk && blk->detail() ) || ( _corr[chan] && _corr[chan]->detail() );
+    running |= ! _resamp.empty() && _resamp[chan]->detail();
+#ifdef HAVE_IQBALANCE
+    running |= _iq_fix[chan] && _iq_fix[chan]->detail();
+#endif
+  }
+
+  return running;
+}
+
+void source_impl::update_resampler( double ratio )
+{
+  if ( ratio <= 1.0 )
+    ratio = 1.0;
+
+  /* the stages follow from the ratio, the same one keeps them and their state */
+  if ( ratio == _resamp_ratio )
+    return;
+
+  std::vector< resamp_cc_sptr > resamp;
+
+  if ( ratio > 1.0 )
+    for ( size_t chan = 0; chan < _chan_block.size(); chan++ )
+      resamp.push_back( make_resamp_cc( ratio ) );
+
+  _resamp_ratio = ratio;
+
+  bool locked = chain_running();
+  if ( locked )
+    lock();
+
+  for ( size_t chan = 0; chan < _chan_block.size(); chan++ )
+    wire_chain( chan, _corr_connected[chan], _iqbal_connected[chan], _scan_connected, false );
+
+  _resamp.swap( resamp );
+
+  for ( size_t chan = 0; chan < _chan_block.size(); chan++ )
+    wire_chain( chan, _corr_connected[chan], _iqbal_connected[chan], _scan_connected, true );
+
+  if ( locked )
+    unlock();
+}
+
 void source_impl::set_dc_offset_mode( int mode, size_t chan )
 {
   size_t channel = 0;
   for (source_iface *dev : _devs)
     for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        dev->set_dc_offset_mode( mode, dev_chan );
+      if ( chan == channel++ ) {
+        if ( dev->has_dc_offset_mode( dev_chan ) )
+          return dev->set_dc_offset_mode( mode, dev_chan );
+
+        if ( _item_size != sizeof(gr_complex) ) {
+          if ( mode != DCOffsetOff )
+            std::cerr << "Software DC offset correction needs item_type=fc32." << std::endl;
+          return;
+        }
+
+        corrector( chan )->set_dc_offset_mode( mode );
+        return update_chain( _scan_connected );
+      }
 }
 
 void source_impl::set_dc_offset( const std::complex<double> &offset, size_t chan )
@@ -769,78 +1171,94 @@ void source_impl::set_dc_offset( const std::complex<double> &offset, size_t chan
   size_t channel = 0;
   for (source_iface *dev : _devs)
     for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        dev->set_dc_offset( offset, dev_chan );
+      if ( chan == channel++ ) {
+        if ( dev->has_dc_offset_mode( dev_chan ) )
+          return dev->set_dc_offset( offset, dev_chan );
+
+        return corrector( chan )->set_dc_offset( offset );
+      }
 }
 
 void source_impl::set_iq_balance_mode( int mode, size_t chan )
 {
   size_t channel = 0;
-#ifdef HAVE_IQBALANCE
-  for (source_iface *dev : _devs) {
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++) {
-      if ( chan == channel++ ) {
-        if ( chan < _iq_opt.size() && chan < _iq_fix.size() ) {
-          gr::iqbalance::optimize_c *opt = _iq_opt[chan];
-          gr::iqbalance::fix_cc *fix = _iq_fix[chan];
-
-          if ( IQBalanceOff == mode  ) {
-            opt->set_period( 0 );
-            /* store current values in order to be able to restore them later */
-            _vals[ chan ] = std::pair< float, float >( fix->mag(), fix->phase() );
-            fix->set_mag( 0.0f );
-            fix->set_phase( 0.0f );
-          } else if ( IQBalanceManual == mode ) {
-            if ( opt->period() == 0 ) { /* transition from Off to Manual */
-              /* restore previous values */
-              std::pair< float, float > val = _vals[ chan ];
-              fix->set_mag( val.first );
-              fix->set_phase( val.second );
-            }
-            opt->set_period( 0 );
-          } else if ( IQBalanceAutomatic == mode ) {
-            opt->set_period( dev->get_sample_rate() / 5 );
-            opt->reset();
-          }
-        }
-      }
-    }
-  }
-#else
   for (source_iface *dev : _devs)
     for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->set_iq_balance_mode( mode, dev_chan );
+      if ( chan == channel++ ) {
+        if ( dev->has_iq_balance_mode( dev_chan ) )
+          return dev->set_iq_balance_mode( mode, dev_chan );
+
+        if ( _item_size != sizeof(gr_complex) ) {
+          if ( mode != IQBalanceOff )
+            std::cerr << "Software IQ balance correction needs item_type=fc32." << std::endl;
+          return;
+        }
+
+#ifdef HAVE_IQBALANCE
+        if ( _iqbal )
+          return set_iqbal_mode( mode, chan );
 #endif
+
+        corrector( chan )->set_iq_balance_mode( mode );
+        return update_chain( _scan_connected );
+      }
 }
 
 void source_impl::set_iq_balance( const std::complex<double> &balance, size_t chan )
 {
   size_t channel = 0;
-#ifdef HAVE_IQBALANCE
-  for (source_iface *dev : _devs) {
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++) {
-      if ( chan == channel++ ) {
-        if ( chan < _iq_opt.size() && chan < _iq_fix.size() ) {
-          gr::iqbalance::optimize_c *opt = _iq_opt[chan];
-          gr::iqbalance::fix_cc *fix = _iq_fix[chan];
-
-          if ( opt->period() == 0 ) { /* automatic optimization desabled */
-            fix->set_mag( balance.real() );
-            fix->set_phase( balance.imag() );
-          }
-        }
-      }
-    }
-  }
-#else
   for (source_iface *dev : _devs)
     for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->set_iq_balance( balance, dev_chan );
+      if ( chan == channel++ ) {
+        if ( dev->has_iq_balance_mode( dev_chan ) )
+          return dev->set_iq_balance( balance, dev_chan );
+
+#ifdef HAVE_IQBALANCE
+        if ( _iqbal )
+          return set_iqbal( balance, chan );
 #endif
+
+        return corrector( chan )->set_iq_balance( balance );
+      }
+}
+
+#ifdef HAVE_IQBALANCE
+void source_impl::iq_balancer( size_t chan )
+{
+  if ( !_iq_fix[chan] ) {
+    _iq_fix[chan] = gr::iqbalance::fix_cc::make();
+    _iq_opt[chan] = gr::iqbalance::optimize_c::make( 0 );
+  }
 }
 
+void source_impl::set_iqbal_mode( int mode, size_t chan )
+{
+  iq_balancer( chan );
+
+  /* off unwires both, the fix keeps its values for going back to manual */
+  if ( IQBalanceAutomatic == mode ) {
+    _iq_opt[chan]->set_period( get_sample_rate() / 5 );
+    _iq_opt[chan]->reset();
+  } else {
+    _iq_opt[chan]->set_period( 0 );
+  }
+
+  _iqbal_on[chan] = ( IQBalanceOff != mode );
+
+  update_chain( _scan_connected );
+}
+
+void source_impl::set_iqbal( const std::complex<double> &balance, size_t chan )
+{
+  iq_balancer( chan );
+
+  if ( _iq_opt[chan]->period() == 0 ) { /* automatic optimization disabled */
+    _iq_fix[chan]->set_mag( balance.real() );
+    _iq_fix[chan]->set_phase( balance.imag() );
+  }
+}
+#endif
+
 double source_impl::set_bandwidth( double bandwidth, size_t chan )
 {
   size_t channel = 0;
@@ -878,6 +1296,94 @@ osmosdr::freq_range_t source_impl::get_bandwidth_range( size_t chan )
   return osmosdr::freq_range_t();
 }
 
+void source_impl::configure( const std::map< std::string, std::string > &settings,
+                             size_t chan )
+{
+  channel_config config = dict_to_channel_config( settings );
+
+  source_iface *target = NULL;
+  size_t target_chan = 0;
+
+  size_t channel = 0;
+  for (source_iface *dev : _devs)
+    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
+      if ( chan == channel++ ) {
+        target = dev;
+        target_chan = dev_chan;
+      }
+
+  if ( ! target )
+    return;
+
+  /* drop what is in effect already, as the single setters do */
+  if ( config.has_freq ) {
+    config.has_freq = _center_freq[ chan ] != config.freq;
+    _center_freq[ chan ] = config.freq;
+  }
+
+  if ( config.has_corr ) {
+    config.has_corr = _freq_corr[ chan ] != config.corr;
+    _freq_corr[ chan ] = config.corr;
+  }
+
+  if ( config.has_bandwidth ) {
+    config.has_bandwidth = _bandwidth[ chan ] != config.bandwidth ||
+                           0.0f == config.bandwidth;
+    _bandwidth[ chan ] = config.bandwidth;
+  }
+
+  if ( config.has_antenna ) {
+    config.has_antenna = _antenna[ chan ] != config.antenna;
+    _antenna[ chan ] = config.antenna;
+  }
+
+  bool to_manual = false;
+  if ( config.has_gain_mode ) {
+    config.has_gain_mode = ( _gain_mode.count( chan ) == 0 ) ||
+                           ( _gain_mode[ chan ] != config.gain_mode );
+    _gain_mode[ chan ] = config.gain_mode;
+    to_manual = config.has_gain_mode && ! config.gain_mode;
+  }
+
+  if ( config.has_gain ) {
+    config.has_gain = _gain[ chan ] != config.gain;
+    _gain[ chan ] = config.gain;
+  }
+
+  if ( to_manual ) { /* reapply the gain value when switched to manual mode */
+    config.has_gain = true;
+    config.gain = _gain[ chan ];
+  }
+
+  if ( config.has_if_gain ) {
+    config.has_if_gain = _if_gain[ chan ] != config.if_gain;
+    _if_gain[ chan ] = config.if_gain;
+  }
+
+  if ( config.has_bb_gain ) {
+    config.has_bb_gain = _bb_gain[ chan ] != config.bb_gain;
+    _bb_gain[ chan ] = config.bb_gain;
+  }
+
+  /* the rate is shared, the other devices of the group get it on its own */
+  double rate = config.rate, native = 0;
+  if ( config.has_rate && _sample_rate != rate ) {
+    native = device_sample_rate( rate );
+    config.rate = native;
+
+    for (source_iface *dev : _devs)
+      if ( dev != target )
+        dev->set_sample_rate( native );
+  } else {
+    config.has_rate = false;
+  }
+
+  target->configure( config, target_chan );
+
+  if ( config.has_rate )
+    sample_rate_changed( rate, native, _devs.back()->get_sample_rate() );
+}
+
 void source_impl::set_time_source(const std::string &source, const size_t mboard)
 {
   if (mboard != osmosdr::ALL_MBOARDS){
@@ -976,3 +1482,103 @@ void source_impl::set_time_unknown_pps(const osmosdr::time_spec_t &time_spec)
     dev->set_time_unknown_pps( time_spec );
   }
 }
+
+void source_impl::scan_tune( double freq )
+{
+  size_t channel = 0;
+  for (source_iface *dev : _devs)
+    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++) {
+      _center_freq[ channel++ ] = freq;
+      dev->set_center_freq( freq, dev_chan );
+    }
+}
+
+void source_impl::start_scan( const std::vector< double > &freqs,
+                              double dwell, double settle )
+{
+  if ( freqs.empty() || dwell <= 0 )
+    throw std::runtime_error("Scanning needs at least one frequency and a positive dwell time.");
+
+  if ( _item_size != sizeof(gr_complex) )
+    throw std::runtime_error("Scanning needs item_type=fc32.");
+
+  if ( !_scan )
+    _scan = make_scanner_cc( get_num_channels(),
+                             [this]( double freq ) { scan_tune( freq ); } );
+
+  _scan->set_schedule( freqs, get_sample_rate(), dwell, settle );
+
+  update_chain( true );
+}
+
+void source_impl::stop_scan()
+{
+  if ( !_scan )
+    return;
+
+  update_chain( false );
+
+  _scan.reset();
+}
+
+void source_impl::update_align_period()
+{
+  if ( _align )
+    _align->set_period( uint64_t( _align_period * get_sample_rate() ) );
+}
+
+std::vector< double > source_impl::get_sample_offsets()
+{
+  if ( _align )
+    return _align->offsets();
+
+  return std::vector< double >();
+}
+
+double source_impl::set_ddc_offset( double offset, size_t ddc )
+{
+  if ( ddc >= _ddc_offset.size() )
+    return 0;
+
+  _ddc_offset[ ddc ] = offset;
+
+  double rate = get_sample_rate();
+  if ( !( rate > 0 ) )
+    return offset;
+
+  return _ddc->set_offset( ddc, offset / rate ) * rate;
+}
+
+double source_impl::get_ddc_offset( size_t ddc )
+{
+  if ( ddc >= _ddc_offset.size() )
+    return 0;
+
+  double rate = get_sample_rate();
+  if ( !( rate > 0 ) )
+    return _ddc_offset[ ddc ];
+
+  return _ddc->get_offset( ddc ) * rate;
+}
+
+double source_impl::get_ddc_sample_rate()
+{
+  if ( !_ddc )
+    return 0;
+
+  return get_sample_rate() / _ddc->decimation();
+}
+
+std::map< std::string, double > source_impl::get_stats( size_t chan )
+{
+  size_t channel = 0;
+  for (source_iface *dev : _devs)
+    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
+      if ( chan == channel++ ) {
+        std::map< std::string, double > stats = dev->get_stats( dev_chan );
+        stats["overflows"] = double( dev->get_overflows() );
+        return stats;
+      }
+
+  return std::map< std::string, double >();
+}
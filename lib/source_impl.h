@@ -29,8 +29,19 @@
 
 #include <source_iface.h>
 
+#include "align_cc.h"
+#include "convert_ci.h"
+#include "dc_iq_corr_cc.h"
+#include "ddc_cc.h"
+#include "resamp_cc.h"
+#include "scanner_cc.h"
+
 #include <map>
 
+/* device argument handling shared with osmosdr::stream */
+std::vector< std::string > source_device_args( const std::string &args );
+gr::basic_block_sptr make_source_device( const std::string &arg, source_iface *&iface );
+
 class source_impl : public osmosdr::source
 {
 public:
@@ -43,6 +54,7 @@ public:
   osmosdr::meta_range_t get_sample_rates( void );
   double set_sample_rate( double rate );
   double get_sample_rate( void );
+  double get_native_sample_rate( void );
 
   osmosdr::freq_range_t get_freq_range( size_t chan = 0 );
   double set_center_freq( double freq, size_t chan = 0 );
@@ -77,6 +89,9 @@ public:
   double get_bandwidth( size_t chan = 0 );
   osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 );
 
+  void configure( const std::map< std::string, std::string > &settings,
+                  size_t chan = 0 );
+
   void set_time_source(const std::string &source, const size_t mboard = 0);
   std::string get_time_source(const size_t mboard);
   std::vector<std::string> get_time_sources(const size_t mboard);
@@ -91,9 +106,75 @@ public:
   void set_time_next_pps(const ::osmosdr::time_spec_t &time_spec);
   void set_time_unknown_pps(const ::osmosdr::time_spec_t &time_spec);
 
+  void start_scan( const std::vector< double > &freqs,
+                   double dwell, double settle = 0 );
+  void stop_scan( void );
+
+  std::vector< double > get_sample_offsets( void );
+
+  double set_ddc_offset( double offset, size_t ddc = 0 );
+  double get_ddc_offset( size_t ddc = 0 );
+  double get_ddc_sample_rate( void );
+
+  std::map< std::string, double > get_stats( size_t chan = 0 );
+
 private:
+  dc_iq_corr_cc_sptr corrector( size_t chan );
+  bool chain_running( void );
+  void update_chain( bool scan );
+  double device_sample_rate( double rate );
+  void sample_rate_changed( double rate, double native, double sample_rate );
+  void update_resampler( double ratio );
+  void wire_chain( size_t chan, bool corr, bool iqbal, bool scan, bool make );
+#ifdef HAVE_IQBALANCE
+  void iq_balancer( size_t chan );
+  void set_iqbal_mode( int mode, size_t chan );
+  void set_iqbal( const std::complex<double> &balance, size_t chan );
+#endif
+  void scan_tune( double freq );
+  void update_align_period( void );
+
   std::vector< source_iface * > _devs;
 
+  /* device block and port feeding each output channel */
+  std::vector< gr::basic_block_sptr > _chan_block;
+  std::vector< int > _chan_port;
+
+  /* of the output items, complex float unless item_type= asked for integers */
+  size_t _item_size;
+
+  /* rate conversion from a native rate of the device, the first in chain */
+  std::vector< resamp_cc_sptr > _resamp;
+  double _resamp_ratio;
+  bool _resample;
+  double _native_rate;
+
+  /* software correction for devices without it, only wired in while enabled */
+  std::vector< dc_iq_corr_cc_sptr > _corr;
+  std::vector< bool > _corr_connected;
+
+  /* gr-iqbalance taking over the IQ balance part with iq_corr=iqbalance */
+  bool _iqbal;
+  std::vector< bool > _iqbal_on;
+  std::vector< bool > _iqbal_connected;
+#ifdef HAVE_IQBALANCE
+  std::vector< gr::iqbalance::fix_cc::sptr > _iq_fix;
+  std::vector< gr::iqbalance::optimize_c::sptr > _iq_opt;
+#endif
+
+  /* frequency hopping, wired into all channels while scanning */
+  scanner_cc_sptr _scan;
+  bool _scan_connected;
+
+  /* channel alignment, wired in for good when align=xcorr was given */
+  align_cc_sptr _align;
+  double _align_period;
+
+  /* narrowband channels of one channel, after all the other processing */
+  ddc_cc_sptr _ddc;
+  size_t _ddc_chan;
+  std::vector< double > _ddc_offset;
+
   /* cache to prevent multiple device calls with the same value coming from grc */
   double _sample_rate;
   std::map< size_t, double > _center_freq;
@@ -103,11 +184,6 @@ private:
   std::map< size_t, double > _if_gain;
   std::map< size_t, double > _bb_gain;
   std::map< size_t, std::string > _antenna;
-#ifdef HAVE_IQBALANCE
-  std::vector< gr::iqbalance::fix_cc * > _iq_fix;
-  std::vector< gr::iqbalance::optimize_c * > _iq_opt;
-  std::map< size_t, std::pair<float, float> > _vals;
-#endif
   std::map< size_t, double > _bandwidth;
 };
 
@@ -0,0 +1,266 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef OSMOSDR_STATS_HELPERS_H
+#define OSMOSDR_STATS_HELPERS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+
+typedef std::map< std::string, double > stats_t;
+
+/*
+ * Histogram of durations in ns with logarithmic buckets: 4 linear steps per
+ * power of two, the way HDR histograms with 2 significant bits do it. A
+ * value is reported as the upper end of its bucket, at most 25 % high.
+ */
+class log_histogram
+{
+public:
+  log_histogram()
+    : _count( 0 ), _max( 0 )
+  {
+    for ( std::atomic< uint64_t > &bucket : _buckets )
+      bucket.store( 0, std::memory_order_relaxed );
+  }
+
+  /* meant for a single writer, any number of readers */
+  void record( uint64_t ns )
+  {
+    _buckets[ index( ns ) ].fetch_add( 1, std::memory_order_relaxed );
+    _count.fetch_add( 1, std::memory_order_relaxed );
+
+    if ( ns > _max.load( std::memory_order_relaxed ) )
+      _max.store( ns, std::memory_order_relaxed );
+  }
+
+  uint64_t count( void ) const { return _count.load( std::memory_order_relaxed ); }
+  uint64_t max( void ) const { return _max.load( std::memory_order_relaxed ); }
+
+  /* the value q of all recorded ones are at or below, 0 when empty */
+  uint64_t percentile( double q ) const
+  {
+    uint64_t total = count();
+    if ( !total )
+      return 0;
+
+    uint64_t rank = uint64_t( std::ceil( q * total ) );
+    uint64_t seen = 0;
+
+    for ( size_t i = 0; i < NBUCKETS; i++ ) {
+      seen += _buckets[i].load( std::memory_order_relaxed );
+      if ( seen >= rank && seen )
+        return std::min( upper( i ), max() );
+    }
+
+    return max();
+  }
+
+private:
+  static const size_t NBUCKETS = 4 * 63;
+
+  static size_t index( uint64_t ns )
+  {
+    if ( ns < 4 )
+      return size_t( ns );
+
+    unsigned int octave = 2;
+    while ( octave < 63 && ns >> ( octave + 1 ) )
+      octave++;
+
+    return 4 * ( octave - 1 ) + size_t( ( ns >> ( octave - 2 ) ) & 3 );
+  }
+
+  static uint64_t upper( size_t i )
+  {
+    if ( i < 4 )
+      return i;
+
+    if ( i + 1 >= NBUCKETS )
+      return UINT64_MAX;
+
+    size_t next = i + 1;
+    return ( uint64_t( 4 + next % 4 ) << ( next / 4 - 1 ) ) - 1;
+  }
+
+  std::atomic< uint64_t > _buckets[ NBUCKETS ];
+  std::atomic< uint64_t > _count;
+  std::atomic< uint64_t > _max;
+};
+
+/*
+ * Instrumentation of the sample ring between a streaming callback and
+ * work(). The callback side reports its arrivals and the ring fill, the
+ * consuming side the age of what it takes out. Everything is kept in
+ * relaxed atomics, get_stats() can read it any time without a lock.
+ *
+ * For sources the latency runs from the callback that queued a transfer
+ * to the work() call starting on it, for sinks from the work() call that
+ * queued the samples to the callback handing them to the device.
+ */
+class stream_stats
+{
+public:
+  stream_stats()
+    : _first( 0 ), _last( 0 ), _interval( 0 ), _jitter( 0 ), _callbacks( 0 ),
+      _fill( 0 ), _fill_max( 0 ), _capacity( 0 )
+  {
+  }
+
+  static uint64_t now( void )
+  {
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(
+          std::chrono::steady_clock::now().time_since_epoch() ).count();
+  }
+
+  /* to be called by the streaming callback, returns the time of arrival */
+  uint64_t arrival( void )
+  {
+    uint64_t t = now();
+    uint64_t last = _last.exchange( t, std::memory_order_relaxed );
+
+    if ( !last )
+      _first.store( t, std::memory_order_relaxed );
+    else {
+      uint64_t interval = t - last;
+      _intervals.record( interval );
+
+      /* jitter as in RFC 3550, smoothed over 16 intervals */
+      uint64_t prev = _interval.exchange( interval, std::memory_order_relaxed );
+      if ( prev ) {
+        double delta = std::fabs( double( interval ) - double( prev ) );
+        double jitter = _jitter.load( std::memory_order_relaxed );
+        _jitter.store( jitter + ( delta - jitter ) / 16, std::memory_order_relaxed );
+      }
+    }
+
+    _callbacks.fetch_add( 1, std::memory_order_relaxed );
+
+    return t;
+  }
+
+  /* samples waiting in the ring after a change, out of capacity */
+  void fill( size_t samples, size_t capacity )
+  {
+    _fill.store( samples, std::memory_order_relaxed );
+    _capacity.store( capacity, std::memory_order_relaxed );
+
+    if ( samples > _fill_max.load( std::memory_order_relaxed ) )
+      _fill_max.store( samples, std::memory_order_relaxed );
+  }
+
+  /* samples queued at time since, taken out now */
+  void taken( uint64_t since )
+  {
+    if ( since )
+      _latency.record( now() - since );
+  }
+
+  /* all figures with durations in us and fills in samples */
+  void report( stats_t &stats ) const
+  {
+    stats["callbacks"] = double( _callbacks.load( std::memory_order_relaxed ) );
+    uint64_t span = _last.load( std::memory_order_relaxed ) - _first.load( std::memory_order_relaxed );
+    stats["interval_mean_us"] = _intervals.count() ? span / 1e3 / _intervals.count() : 0;
+    stats["interval_max_us"] = _intervals.max() / 1e3;
+    stats["interval_jitter_us"] = _jitter.load( std::memory_order_relaxed ) / 1e3;
+
+    stats["fill"] = double( _fill.load( std::memory_order_relaxed ) );
+    stats["fill_max"] = double( _fill_max.load( std::memory_order_relaxed ) );
+    stats["capacity"] = double( _capacity.load( std::memory_order_relaxed ) );
+
+    stats["latency_count"] = double( _latency.count() );
+    stats["latency_p50_us"] = _latency.percentile( 0.5 ) / 1e3;
+    stats["latency_p90_us"] = _latency.percentile( 0.9 ) / 1e3;
+    stats["latency_p99_us"] = _latency.percentile( 0.99 ) / 1e3;
+    stats["latency_p999_us"] = _latency.percentile( 0.999 ) / 1e3;
+    stats["latency_max_us"] = _latency.max() / 1e3;
+  }
+
+private:
+  std::atomic< uint64_t > _first;
+  std::atomic< uint64_t > _last;
+  std::atomic< uint64_t > _interval;
+  std::atomic< double > _jitter;
+  std::atomic< uint64_t > _callbacks;
+
+  std::atomic< size_t > _fill;
+  std::atomic< size_t > _fill_max;
+  std::atomic< size_t > _capacity;
+
+  log_histogram _intervals;
+  log_histogram _latency;
+};
+
+/*
+ * Arrival times of the transfers in a sample FIFO, for backends without a
+ * ring of whole transfers. A transfer counts as taken out with its first
+ * sample. Both sides are expected to hold the lock of the FIFO.
+ */
+class fifo_arrivals
+{
+public:
+  fifo_arrivals()
+    : _in( 0 ), _out( 0 )
+  {
+  }
+
+  void queued( size_t nitems, uint64_t time )
+  {
+    if ( !nitems )
+      return;
+
+    _marks.push_back( std::make_pair( _in, time ) );
+    _in += nitems;
+  }
+
+  void taken( size_t nitems, stream_stats &stats )
+  {
+    _out += nitems;
+
+    while ( !_marks.empty() && _marks.front().first < _out ) {
+      stats.taken( _marks.front().second );
+      _marks.pop_front();
+    }
+  }
+
+  /* after the FIFO got emptied */
+  void clear( void )
+  {
+    _out = _in;
+    _marks.clear();
+  }
+
+private:
+  uint64_t _in;
+  uint64_t _out;
+  std::deque< std::pair< uint64_t, uint64_t > > _marks;
+};
+
+#endif // OSMOSDR_STATS_HELPERS_H
@@ -0,0 +1,511 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "sink_impl.h"
+#include "source_impl.h"
+#include "stream_impl.h"
+
+static const pmt::pmt_t RX_FREQ_KEY = pmt::string_to_symbol("rx_freq");
+static const pmt::pmt_t RX_TIME_KEY = pmt::string_to_symbol("rx_time");
+static const pmt::pmt_t TX_SOB_KEY = pmt::string_to_symbol("tx_sob");
+static const pmt::pmt_t TX_EOB_KEY = pmt::string_to_symbol("tx_eob");
+static const pmt::pmt_t TX_TIME_KEY = pmt::string_to_symbol("tx_time");
+
+/* rx_freq tags closer than this to the current frequency are no retune */
+#define STREAM_FREQ_TOL 1.0
+
+typedef std::chrono::steady_clock stream_clock;
+
+osmosdr::stream::sptr
+osmosdr::stream::make( direction_t direction, const std::string &args )
+{
+  return osmosdr::stream::sptr( new stream_impl( direction, args ) );
+}
+
+stream_impl::stream_impl( direction_t direction, const std::string &args )
+  : _direction( direction ),
+    _nchan( 0 ),
+    _active( false ),
+    _work( NULL ),
+    _src( NULL ),
+    _snk( NULL ),
+    _rate( 0 ),
+    _freq( 0 ),
+    _freq_tagged( false ),
+    _overflows( 0 ),
+    _pend_pos( 0 )
+{
+  std::vector< std::string > arg_list = RX == direction ?
+                                        source_device_args( args ) :
+                                        sink_device_args( args );
+
+  for (std::string arg : arg_list) {
+    source_iface *src = NULL;
+    sink_iface *snk = NULL;
+    gr::basic_block_sptr block = RX == direction ?
+                                 make_source_device( arg, src ) :
+                                 make_sink_device( arg, snk );
+
+    if ( ! block )
+      continue;
+
+    if ( _block )
+      throw std::runtime_error("A stream works with a single device.");
+
+    _block = block;
+    _src = src;
+    _snk = snk;
+  }
+
+  if ( ! _block )
+    throw std::runtime_error("No devices specified via device arguments.");
+
+  _work = dynamic_cast< direct_block * >( _block.get() );
+  if ( ! _work )
+    throw std::runtime_error("The " + _block->name() + " backend does not support direct streaming.");
+
+  gr::io_signature::sptr sig = _src ? _work->output_signature() : _work->input_signature();
+  if ( size_t( sig->sizeof_stream_item( 0 ) ) != sizeof(gr_complex) )
+    throw std::runtime_error("A stream works with complex float samples, use item_type=fc32.");
+
+  _nchan = _src ? _src->get_num_channels() : _snk->get_num_channels();
+
+  /* item counts and tags of the backend come from the stream */
+  _state = direct_state( _nchan );
+  _work->set_direct( &_state );
+
+  _pend.resize( _nchan );
+
+  _rate = get_sample_rate();
+  if ( _src ) {
+    _freq = _src->get_center_freq( 0 );
+    _overflows = _src->get_overflows();
+  }
+}
+
+stream_impl::~stream_impl()
+{
+  if ( _active )
+    deactivate();
+
+  _work->set_direct( NULL );
+}
+
+size_t stream_impl::get_num_channels()
+{
+  return _nchan;
+}
+
+bool stream_impl::activate()
+{
+  if ( _active )
+    return true;
+
+  _active = _work->start();
+
+  return _active;
+}
+
+bool stream_impl::deactivate()
+{
+  if ( ! _active )
+    return true;
+
+  _active = false;
+
+  return _work->stop();
+}
+
+/* one call into the backend, tags come back relative to the first sample */
+int stream_impl::receive( gr_vector_void_star &out, int nitems,
+                          std::vector< gr::tag_t > &tags )
+{
+  gr_vector_const_void_star in;
+
+  int ret = _work->work( nitems, in, out );
+
+  tags.clear();
+  if ( ret > 0 ) {
+    for ( gr::tag_t tag : _state.tags[0] ) {
+      tag.offset -= _state.nitems;
+      tags.push_back( tag );
+    }
+
+    std::stable_sort( tags.begin(), tags.end(), gr::tag_t::offset_compare );
+    _state.nitems += ret;
+  }
+
+  for ( std::vector< gr::tag_t > &port : _state.tags )
+    port.clear();
+
+  return ret;
+}
+
+/* copy pending samples into buffs at offset, with their tags relative to it */
+int stream_impl::take_pending( const std::vector< gr_complex * > &buffs,
+                               size_t offset, size_t nitems,
+                               std::vector< gr::tag_t > &tags )
+{
+  size_t n = std::min( nitems, _pend[0].size() - _pend_pos );
+
+  for ( size_t chan = 0; chan < _nchan; chan++ )
+    memcpy( buffs[chan] + offset, &_pend[chan][ _pend_pos ], n * sizeof(gr_complex) );
+
+  tags.clear();
+  for ( gr::tag_t tag : _pend_tags ) {
+    if ( tag.offset < _pend_pos || tag.offset >= _pend_pos + n )
+      continue;
+
+    tag.offset -= _pend_pos;
+    tags.push_back( tag );
+  }
+
+  _pend_pos += n;
+
+  return int( n );
+}
+
+int stream_impl::read( const std::vector< gr_complex * > &buffs, size_t nitems,
+                       double timeout, osmosdr::stream_metadata &meta )
+{
+  if ( RX != _direction )
+    throw std::runtime_error("Reading requires a receive stream.");
+
+  if ( buffs.size() != _nchan )
+    throw std::runtime_error("A buffer is needed for every channel of the stream.");
+
+  stream_clock::time_point deadline = stream_clock::now() +
+      std::chrono::duration_cast< stream_clock::duration >(
+        std::chrono::duration< double >( timeout ) );
+
+  const int multiple = std::max( _work->output_multiple(), 1 );
+
+  meta = osmosdr::stream_metadata();
+
+  uint64_t overflows = _src->get_overflows();
+  meta.overflow = overflows != _overflows;
+  _overflows = overflows;
+
+  bool device_time = false;
+  size_t got = 0;
+
+  while ( got < nitems ) {
+    std::vector< gr::tag_t > tags;
+    osmosdr::time_spec_t time;
+    bool pending = _pend_pos < _pend[0].size();
+    int n;
+
+    if ( pending ) {
+      time = _pend_time + osmosdr::time_spec_t( _pend_pos / _rate );
+      n = take_pending( buffs, got, nitems - got, tags );
+    } else {
+      size_t want = nitems - got;
+      gr_vector_void_star out( _nchan );
+
+      /* straight into the caller's buffers unless it wants less than a multiple */
+      if ( want >= size_t( multiple ) ) {
+        want -= want % multiple;
+        for ( size_t chan = 0; chan < _nchan; chan++ )
+          out[chan] = buffs[chan] + got;
+      } else {
+        want = multiple;
+        for ( size_t chan = 0; chan < _nchan; chan++ ) {
+          _pend[chan].resize( want );
+          out[chan] = _pend[chan].data();
+        }
+      }
+
+      n = receive( out, int( want ), tags );
+      if ( n < 0 )
+        return got ? int( got ) : -1;
+
+      time = osmosdr::time_spec_t::get_system_time() -
+             osmosdr::time_spec_t( n / _rate );
+
+      if ( out[0] != buffs[0] + got ) {
+        for ( size_t chan = 0; chan < _nchan; chan++ )
+          _pend[chan].resize( n );
+        _pend_tags = tags;
+        _pend_pos = 0;
+        _pend_time = time;
+
+        if ( 0 == n && stream_clock::now() >= deadline )
+          break;
+
+        continue;
+      }
+    }
+
+    /* a read ends in front of a retune */
+    int cut = n;
+    for ( const gr::tag_t &tag : tags ) {
+      if ( ! pmt::eqv( tag.key, RX_FREQ_KEY ) )
+        continue;
+
+      double freq = pmt::to_double( tag.value );
+      _freq_tagged = true;
+
+      if ( std::abs( freq - _freq ) < STREAM_FREQ_TOL )
+        continue;
+
+      if ( tag.offset == 0 && got == 0 ) {
+        _freq = freq;
+        continue;
+      }
+
+      cut = int( tag.offset );
+      break;
+    }
+
+    if ( cut < n ) {
+      if ( pending ) {
+        _pend_pos -= n - cut;
+      } else {
+        for ( size_t chan = 0; chan < _nchan; chan++ )
+          _pend[chan].assign( buffs[chan] + got + cut, buffs[chan] + got + n );
+
+        _pend_tags.clear();
+        for ( gr::tag_t tag : tags ) {
+          if ( int( tag.offset ) < cut )
+            continue;
+
+          tag.offset -= cut;
+          _pend_tags.push_back( tag );
+        }
+
+        _pend_pos = 0;
+        _pend_time = time + osmosdr::time_spec_t( cut / _rate );
+      }
+    }
+
+    if ( 0 == got )
+      meta.time = time;
+
+    for ( const gr::tag_t &tag : tags ) {
+      if ( device_time || int( tag.offset ) >= cut ||
+           ! pmt::eqv( tag.key, RX_TIME_KEY ) )
+        continue;
+
+      osmosdr::time_spec_t tag_time(
+            time_t( pmt::to_uint64( pmt::tuple_ref( tag.value, 0 ) ) ),
+            pmt::to_double( pmt::tuple_ref( tag.value, 1 ) ) );
+
+      meta.time = tag_time - osmosdr::time_spec_t( ( got + tag.offset ) / _rate );
+      device_time = true;
+    }
+
+    got += cut;
+
+    if ( cut < n )
+      break;
+
+    if ( 0 == n && stream_clock::now() >= deadline )
+      break;
+  }
+
+  if ( _pend_pos == _pend[0].size() ) {
+    _pend_pos = 0;
+    for ( std::vector< gr_complex > &pend : _pend )
+      pend.clear();
+    _pend_tags.clear();
+  }
+
+  meta.has_time = got > 0;
+  meta.freq = _freq;
+
+  return int( got );
+}
+
+int stream_impl::write( const std::vector< const gr_complex * > &buffs, size_t nitems,
+                        double timeout, const osmosdr::stream_metadata &meta )
+{
+  if ( TX != _direction )
+    throw std::runtime_error("Writing requires a transmit stream.");
+
+  if ( buffs.size() != _nchan )
+    throw std::runtime_error("A buffer is needed for every channel of the stream.");
+
+  stream_clock::time_point deadline = stream_clock::now() +
+      std::chrono::duration_cast< stream_clock::duration >(
+        std::chrono::duration< double >( timeout ) );
+
+  const size_t multiple = size_t( std::max( _work->output_multiple(), 1 ) );
+
+  /* the burst flags travel as the tags a flowgraph would attach */
+  if ( nitems ) {
+    std::vector< gr::tag_t > &tags = _state.tags[0];
+    gr::tag_t tag;
+    tag.srcid = pmt::PMT_F;
+
+    /* the time first, a sink reading in order knows it before the flags */
+    if ( meta.has_time ) {
+      tag.offset = _state.nitems;
+      tag.key = TX_TIME_KEY;
+      tag.value = pmt::make_tuple(
+            pmt::from_uint64( uint64_t( meta.time.get_full_secs() ) ),
+            pmt::from_double( meta.time.get_frac_secs() ) );
+      tags.push_back( tag );
+    }
+
+    if ( meta.start_of_burst ) {
+      tag.offset = _state.nitems;
+      tag.key = TX_SOB_KEY;
+      tag.value = pmt::PMT_T;
+      tags.push_back( tag );
+    }
+
+    if ( meta.end_of_burst ) {
+      tag.offset = _state.nitems + nitems - 1;
+      tag.key = TX_EOB_KEY;
+      tag.value = pmt::PMT_T;
+      tags.push_back( tag );
+    }
+  }
+
+  size_t done = 0;
+
+  while ( done < nitems ) {
+    size_t n = nitems - done;
+    n -= n % multiple;
+    if ( ! n )
+      break;
+
+    gr_vector_const_void_star in( _nchan );
+    gr_vector_void_star out;
+    for ( size_t chan = 0; chan < _nchan; chan++ )
+      in[chan] = buffs[chan] + done;
+
+    int ret = _work->work( int( n ), in, out );
+    if ( ret < 0 )
+      return done ? int( done ) : -1;
+
+    done += ret;
+    _state.nitems += ret;
+
+    std::vector< gr::tag_t > &tags = _state.tags[0];
+    tags.erase( std::remove_if( tags.begin(), tags.end(),
+                                [this]( const gr::tag_t &tag )
+                                { return tag.offset < _state.nitems; } ),
+                tags.end() );
+
+    if ( 0 == ret && stream_clock::now() >= deadline )
+      break;
+  }
+
+  return int( done );
+}
+
+osmosdr::meta_range_t stream_impl::get_sample_rates()
+{
+  return _src ? _src->get_sample_rates() : _snk->get_sample_rates();
+}
+
+double stream_impl::set_sample_rate( double rate )
+{
+  _rate = _src ? _src->set_sample_rate( rate ) : _snk->set_sample_rate( rate );
+
+  return _rate;
+}
+
+double stream_impl::get_sample_rate()
+{
+  return _src ? _src->get_sample_rate() : _snk->get_sample_rate();
+}
+
+osmosdr::freq_range_t stream_impl::get_freq_range( size_t chan )
+{
+  return _src ? _src->get_freq_range( chan ) : _snk->get_freq_range( chan );
+}
+
+double stream_impl::set_center_freq( double freq, size_t chan )
+{
+  if ( ! _src )
+    return _snk->set_center_freq( freq, chan );
+
+  double actual = _src->set_center_freq( freq, chan );
+
+  /* without rx_freq tags the new frequency applies from the next read on */
+  if ( ! _freq_tagged && 0 == chan )
+    _freq = actual;
+
+  return actual;
+}
+
+double stream_impl::get_center_freq( size_t chan )
+{
+  return _src ? _src->get_center_freq( chan ) : _snk->get_center_freq( chan );
+}
+
+osmosdr::gain_range_t stream_impl::get_gain_range( size_t chan )
+{
+  return _src ? _src->get_gain_range( chan ) : _snk->get_gain_range( chan );
+}
+
+bool stream_impl::set_gain_mode( bool automatic, size_t chan )
+{
+  return _src ? _src->set_gain_mode( automatic, chan ) :
+                _snk->set_gain_mode( automatic, chan );
+}
+
+double stream_impl::set_gain( double gain, size_t chan )
+{
+  return _src ? _src->set_gain( gain, chan ) : _snk->set_gain( gain, chan );
+}
+
+double stream_impl::get_gain( size_t chan )
+{
+  return _src ? _src->get_gain( chan ) : _snk->get_gain( chan );
+}
+
+std::vector< std::string > stream_impl::get_antennas( size_t chan )
+{
+  return _src ? _src->get_antennas( chan ) : _snk->get_antennas( chan );
+}
+
+std::string stream_impl::set_antenna( const std::string & antenna, size_t chan )
+{
+  return _src ? _src->set_antenna( antenna, chan ) : _snk->set_antenna( antenna, chan );
+}
+
+std::string stream_impl::get_antenna( size_t chan )
+{
+  return _src ? _src->get_antenna( chan ) : _snk->get_antenna( chan );
+}
+
+double stream_impl::set_bandwidth( double bandwidth, size_t chan )
+{
+  return _src ? _src->set_bandwidth( bandwidth, chan ) :
+                _snk->set_bandwidth( bandwidth, chan );
+}
+
+double stream_impl::get_bandwidth( size_t chan )
+{
+  return _src ? _src->get_bandwidth( chan ) : _snk->get_bandwidth( chan );
+}
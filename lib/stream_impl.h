@@ -0,0 +1,97 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_OSMOSDR_STREAM_IMPL_H
+#define INCLUDED_OSMOSDR_STREAM_IMPL_H
+
+#include <osmosdr/stream.h>
+
+#include <gnuradio/sync_block.h>
+
+#include "direct_block.h"
+#include "sink_iface.h"
+#include "source_iface.h"
+
+class stream_impl : public osmosdr::stream
+{
+public:
+  stream_impl( direction_t direction, const std::string &args );
+  ~stream_impl();
+
+  size_t get_num_channels( void );
+
+  bool activate( void );
+  bool deactivate( void );
+
+  int read( const std::vector< gr_complex * > &buffs, size_t nitems,
+            double timeout, osmosdr::stream_metadata &meta );
+  int write( const std::vector< const gr_complex * > &buffs, size_t nitems,
+             double timeout, const osmosdr::stream_metadata &meta );
+
+  osmosdr::meta_range_t get_sample_rates( void );
+  double set_sample_rate( double rate );
+  double get_sample_rate( void );
+
+  osmosdr::freq_range_t get_freq_range( size_t chan = 0 );
+  double set_center_freq( double freq, size_t chan = 0 );
+  double get_center_freq( size_t chan = 0 );
+
+  osmosdr::gain_range_t get_gain_range( size_t chan = 0 );
+  bool set_gain_mode( bool automatic, size_t chan = 0 );
+  double set_gain( double gain, size_t chan = 0 );
+  double get_gain( size_t chan = 0 );
+
+  std::vector< std::string > get_antennas( size_t chan = 0 );
+  std::string set_antenna( const std::string & antenna, size_t chan = 0 );
+  std::string get_antenna( size_t chan = 0 );
+
+  double set_bandwidth( double bandwidth, size_t chan = 0 );
+  double get_bandwidth( size_t chan = 0 );
+
+private:
+  int receive( gr_vector_void_star &out, int nitems,
+               std::vector< gr::tag_t > &tags );
+  int take_pending( const std::vector< gr_complex * > &buffs, size_t offset,
+                    size_t nitems, std::vector< gr::tag_t > &tags );
+
+  direction_t _direction;
+  size_t _nchan;
+  bool _active;
+
+  /* the backend, called directly through its work() */
+  gr::basic_block_sptr _block;
+  direct_block *_work;
+  direct_state _state;
+
+  source_iface *_src;
+  sink_iface *_snk;
+
+  double _rate;
+  double _freq;
+  bool _freq_tagged;      /* the backend tags rx_freq, retunes show up in band */
+  uint64_t _overflows;
+
+  /* samples the backend returned beyond a retune, read out first */
+  std::vector< std::vector< gr_complex > > _pend;
+  std::vector< gr::tag_t > _pend_tags;
+  size_t _pend_pos;
+  osmosdr::time_spec_t _pend_time;
+};
+
+#endif /* INCLUDED_OSMOSDR_STREAM_IMPL_H */
@@ -0,0 +1,375 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/fft/fft.h>
+#include <gnuradio/fft/window.h>
+
+#include <volk/volk.h>
+
+#include "survey_impl.h"
+
+/* hops queued or in flight per worker before work() waits */
+#define SURVEY_JOBS_PER_WORKER 2
+
+#define SURVEY_UNKNOWN size_t(-1)
+
+static const pmt::pmt_t RX_FREQ_KEY = pmt::string_to_symbol("rx_freq");
+static const pmt::pmt_t RX_TIME_KEY = pmt::string_to_symbol("rx_time");
+
+osmosdr::survey::sptr
+osmosdr::survey::make( osmosdr::source::sptr src, double start_freq,
+                       double stop_freq, size_t fft_len, size_t avg,
+                       double usable, double settle, size_t threads )
+{
+  return gnuradio::get_initial_sptr(
+        new survey_impl( src, start_freq, stop_freq, fft_len, avg,
+                         usable, settle, threads ) );
+}
+
+/* bins kept per hop, even so the hop center falls on a bin edge */
+static size_t survey_keep( size_t fft_len, double usable )
+{
+  size_t keep = size_t( fft_len * usable ) & ~size_t(1);
+
+  return std::min( std::max( keep, size_t(2) ), fft_len );
+}
+
+static size_t survey_num_hops( osmosdr::source::sptr src, double start_freq,
+                               double stop_freq, size_t fft_len, double usable )
+{
+  if ( fft_len < 16 || fft_len % 2 )
+    throw std::runtime_error("The survey FFT length must be even and at least 16.");
+
+  if ( usable <= 0 || usable > 1 )
+    throw std::runtime_error("The usable fraction of a hop must be in (0, 1].");
+
+  if ( stop_freq <= start_freq )
+    throw std::runtime_error("The survey stop frequency must be above the start frequency.");
+
+  double rate = src->get_sample_rate();
+  if ( !( rate > 0 ) )
+    throw std::runtime_error("The source sample rate has to be set before creating a survey.");
+
+  double step = survey_keep( fft_len, usable ) * rate / fft_len;
+
+  return std::max( size_t(1), size_t( std::ceil( ( stop_freq - start_freq ) / step ) ) );
+}
+
+survey_impl::survey_impl( osmosdr::source::sptr src, double start_freq,
+                          double stop_freq, size_t fft_len, size_t avg,
+                          double usable, double settle, size_t threads )
+  : gr::block( "survey",
+               gr::io_signature::make( 1, 1, sizeof(gr_complex) ),
+               gr::io_signature::make( 1, 1, sizeof(float) *
+                   survey_keep( fft_len, usable ) *
+                   survey_num_hops( src, start_freq, stop_freq, fft_len, usable ) ) ),
+    _start_freq( start_freq ),
+    _rate( src->get_sample_rate() ),
+    _fft_len( fft_len ),
+    _avg( std::max( avg, size_t(1) ) ),
+    _keep( survey_keep( fft_len, usable ) ),
+    _collecting( false ),
+    _hop( 0 ),
+    _hop_time( pmt::PMT_NIL ),
+    _sweep( 0 ),
+    _sweep_jobs( 0 ),
+    _have_hop( false ),
+    _running( false ),
+    _busy( 0 )
+{
+  size_t nhops = survey_num_hops( src, start_freq, stop_freq, fft_len, usable );
+  double step = _keep * _rate / _fft_len;
+
+  /* bin k0 of each hop lands on start_freq + hop * step */
+  for ( size_t hop = 0; hop < nhops; hop++ )
+    _hops.push_back( start_freq + hop * step + step / 2 );
+
+  /* frames overlap by half, the whole hop is one dwell of the scan */
+  _seg_len = _fft_len * ( _avg + 1 ) / 2;
+  _seg.reserve( _seg_len );
+
+  _window = gr::fft::window::blackman_harris( _fft_len );
+
+  double power = 0;
+  for ( float tap : _window )
+    power += tap * tap;
+
+  /* average noise power per bin, independent of window and length */
+  _scale = 1.0f / float( power * _fft_len * _avg );
+
+  _nthreads = threads ? threads : std::thread::hardware_concurrency();
+  _nthreads = std::max( _nthreads, size_t(1) );
+
+  set_tag_propagation_policy( TPP_DONT );
+
+  src->start_scan( _hops, double( _seg_len ) / _rate, settle );
+}
+
+survey_impl::~survey_impl()
+{
+  if ( !_workers.empty() )
+    stop();
+}
+
+size_t survey_impl::get_num_bins()
+{
+  return _hops.size() * _keep;
+}
+
+double survey_impl::get_bin_width()
+{
+  return _rate / _fft_len;
+}
+
+std::vector< double > survey_impl::get_freqs()
+{
+  std::vector< double > freqs( get_num_bins() );
+
+  for ( size_t i = 0; i < freqs.size(); i++ )
+    freqs[i] = _start_freq + i * get_bin_width();
+
+  return freqs;
+}
+
+std::vector< double > survey_impl::get_hops()
+{
+  return _hops;
+}
+
+bool survey_impl::start()
+{
+  std::lock_guard< std::mutex > lock( _lock );
+
+  _running = true;
+  for ( size_t i = 0; i < _nthreads; i++ )
+    _workers.push_back( std::thread( &survey_impl::worker_loop, this ) );
+
+  return true;
+}
+
+bool survey_impl::stop()
+{
+  {
+    std::lock_guard< std::mutex > lock( _lock );
+    _running = false;
+  }
+  _cond.notify_all();
+
+  for ( std::thread &worker : _workers )
+    worker.join();
+
+  _workers.clear();
+  _jobs.clear();
+  _sweeps.clear();
+
+  return true;
+}
+
+void survey_impl::worker_loop()
+{
+  gr::fft::fft_complex_fwd fft( _fft_len );
+  std::vector< float > acc( _fft_len ), mag( _fft_len );
+  const size_t frame_step = _fft_len / 2;
+
+  std::unique_lock< std::mutex > lock( _lock );
+
+  while ( true ) {
+    while ( _running && _jobs.empty() )
+      _cond.wait( lock );
+
+    if ( !_running )
+      break;
+
+    job_t job = std::move( _jobs.front() );
+    _jobs.pop_front();
+    _busy++;
+    lock.unlock();
+
+    std::fill( acc.begin(), acc.end(), 0.0f );
+
+    for ( size_t frame = 0; frame < _avg; frame++ ) {
+      volk_32fc_32f_multiply_32fc( fft.get_inbuf(),
+                                   &job.samples[ frame * frame_step ],
+                                   _window.data(), _fft_len );
+      fft.execute();
+      volk_32fc_magnitude_squared_32f( mag.data(), fft.get_outbuf(), _fft_len );
+      volk_32f_x2_add_32f( acc.data(), acc.data(), mag.data(), _fft_len );
+    }
+
+    lock.lock();
+
+    /* the sweep stays in the map until all of its hops are done */
+    sweep_t &sweep = _sweeps[ job.sweep ];
+    float *dst = &sweep.power[ job.hop * _keep ];
+    size_t first = _fft_len / 2 - _keep / 2;
+
+    /* fftshift, keeping the center of the band only */
+    for ( size_t i = 0; i < _keep; i++ )
+      dst[i] = acc[ ( first + i + _fft_len / 2 ) % _fft_len ] * _scale;
+
+    sweep.done++;
+    _busy--;
+
+    _cond.notify_all();
+  }
+}
+
+void survey_impl::queue_segment()
+{
+  std::unique_lock< std::mutex > lock( _lock );
+
+  while ( _running && _jobs.size() + _busy >= SURVEY_JOBS_PER_WORKER * _nthreads )
+    _cond.wait( lock );
+
+  if ( !_running )
+    return;
+
+  sweep_t &sweep = _sweeps[ _sweep ];
+  if ( sweep.power.empty() ) {
+    sweep.power.resize( get_num_bins() );
+    sweep.done = 0;
+    sweep.expected = SURVEY_UNKNOWN;
+    sweep.time = _hop_time;
+  }
+
+  job_t job;
+  job.sweep = _sweep;
+  job.hop = _hop;
+  job.samples.swap( _seg );
+  _jobs.push_back( std::move( job ) );
+  _sweep_jobs++;
+
+  _seg.reserve( _seg_len );
+
+  _cond.notify_all();
+}
+
+void survey_impl::close_sweep()
+{
+  std::lock_guard< std::mutex > lock( _lock );
+
+  std::map< uint64_t, sweep_t >::iterator it = _sweeps.find( _sweep );
+  if ( it != _sweeps.end() )
+    it->second.expected = _sweep_jobs;
+
+  _sweep++;
+  _sweep_jobs = 0;
+}
+
+int survey_impl::general_work( int noutput_items,
+                               gr_vector_int &ninput_items,
+                               gr_vector_const_void_star &input_items,
+                               gr_vector_void_star &output_items )
+{
+  const gr_complex *in = (const gr_complex *) input_items[0];
+  float *out = (float *) output_items[0];
+  const size_t nbins = get_num_bins();
+  int nin = ninput_items[0];
+  int produced = 0;
+
+  {
+    std::lock_guard< std::mutex > lock( _lock );
+
+    /* finished sweeps leave in order, incomplete ones are dropped */
+    while ( produced < noutput_items && !_sweeps.empty() ) {
+      std::map< uint64_t, sweep_t >::iterator it = _sweeps.begin();
+      sweep_t &sweep = it->second;
+
+      if ( SURVEY_UNKNOWN == sweep.expected || sweep.done < sweep.expected )
+        break;
+
+      if ( sweep.expected == _hops.size() ) {
+        memcpy( out + produced * nbins, sweep.power.data(), nbins * sizeof(float) );
+        if ( !pmt::is_null( sweep.time ) )
+          add_item_tag( 0, nitems_written( 0 ) + produced, RX_TIME_KEY, sweep.time );
+        produced++;
+      }
+
+      _sweeps.erase( it );
+    }
+  }
+
+  const uint64_t base = nitems_read( 0 );
+  std::vector< gr::tag_t > freq_tags, time_tags;
+  get_tags_in_range( freq_tags, 0, base, base + nin, RX_FREQ_KEY );
+  get_tags_in_range( time_tags, 0, base, base + nin, RX_TIME_KEY );
+
+  const double step = _keep * get_bin_width();
+  size_t t = 0;
+  int i = 0;
+
+  while ( i < nin ) {
+    int next = t < freq_tags.size() ? int( freq_tags[t].offset - base ) : nin;
+
+    if ( i == next ) {
+      /* a new dwell segment of the scan, anything half collected is lost */
+      double freq = pmt::to_double( freq_tags[t].value );
+      long hop = std::lround( ( freq - _hops[0] ) / step );
+
+      _seg.clear();
+      _collecting = false;
+
+      if ( hop >= 0 && hop < long( _hops.size() ) &&
+           std::abs( freq - _hops[ hop ] ) < get_bin_width() ) {
+        if ( _have_hop && size_t( hop ) <= _hop )
+          close_sweep();
+
+        _hop = hop;
+        _have_hop = true;
+        _collecting = true;
+
+        _hop_time = pmt::PMT_NIL;
+        for ( const gr::tag_t &tag : time_tags )
+          if ( tag.offset == freq_tags[t].offset )
+            _hop_time = tag.value;
+      }
+
+      t++;
+      continue;
+    }
+
+    int n = next - i;
+    if ( _collecting ) {
+      n = int( std::min( size_t( n ), _seg_len - _seg.size() ) );
+      _seg.insert( _seg.end(), in + i, in + i + n );
+
+      if ( _seg.size() == _seg_len ) {
+        queue_segment();
+        _collecting = false;
+      }
+    }
+
+    i += n;
+  }
+
+  consume_each( nin );
+
+  return produced;
+}
@@ -0,0 +1,102 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_OSMOSDR_SURVEY_IMPL_H
+#define INCLUDED_OSMOSDR_SURVEY_IMPL_H
+
+#include <osmosdr/survey.h>
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+class survey_impl : public osmosdr::survey
+{
+public:
+  survey_impl( osmosdr::source::sptr src, double start_freq, double stop_freq,
+               size_t fft_len, size_t avg, double usable, double settle,
+               size_t threads );
+  ~survey_impl();
+
+  size_t get_num_bins( void );
+  double get_bin_width( void );
+  std::vector< double > get_freqs( void );
+  std::vector< double > get_hops( void );
+
+  bool start();
+  bool stop();
+
+  int general_work( int noutput_items,
+                    gr_vector_int &ninput_items,
+                    gr_vector_const_void_star &input_items,
+                    gr_vector_void_star &output_items );
+
+private:
+  /* one hop worth of samples on its way to a worker */
+  struct job_t
+  {
+    uint64_t sweep;
+    size_t hop;
+    std::vector< gr_complex > samples;
+  };
+
+  struct sweep_t
+  {
+    std::vector< float > power;
+    size_t done;      /* hops finished by the workers */
+    size_t expected;  /* hops queued, known once the next sweep started */
+    pmt::pmt_t time;
+  };
+
+  void worker_loop();
+  void queue_segment();
+  void close_sweep();
+
+  double _start_freq;
+  double _rate;
+  size_t _fft_len;
+  size_t _avg;
+  size_t _keep;
+  size_t _seg_len;
+  size_t _nthreads;
+  std::vector< double > _hops;
+  std::vector< float > _window;
+  float _scale;
+
+  /* segment being collected by work() */
+  std::vector< gr_complex > _seg;
+  bool _collecting;
+  size_t _hop;
+  pmt::pmt_t _hop_time;
+  uint64_t _sweep;
+  size_t _sweep_jobs;
+  bool _have_hop;
+
+  std::mutex _lock;
+  std::condition_variable _cond;
+  std::vector< std::thread > _workers;
+  bool _running;
+  size_t _busy;
+  std::deque< job_t > _jobs;
+  std::map< uint64_t, sweep_t > _sweeps;
+};
+
+#endif /* INCLUDED_OSMOSDR_SURVEY_IMPL_H */
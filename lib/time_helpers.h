@@ -0,0 +1,292 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef OSMOSDR_TIME_HELPERS_H
+#define OSMOSDR_TIME_HELPERS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+#include <osmosdr/time_spec.h>
+#include <pmt/pmt.h>
+
+/* length of the blocks a minimum arrival is taken from, in seconds */
+#define HOST_CLOCK_BLOCK 1.0
+
+/* number of block minima the clock line is fitted to */
+#define HOST_CLOCK_BLOCKS 32
+
+/*
+ * Where a transfer starts in the output of a backend with a sample FIFO,
+ * and in the counts of its host_clock.
+ */
+struct time_mark
+{
+  uint64_t pos;
+  uint64_t count;
+  size_t nitems;
+};
+
+/*
+ * Sample timestamps from the host clock for backends without hardware time.
+ *
+ * The streaming callback reports every transfer when it arrives. Its last
+ * sample was taken at the arrival time less a delay that varies with USB
+ * and scheduling, but never gets below some minimum. So the estimate is
+ * the lower envelope of the arrivals: the earliest one relative to the
+ * nominal rate is kept for every HOST_CLOCK_BLOCK, and a line is fitted
+ * through the last HOST_CLOCK_BLOCKS of them by least squares. Its slope
+ * follows the rate error of the device's crystal.
+ *
+ * Times are realtime host clock, plus whatever offset set_time() put on
+ * top. The callback, work() and the user calls may come from different
+ * threads, they are serialized internally.
+ */
+class host_clock
+{
+public:
+  host_clock()
+    : _rate( 0 ), _count( 0 ), _base( 0 ), _origin( 0 ), _offset( 0 ),
+      _block_end( 0 ), _have_min( false ), _min_count( 0 ), _min_resid( 0 ),
+      _fitted( false ), _a( 0 ), _s( 0 ), _mean( 0 ),
+      _period( 0 ), _expected( 0 ), _next_tag( 0 ), _tagged( false )
+  {
+  }
+
+  /* starts over with a new stream, counts begin at 0 */
+  void reset( double rate )
+  {
+    std::lock_guard< std::mutex > lock( _mutex );
+
+    _rate = rate > 0 ? rate : 0; /* unknown as yet */
+    _count = 0;
+    _base = 0;
+    _origin = 0;
+    _block_end = 0;
+    _have_min = false;
+    _mins.clear();
+    _fitted = false;
+    _tagged = false;
+  }
+
+  /*
+   * The rate changed while streaming. Counts go on, the line is fitted
+   * anew from the next arrival and the next transfer gets a tag.
+   */
+  void set_rate( double rate )
+  {
+    std::lock_guard< std::mutex > lock( _mutex );
+
+    _rate = rate > 0 ? rate : 0;
+    _base = _count;
+    _origin = 0;
+    _block_end = 0;
+    _have_min = false;
+    _mins.clear();
+    _fitted = false;
+    _tagged = false;
+  }
+
+  /* rx_time tags every period seconds, 0 to tag only after gaps */
+  void set_tag_period( double period ) { _period = period; }
+
+  /* a transfer of nitems arrived, returns the count of its first sample */
+  uint64_t arrival( size_t nitems )
+  {
+    int64_t now = host_ns();
+
+    std::lock_guard< std::mutex > lock( _mutex );
+
+    uint64_t first = _count;
+    _count += nitems;
+
+    if ( _rate <= 0 )
+      return first;
+
+    if ( !_origin ) {
+      _origin = now;
+      _block_end = _count + uint64_t( HOST_CLOCK_BLOCK * _rate );
+    }
+
+    /* arrival of the transfer's end against the nominal rate */
+    double resid = ( now - _origin ) / 1e9 - ( _count - _base ) / _rate;
+
+    if ( !_have_min || resid < _min_resid ) {
+      _have_min = true;
+      _min_count = _count;
+      _min_resid = resid;
+    }
+
+    if ( _count >= _block_end ) {
+      _mins.push_back( std::make_pair( double( _min_count ), _min_resid ) );
+      if ( _mins.size() > HOST_CLOCK_BLOCKS )
+        _mins.pop_front();
+
+      _have_min = false;
+      _block_end = _count + uint64_t( HOST_CLOCK_BLOCK * _rate );
+
+      fit();
+    }
+
+    return first;
+  }
+
+  /* the time the sample with that count was taken */
+  osmosdr::time_spec_t time_of( uint64_t count )
+  {
+    std::lock_guard< std::mutex > lock( _mutex );
+
+    if ( !_origin )
+      return to_time_spec( host_ns() + _offset );
+
+    double resid;
+    if ( _fitted )
+      resid = _a + _s * ( double( count ) - _mean );
+    else
+      resid = _min_resid;
+
+    double secs = ( double( count ) - double( _base ) ) / _rate + resid;
+
+    return to_time_spec( _origin + int64_t( std::floor( secs * 1e9 ) ) + _offset );
+  }
+
+  /*
+   * Whether the transfer of nitems starting at count gets an rx_time tag:
+   * the first one, one following a gap in the counts and one per period.
+   * To be called by work() for every transfer in order.
+   */
+  bool tag_due( uint64_t count, size_t nitems )
+  {
+    std::lock_guard< std::mutex > lock( _mutex );
+
+    bool due = !_tagged || count != _expected ||
+               ( _period > 0 && count >= _next_tag );
+
+    _expected = count + nitems;
+
+    if ( due ) {
+      _tagged = true;
+      _next_tag = count + uint64_t( _period * _rate );
+    }
+
+    return due;
+  }
+
+  osmosdr::time_spec_t now( void )
+  {
+    std::lock_guard< std::mutex > lock( _mutex );
+
+    return to_time_spec( host_ns() + _offset );
+  }
+
+  /* moves the timeline, the host clock reads time now */
+  void set_time( const osmosdr::time_spec_t &time )
+  {
+    int64_t ns = int64_t( time.get_full_secs() ) * 1000000000LL +
+                 int64_t( std::floor( time.get_frac_secs() * 1e9 ) );
+
+    std::lock_guard< std::mutex > lock( _mutex );
+
+    _offset = ns - host_ns();
+    _tagged = false; /* the next transfer tells the new time */
+  }
+
+private:
+  static int64_t host_ns( void )
+  {
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(
+          std::chrono::system_clock::now().time_since_epoch() ).count();
+  }
+
+  static osmosdr::time_spec_t to_time_spec( int64_t ns )
+  {
+    int64_t secs = ns / 1000000000LL;
+    int64_t frac = ns % 1000000000LL;
+    if ( frac < 0 ) {
+      secs--;
+      frac += 1000000000LL;
+    }
+
+    return osmosdr::time_spec_t( time_t( secs ), double( frac ) / 1e9 );
+  }
+
+  void fit( void )
+  {
+    const double n = double( _mins.size() );
+
+    double mx = 0, my = 0;
+    for ( const std::pair< double, double > &p : _mins ) {
+      mx += p.first;
+      my += p.second;
+    }
+    mx /= n;
+    my /= n;
+
+    double sxx = 0, sxy = 0;
+    for ( const std::pair< double, double > &p : _mins ) {
+      sxx += ( p.first - mx ) * ( p.first - mx );
+      sxy += ( p.first - mx ) * ( p.second - my );
+    }
+
+    _mean = mx;
+    _s = sxx > 0 ? sxy / sxx : 0;
+    _a = my;
+    _fitted = true;
+  }
+
+  std::mutex _mutex;
+
+  double _rate;
+  uint64_t _count;           /* samples reported so far */
+  uint64_t _base;            /* count at the last rate change */
+  int64_t _origin;           /* host time of the first arrival, ns */
+  int64_t _offset;           /* set by set_time(), ns */
+
+  uint64_t _block_end;
+  bool _have_min;
+  uint64_t _min_count;       /* of the earliest arrival in the block */
+  double _min_resid;
+  std::deque< std::pair< double, double > > _mins;
+
+  bool _fitted;              /* resid = _a + _s * ( count - _mean ) */
+  double _a;
+  double _s;
+  double _mean;
+
+  double _period;
+  uint64_t _expected;        /* count following the last transfer */
+  uint64_t _next_tag;
+  bool _tagged;
+};
+
+/* the value of an rx_time tag */
+inline pmt::pmt_t time_to_pmt( const osmosdr::time_spec_t &time )
+{
+  return pmt::make_tuple( pmt::from_uint64( time.get_full_secs() ),
+                          pmt::from_double( time.get_frac_secs() ) );
+}
+
+#endif // OSMOSDR_TIME_HELPERS_H
@@ -50,7 +50,7 @@ uhd_sink_c::uhd_sink_c(const std::string &args) :
     gr::hier_block2("uhd_sink_c",
                    gr::io_signature::make(parse_nchan(args),
                                           parse_nchan(args),
-                                          sizeof(gr_complex)),
+                                          args_to_item_size(args)),
                    gr::io_signature::make(0, 0, 0)),
     _center_freq(0.0f),
     _freq_corr(0.0f),
@@ -79,13 +79,15 @@ uhd_sink_c::uhd_sink_c(const std::string &args) :
          "nchan" == entry.first ||
          "subdev" == entry.first ||
          "lo_offset" == entry.first ||
+         "item_type" == entry.first ||
          "uhd" == entry.first )
       continue;
 
     arguments += entry.first + "=" + entry.second + ",";
   }
 
-  stream_args.cpu_format = "fc32";
+  /* the item types are named like the UHD host formats */
+  stream_args.cpu_format = args_to_item_type(args);
   stream_args.otw_format = "sc16";
 
   if (dict.count("cpu_format") )
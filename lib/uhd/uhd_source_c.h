@@ -72,9 +72,11 @@ public:
   std::string get_antenna( size_t chan = 0 );
 
   void set_dc_offset_mode( int mode, size_t chan = 0 );
+  bool has_dc_offset_mode( size_t chan = 0 ) { return true; }
   void set_dc_offset( const std::complex<double> &offset, size_t chan = 0 );
 
   void set_iq_balance_mode( int mode, size_t chan = 0 );
+  bool has_iq_balance_mode( size_t chan = 0 ) { return true; }
   void set_iq_balance( const std::complex<double> &balance, size_t chan = 0 );
 
   double set_bandwidth( double bandwidth, size_t chan = 0 );
@@ -0,0 +1,416 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "convert_helpers.h"
+
+#include "vrt_common.h"
+
+/* context indicator field bits, VITA 49.0 */
+#define VRT_CIF_CHANGED ( 1u << 31 )
+#define VRT_CIF_BANDWIDTH ( 1u << 29 )
+#define VRT_CIF_RF_FREQ ( 1u << 27 )
+#define VRT_CIF_GAIN ( 1u << 23 )
+#define VRT_CIF_RATE ( 1u << 21 )
+
+/* frequencies and rates are fixed point with 20 fractional bits */
+#define VRT_FREQ_SCALE 1048576.0
+
+/* gains are fixed point with 7 fractional bits */
+#define VRT_GAIN_SCALE 128.0
+
+static uint32_t read_word( const uint8_t *buf, size_t word )
+{
+  uint32_t v;
+  memcpy( &v, buf + 4 * word, sizeof(v) );
+  return ntohl( v );
+}
+
+static void write_word( uint8_t *buf, size_t word, uint32_t v )
+{
+  v = htonl( v );
+  memcpy( buf + 4 * word, &v, sizeof(v) );
+}
+
+static int64_t read_long( const uint8_t *buf, size_t word )
+{
+  return int64_t( ( uint64_t( read_word( buf, word ) ) << 32 ) | read_word( buf, word + 1 ) );
+}
+
+static void write_long( uint8_t *buf, size_t word, int64_t v )
+{
+  write_word( buf, word, uint32_t( uint64_t( v ) >> 32 ) );
+  write_word( buf, word + 1, uint32_t( v ) );
+}
+
+vrt_format vrt_parse_format( const std::string &format )
+{
+  if ( format.empty() || format == "sc16" )
+    return VRT_FORMAT_SC16;
+
+  if ( format == "sc8" )
+    return VRT_FORMAT_SC8;
+
+  if ( format == "fc32" )
+    return VRT_FORMAT_FC32;
+
+  throw std::runtime_error( "Unsupported format '" + format + "', use sc8, sc16 or fc32." );
+}
+
+size_t vrt_format_size( vrt_format format )
+{
+  switch ( format ) {
+  case VRT_FORMAT_SC8: return 2 * sizeof(int8_t);
+  case VRT_FORMAT_FC32: return 2 * sizeof(float);
+  default: return 2 * sizeof(int16_t);
+  }
+}
+
+bool vrt_parse( uint8_t *buf, size_t len, vrt_packet &pkt )
+{
+  if ( len < 4 )
+    return false;
+
+  uint32_t hdr = read_word( buf, 0 );
+  size_t size = hdr & 0xffff;
+
+  if ( !size || 4 * size > len )
+    return false;
+
+  pkt.type = hdr >> 28;
+  pkt.count = ( hdr >> 16 ) & 0xf;
+  pkt.tsi = ( hdr >> 22 ) & 3;
+  pkt.tsf = ( hdr >> 20 ) & 3;
+  pkt.has_sid = ( pkt.type & 1 ) || pkt.type >= VRT_TYPE_CONTEXT;
+
+  size_t word = 1;
+  size_t trailer = pkt.type < VRT_TYPE_CONTEXT && ( hdr & ( 1u << 26 ) ) ? 1 : 0;
+  size_t prologue = 1 + ( pkt.has_sid ? 1 : 0 ) + ( hdr & ( 1u << 27 ) ? 2 : 0 ) +
+                    ( pkt.tsi ? 1 : 0 ) + ( pkt.tsf ? 2 : 0 );
+
+  if ( prologue + trailer > size )
+    return false;
+
+  pkt.sid = pkt.has_sid ? read_word( buf, word++ ) : 0;
+
+  if ( hdr & ( 1u << 27 ) )
+    word += 2; /* class id */
+
+  pkt.secs = pkt.tsi ? read_word( buf, word++ ) : 0;
+
+  pkt.frac = 0;
+  if ( pkt.tsf ) {
+    pkt.frac = uint64_t( read_long( buf, word ) );
+    word += 2;
+  }
+
+  pkt.payload = buf + 4 * word;
+  pkt.payload_len = 4 * ( size - word - trailer );
+
+  return true;
+}
+
+bool vrt_parse_context( const vrt_packet &pkt, vrt_context &ctx )
+{
+  /* words of the fields from bit 30 down to the sample rate at bit 21 */
+  static const size_t sizes[] = { 1, 2, 2, 2, 2, 2, 1, 1, 1, 2 };
+
+  const uint8_t *buf = pkt.payload;
+  size_t words = pkt.payload_len / 4;
+
+  if ( !words )
+    return false;
+
+  uint32_t cif = read_word( buf, 0 );
+  size_t word = 1;
+
+  ctx.changed = ( cif & VRT_CIF_CHANGED ) != 0;
+  ctx.has_bandwidth = ctx.has_freq = ctx.has_gain = ctx.has_rate = false;
+
+  for ( unsigned int bit = 30; bit >= 21; bit-- ) {
+    if ( !( cif & ( 1u << bit ) ) )
+      continue;
+
+    size_t size = sizes[ 30 - bit ];
+    if ( word + size > words )
+      return false;
+
+    if ( ( 1u << bit ) == VRT_CIF_BANDWIDTH ) {
+      ctx.has_bandwidth = true;
+      ctx.bandwidth = read_long( buf, word ) / VRT_FREQ_SCALE;
+    } else if ( ( 1u << bit ) == VRT_CIF_RF_FREQ ) {
+      ctx.has_freq = true;
+      ctx.freq = read_long( buf, word ) / VRT_FREQ_SCALE;
+    } else if ( ( 1u << bit ) == VRT_CIF_GAIN ) {
+      uint32_t gain = read_word( buf, word );
+      ctx.has_gain = true;
+      ctx.gain = ( int16_t( gain & 0xffff ) + int16_t( gain >> 16 ) ) / VRT_GAIN_SCALE;
+    } else if ( ( 1u << bit ) == VRT_CIF_RATE ) {
+      ctx.has_rate = true;
+      ctx.rate = read_long( buf, word ) / VRT_FREQ_SCALE;
+    }
+
+    word += size;
+  }
+
+  return true;
+}
+
+size_t vrt_write_data_header( uint8_t *buf, unsigned int count, uint32_t sid,
+                              uint32_t secs, uint64_t ps, size_t payload_len )
+{
+  const size_t words = 5;
+  size_t size = words + ( payload_len + 3 ) / 4;
+
+  write_word( buf, 0, ( uint32_t( VRT_TYPE_DATA_SID ) << 28 ) |
+                      ( VRT_TSI_UTC << 22 ) | ( VRT_TSF_PICOSECONDS << 20 ) |
+                      ( ( count & 0xf ) << 16 ) | uint32_t( size ) );
+  write_word( buf, 1, sid );
+  write_word( buf, 2, secs );
+  write_long( buf, 3, int64_t( ps ) );
+
+  return 4 * words;
+}
+
+size_t vrt_write_context( uint8_t *buf, unsigned int count, uint32_t sid,
+                          uint32_t secs, uint64_t ps, bool changed,
+                          double freq, double gain, double rate )
+{
+  const size_t words = 11;
+
+  write_word( buf, 0, ( uint32_t( VRT_TYPE_CONTEXT ) << 28 ) |
+                      ( VRT_TSI_UTC << 22 ) | ( VRT_TSF_PICOSECONDS << 20 ) |
+                      ( ( count & 0xf ) << 16 ) | uint32_t( words ) );
+  write_word( buf, 1, sid );
+  write_word( buf, 2, secs );
+  write_long( buf, 3, int64_t( ps ) );
+  write_word( buf, 5, ( changed ? VRT_CIF_CHANGED : 0 ) |
+                      VRT_CIF_RF_FREQ | VRT_CIF_GAIN | VRT_CIF_RATE );
+  write_long( buf, 6, std::llround( freq * VRT_FREQ_SCALE ) );
+
+  /* all of it on stage 1 */
+  double stage1 = std::max( -32768.0, std::min( 32767.0, std::round( gain * VRT_GAIN_SCALE ) ) );
+  write_word( buf, 8, uint32_t( uint16_t( int16_t( stage1 ) ) ) );
+  write_long( buf, 9, std::llround( rate * VRT_FREQ_SCALE ) );
+
+  return 4 * words;
+}
+
+void vrt_payload_to_32fc( uint8_t *payload, size_t nsamples, vrt_format format,
+                          float *out )
+{
+  if ( VRT_FORMAT_SC8 == format ) {
+    convert_8i_to_32f( (const int8_t *)payload, out, 2 * nsamples, 1.0f / 128.0f );
+  } else if ( VRT_FORMAT_SC16 == format ) {
+    int16_t *iq = (int16_t *)payload;
+    for ( size_t i = 0; i < 2 * nsamples; i++ )
+      iq[i] = int16_t( ntohs( uint16_t( iq[i] ) ) );
+
+    convert_16i_to_32f( iq, out, 2 * nsamples, 1.0f / 32768.0f );
+  } else {
+    for ( size_t i = 0; i < 2 * nsamples; i++ ) {
+      uint32_t v = read_word( payload, i );
+      memcpy( out + i, &v, sizeof(v) );
+    }
+  }
+}
+
+void vrt_items_to_payload( const void *items, size_t item_size, size_t nsamples,
+                           vrt_format format, uint8_t *payload )
+{
+  const size_t count = 2 * nsamples;
+
+  if ( VRT_FORMAT_SC8 == format ) {
+    int8_t *out = (int8_t *)payload;
+    if ( item_size == 2 * sizeof(int8_t) )
+      memcpy( out, items, count );
+    else if ( item_size == 2 * sizeof(int16_t) )
+      convert_16i_to_8i( (const int16_t *)items, out, count, 8 );
+    else
+      convert_32f_to_8i( (const float *)items, out, count, 127.0f );
+  } else if ( VRT_FORMAT_SC16 == format ) {
+    int16_t *out = (int16_t *)payload;
+    if ( item_size == 2 * sizeof(int16_t) )
+      memcpy( out, items, count * sizeof(int16_t) );
+    else if ( item_size == 2 * sizeof(int8_t) )
+      convert_8i_to_16i( (const int8_t *)items, out, count, 8 );
+    else
+      convert_32f_to_16i( (const float *)items, out, count, 32767.0f );
+
+    for ( size_t i = 0; i < count; i++ )
+      out[i] = int16_t( htons( uint16_t( out[i] ) ) );
+  } else {
+    float *out = (float *)payload;
+    if ( item_size == 2 * sizeof(int16_t) )
+      convert_16i_to_32f( (const int16_t *)items, out, count, 1.0f / 32768.0f );
+    else if ( item_size == 2 * sizeof(int8_t) )
+      convert_8i_to_32f( (const int8_t *)items, out, count, 1.0f / 128.0f );
+    else
+      memcpy( out, items, count * sizeof(float) );
+
+    for ( size_t i = 0; i < count; i++ ) {
+      uint32_t v;
+      memcpy( &v, out + i, sizeof(v) );
+      write_word( payload, i, v );
+    }
+  }
+}
+
+void vrt_parse_address( const std::string &arg, const std::string &default_host,
+                        std::string &host, unsigned short &port )
+{
+  std::vector< std::string > tokens;
+  boost::algorithm::split( tokens, arg, boost::is_any_of( ":" ) );
+
+  host = tokens[0].length() ? tokens[0] : default_host;
+  port = VRT_DEFAULT_PORT;
+
+  if ( tokens.size() == 2 && tokens[1].length() )
+    port = boost::lexical_cast< unsigned short >( tokens[1] );
+  else if ( tokens.size() > 2 )
+    throw std::runtime_error( "vrt= takes an IPv4 address and port, host[:port]." );
+}
+
+static struct sockaddr_in make_address( const std::string &host, unsigned short port )
+{
+  struct sockaddr_in addr;
+
+  memset( &addr, 0, sizeof(addr) );
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons( port );
+
+  if ( inet_pton( AF_INET, host.c_str(), &addr.sin_addr ) != 1 )
+    throw std::runtime_error( "Invalid IPv4 address " + host + "." );
+
+  return addr;
+}
+
+static void set_buffer_size( SOCKET socket, int option, int size, const char *name )
+{
+  if ( size <= 0 )
+    return;
+
+  setsockopt( socket, SOL_SOCKET, option, (const char *)&size, sizeof(size) );
+
+  /* Linux caps it at net.core.rmem_max or wmem_max, and reports it doubled */
+  int actual = 0;
+  socklen_t len = sizeof(actual);
+  if ( !getsockopt( socket, SOL_SOCKET, option, (char *)&actual, &len ) &&
+       actual < size )
+    std::cerr << "VRT: " << name << " is " << actual << " instead of " << size
+              << " bytes, raise the system limit to avoid losing packets" << std::endl;
+}
+
+SOCKET vrt_open_rx_socket( const std::string &host, unsigned short port,
+                           const std::string &iface, int rcvbuf )
+{
+  struct sockaddr_in addr = make_address( host, port );
+  bool multicast = ( ntohl( addr.sin_addr.s_addr ) >> 28 ) == 0xe;
+  std::stringstream message;
+
+  SOCKET sock = socket( AF_INET, SOCK_DGRAM, 0 );
+  if ( sock == INVSOC )
+    throw std::runtime_error( "Could not create UDP socket." );
+
+  set_buffer_size( sock, SO_RCVBUF, rcvbuf, "rcvbuf" );
+
+  if ( multicast ) {
+    /* several receivers of a farm may listen to the same group */
+    int flag = 1;
+    setsockopt( sock, SOL_SOCKET, SO_REUSEADDR, (const char *)&flag, sizeof(flag) );
+
+    struct sockaddr_in any = make_address( "0.0.0.0", port );
+    if ( ::bind( sock, (struct sockaddr *)&any, sizeof(any) ) < 0 ) {
+      vrt_close_socket( sock );
+      message << "Could not bind to port " << port << ".";
+      throw std::runtime_error( message.str() );
+    }
+
+    struct ip_mreq mreq;
+    memset( &mreq, 0, sizeof(mreq) );
+    mreq.imr_multiaddr = addr.sin_addr;
+    mreq.imr_interface = make_address( iface.length() ? iface : "0.0.0.0", 0 ).sin_addr;
+
+    if ( setsockopt( sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char *)&mreq, sizeof(mreq) ) < 0 ) {
+      vrt_close_socket( sock );
+      throw std::runtime_error( "Could not join multicast group " + host + "." );
+    }
+  } else if ( ::bind( sock, (struct sockaddr *)&addr, sizeof(addr) ) < 0 ) {
+    vrt_close_socket( sock );
+    message << "Could not bind to " << host << ":" << port << ".";
+    throw std::runtime_error( message.str() );
+  }
+
+  return sock;
+}
+
+SOCKET vrt_open_tx_socket( const std::string &host, unsigned short port,
+                           int sndbuf )
+{
+  struct sockaddr_in addr = make_address( host, port );
+  std::stringstream message;
+
+  SOCKET sock = socket( AF_INET, SOCK_DGRAM, 0 );
+  if ( sock == INVSOC )
+    throw std::runtime_error( "Could not create UDP socket." );
+
+  set_buffer_size( sock, SO_SNDBUF, sndbuf, "sndbuf" );
+
+  if ( ::connect( sock, (struct sockaddr *)&addr, sizeof(addr) ) < 0 ) {
+    vrt_close_socket( sock );
+    message << "Could not connect to " << host << ":" << port << ".";
+    throw std::runtime_error( message.str() );
+  }
+
+  return sock;
+}
+
+void vrt_close_socket( SOCKET socket )
+{
+#if defined(_WIN32)
+  ::closesocket( socket );
+#else
+  ::close( socket );
+#endif
+}
+
+bool vrt_wait_socket( SOCKET socket, int timeout_ms )
+{
+  fd_set fds;
+  struct timeval tv;
+
+  FD_ZERO( &fds );
+  FD_SET( socket, &fds );
+
+  tv.tv_sec = timeout_ms / 1000;
+  tv.tv_usec = ( timeout_ms % 1000 ) * 1000;
+
+  return ::select( socket + 1, &fds, NULL, NULL, &tv ) > 0;
+}
@@ -0,0 +1,156 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef VRT_COMMON_H
+#define VRT_COMMON_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <string>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#define INVSOC INVALID_SOCKET
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#ifndef SOCKET
+#define SOCKET int
+#define INVSOC (-1)
+#endif
+#endif
+
+/* the port registered for the VITA Radio Transport */
+#define VRT_DEFAULT_PORT 4991
+
+/* largest payload of a UDP datagram */
+#define VRT_MAX_PACKET 65536
+
+/* packet types of the header, VITA 49.0 */
+#define VRT_TYPE_DATA 0             /* IF data without stream id */
+#define VRT_TYPE_DATA_SID 1         /* IF data with stream id */
+#define VRT_TYPE_CONTEXT 4          /* IF context, always with stream id */
+
+/* integer (TSI) and fractional (TSF) timestamp kinds */
+#define VRT_TSI_NONE 0
+#define VRT_TSI_UTC 1
+#define VRT_TSI_GPS 2
+#define VRT_TSF_NONE 0
+#define VRT_TSF_SAMPLES 1
+#define VRT_TSF_PICOSECONDS 2
+
+/* sample formats of the data payload, big endian as the standard has it */
+enum vrt_format
+{
+  VRT_FORMAT_SC8,
+  VRT_FORMAT_SC16,
+  VRT_FORMAT_FC32
+};
+
+/* the format= argument, sc16 when not given */
+vrt_format vrt_parse_format( const std::string &format );
+
+/* bytes of one complex sample */
+size_t vrt_format_size( vrt_format format );
+
+/* prologue and payload of a received packet, pointing into its buffer */
+struct vrt_packet
+{
+  unsigned int type;
+  unsigned int count;               /* packet count, modulo 16 */
+  bool has_sid;
+  uint32_t sid;
+  unsigned int tsi;
+  unsigned int tsf;
+  uint32_t secs;                    /* integer timestamp */
+  uint64_t frac;                    /* fractional timestamp */
+  uint8_t *payload;
+  size_t payload_len;               /* bytes */
+};
+
+/* false if the buffer does not hold a consistent packet */
+bool vrt_parse( uint8_t *buf, size_t len, vrt_packet &pkt );
+
+/* fields of a context packet, each with a flag telling it was sent */
+struct vrt_context
+{
+  bool changed;                     /* the change indicator */
+  bool has_bandwidth, has_freq, has_gain, has_rate;
+  double bandwidth;
+  double freq;                      /* RF reference frequency */
+  double gain;                      /* both stages, dB */
+  double rate;
+};
+
+/* false if the packet ends before the fields it announces */
+bool vrt_parse_context( const vrt_packet &pkt, vrt_context &ctx );
+
+/*
+ * Writes the prologue of a data packet with stream id and UTC seconds plus
+ * picoseconds, for payload_len bytes that follow. Returns its length.
+ */
+size_t vrt_write_data_header( uint8_t *buf, unsigned int count, uint32_t sid,
+                              uint32_t secs, uint64_t ps, size_t payload_len );
+
+/* writes a whole context packet with frequency, gain and rate */
+size_t vrt_write_context( uint8_t *buf, unsigned int count, uint32_t sid,
+                          uint32_t secs, uint64_t ps, bool changed,
+                          double freq, double gain, double rate );
+
+/* payload samples of the format to complex float, swaps the payload in place */
+void vrt_payload_to_32fc( uint8_t *payload, size_t nsamples, vrt_format format,
+                          float *out );
+
+/* nsamples items of item_size bytes, complex float, int16 or int8, to a payload */
+void vrt_items_to_payload( const void *items, size_t item_size, size_t nsamples,
+                           vrt_format format, uint8_t *payload );
+
+/*
+ * Host and port of a vrt= argument: host[:port], :port or empty. The port
+ * defaults to VRT_DEFAULT_PORT.
+ */
+void vrt_parse_address( const std::string &arg, const std::string &default_host,
+                        std::string &host, unsigned short &port );
+
+/*
+ * A UDP socket receiving on host:port, joining the group if host is a
+ * multicast address, on the interface with the address iface if given.
+ */
+SOCKET vrt_open_rx_socket( const std::string &host, unsigned short port,
+                           const std::string &iface, int rcvbuf );
+
+/* a UDP socket connected to host:port */
+SOCKET vrt_open_tx_socket( const std::string &host, unsigned short port,
+                           int sndbuf );
+
+void vrt_close_socket( SOCKET socket );
+
+/* Wait up to timeout_ms for the socket to become readable */
+bool vrt_wait_socket( SOCKET socket, int timeout_ms );
+
+#endif // VRT_COMMON_H
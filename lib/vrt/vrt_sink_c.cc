@@ -0,0 +1,489 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <string>
+#include <stdexcept>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#include <gnuradio/io_signature.h>
+
+#include "arg_helpers.h"
+
+#include "vrt_sink_c.h"
+
+/* payload bytes per packet by default, a datagram fits a 1500 byte MTU */
+#define VRT_PAYLOAD_LEN 1440
+
+/* bytes of the prologue of a data packet and of a whole context packet */
+#define VRT_DATA_HEADER_LEN 20
+#define VRT_CONTEXT_LEN 44
+
+/* packets sent per system call by default */
+#define VRT_BATCH 32
+
+static const pmt::pmt_t TX_TIME_KEY = pmt::string_to_symbol("tx_time");
+
+vrt_sink_c_sptr make_vrt_sink_c(const std::string &args)
+{
+  return gnuradio::get_initial_sptr(new vrt_sink_c(args));
+}
+
+vrt_sink_c::vrt_sink_c(const std::string &args) :
+  direct_block("vrt_sink_c",
+               gr::io_signature::make(1, 1, args_to_item_size(args)),
+               gr::io_signature::make(0, 0, 0)),
+  _item_size(args_to_item_size(args))
+{
+  std::string host;
+  unsigned short port;
+  int sndbuf = 4 * 1024 * 1024;
+
+#if defined(_WIN32)
+  WSADATA wsaData;
+  WSAStartup( MAKEWORD(2, 2), &wsaData );
+#endif
+
+  dict_t dict = params_to_dict( args );
+
+  vrt_parse_address( dict["vrt"], "127.0.0.1", host, port );
+
+  _format = vrt_parse_format( dict.count( "format" ) ? dict["format"] : "" );
+  _sample_size = vrt_format_size( _format );
+
+  _sid = dict.count( "stream_id" ) ? uint32_t( std::stoul( dict["stream_id"], NULL, 0 ) ) : 0;
+  _context_sid = _sid;
+  if ( dict.count( "context_id" ) )
+    _context_sid = uint32_t( std::stoul( dict["context_id"], NULL, 0 ) );
+
+  _spp = VRT_PAYLOAD_LEN / _sample_size;
+  if ( dict.count( "spp" ) )
+    _spp = std::max( boost::lexical_cast< size_t >( dict["spp"] ), size_t(1) );
+
+  /* whole payload words, sc8 samples take half of one */
+  if ( VRT_FORMAT_SC8 == _format )
+    _spp += _spp % 2;
+
+  if ( VRT_DATA_HEADER_LEN + _spp * _sample_size > 65507 )
+    throw std::runtime_error( "spp is too large for a UDP datagram." );
+
+  _packet_len = std::max( size_t( VRT_DATA_HEADER_LEN ) + _spp * _sample_size,
+                          size_t( VRT_CONTEXT_LEN ) );
+
+  _batch = VRT_BATCH;
+  if ( dict.count( "batch" ) )
+    _batch = std::max( boost::lexical_cast< size_t >( dict["batch"] ), size_t(1) );
+
+  if ( dict.count( "sndbuf" ) )
+    sndbuf = boost::lexical_cast< int >( dict["sndbuf"] );
+
+  _freq = dict.count( "freq" ) ? boost::lexical_cast< double >( dict["freq"] ) : 0;
+  _rate = dict.count( "rate" ) ? boost::lexical_cast< double >( dict["rate"] ) : 1e6;
+  _gain = _corr = 0;
+
+  _context_period = 1.0;
+  if ( dict.count( "context_period" ) )
+    _context_period = boost::lexical_cast< double >( dict["context_period"] );
+
+  _pace = true;
+  if ( dict.count( "pace" ) )
+    _pace = boost::lexical_cast< int >( dict["pace"] ) != 0;
+
+  _packets.resize( _batch * _packet_len );
+  _lengths.resize( _batch );
+#ifdef __linux__
+  _msgs.resize( _batch );
+  _iovs.resize( _batch );
+#endif
+
+  _context_due = true;
+  _changed = false;
+  _next_context = 0;
+  _count = _context_count = 0;
+  _have_base = false;
+  _base_pos = 0;
+  _base_secs = 0;
+  _base_frac = 0;
+  _base_rate = _rate;
+  _paced = false;
+  _pace_pos = 0;
+
+  _socket = vrt_open_tx_socket( host, port, sndbuf );
+
+  /* every work() call sends whole packets */
+  set_output_multiple( _spp );
+}
+
+vrt_sink_c::~vrt_sink_c()
+{
+  vrt_close_socket( _socket );
+#if defined(_WIN32)
+  WSACleanup();
+#endif
+}
+
+bool vrt_sink_c::start()
+{
+  std::lock_guard< std::mutex > lock( _mutex );
+
+  _context_due = true;
+  _have_base = false;
+  _paced = false;
+
+  return true;
+}
+
+bool vrt_sink_c::stop()
+{
+  if ( _nfailed )
+    std::cerr << "VRT Sink: sending " << _nfailed << " packets failed" << std::endl;
+
+  return true;
+}
+
+void vrt_sink_c::time_of( uint64_t pos, uint32_t &secs, uint64_t &ps )
+{
+  double frac = _base_frac + double( int64_t( pos - _base_pos ) ) / _base_rate;
+  double whole = std::floor( frac );
+
+  secs = uint32_t( _base_secs + time_t( whole ) );
+  ps = uint64_t( std::llround( ( frac - whole ) * 1e12 ) );
+
+  if ( ps >= 1000000000000ULL ) {
+    ps -= 1000000000000ULL;
+    secs++;
+  }
+}
+
+void vrt_sink_c::send_batch( size_t npackets, uint64_t pos )
+{
+  if ( _pace ) {
+    std::chrono::duration< double > ahead( double( pos - _pace_pos ) / _base_rate );
+    std::this_thread::sleep_until( _pace_start +
+      std::chrono::duration_cast< std::chrono::steady_clock::duration >( ahead ) );
+  }
+
+#ifdef __linux__
+  for ( size_t i = 0; i < npackets; i++ ) {
+    _iovs[i].iov_base = &_packets[ i * _packet_len ];
+    _iovs[i].iov_len = _lengths[i];
+    memset( &_msgs[i], 0, sizeof(_msgs[i]) );
+    _msgs[i].msg_hdr.msg_iov = &_iovs[i];
+    _msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  size_t sent = 0;
+  while ( sent < npackets ) {
+    int ret = sendmmsg( _socket, &_msgs[ sent ], (unsigned int)( npackets - sent ), 0 );
+    if ( ret < 0 && errno == EINTR )
+      continue;
+
+    /* ECONNREFUSED while nobody listens, the rest of the batch is lost */
+    if ( ret <= 0 ) {
+      _nfailed += npackets - sent;
+      break;
+    }
+
+    sent += ret;
+  }
+#else
+  for ( size_t i = 0; i < npackets; i++ )
+    if ( ::send( _socket, (const char *)&_packets[ i * _packet_len ], (int)_lengths[i], 0 ) < 0 )
+      _nfailed++;
+#endif
+}
+
+int vrt_sink_c::work( int noutput_items,
+                      gr_vector_const_void_star &input_items,
+                      gr_vector_void_star &output_items )
+{
+  const uint8_t *in = (const uint8_t *)input_items[0];
+  const size_t npackets = noutput_items / _spp;
+  const uint64_t start = nitems_read(0);
+
+  double freq, gain, rate;
+  bool context_due, changed;
+
+  {
+    std::lock_guard< std::mutex > lock( _mutex );
+
+    freq = _freq;
+    gain = _gain;
+    rate = _rate;
+    context_due = _context_due;
+    changed = _changed;
+    _context_due = _changed = false;
+
+    if ( !_have_base ) {
+      std::chrono::nanoseconds now = std::chrono::duration_cast< std::chrono::nanoseconds >(
+            std::chrono::system_clock::now().time_since_epoch() );
+      _base_secs = time_t( now.count() / 1000000000LL );
+      _base_frac = ( now.count() % 1000000000LL ) / 1e9;
+      _base_pos = start;
+      _base_rate = rate;
+      _have_base = true;
+    }
+
+    if ( _pace && !_paced ) {
+      _pace_start = std::chrono::steady_clock::now();
+      _pace_pos = start;
+      _paced = true;
+    }
+  }
+
+  /* a new rate continues the timeline and the pacing from here */
+  if ( rate != _base_rate ) {
+    uint32_t secs;
+    uint64_t ps;
+    time_of( start, secs, ps );
+
+    _base_secs = secs;
+    _base_frac = ps / 1e12;
+    _base_pos = start;
+    _base_rate = rate;
+    _pace_start = std::chrono::steady_clock::now();
+    _pace_pos = start;
+  }
+
+  std::vector< gr::tag_t > tags;
+  get_tags_in_range( tags, 0, start, start + npackets * _spp, TX_TIME_KEY );
+  size_t tag = 0;
+
+  size_t n = 0;
+  uint64_t batch_pos = start;
+
+  for ( size_t p = 0; p < npackets; p++ ) {
+    uint64_t pos = start + p * _spp;
+    uint32_t secs;
+    uint64_t ps;
+
+    /* a tx_time inside the packet moves the timeline, the packet's start too */
+    while ( tag < tags.size() && tags[tag].offset < pos + _spp ) {
+      const pmt::pmt_t &value = tags[tag].value;
+      if ( pmt::is_tuple( value ) ) {
+        _base_secs = time_t( pmt::to_uint64( pmt::tuple_ref( value, 0 ) ) );
+        _base_frac = pmt::to_double( pmt::tuple_ref( value, 1 ) );
+        _base_pos = tags[tag].offset;
+      }
+      tag++;
+    }
+
+    time_of( pos, secs, ps );
+
+    bool send_context = context_due || ( _context_period > 0 && pos >= _next_context );
+
+    if ( n + ( send_context ? 2 : 1 ) > _batch ) {
+      send_batch( n, batch_pos );
+      n = 0;
+      batch_pos = pos;
+    }
+
+    if ( send_context ) {
+      _lengths[n] = vrt_write_context( &_packets[ n * _packet_len ], _context_count++,
+                                       _context_sid, secs, ps, changed, freq, gain, rate );
+      n++;
+      _ncontext++;
+
+      context_due = changed = false;
+      _next_context = pos + uint64_t( _context_period * rate );
+    }
+
+    uint8_t *packet = &_packets[ n * _packet_len ];
+    size_t payload_len = _spp * _sample_size;
+    size_t header_len = vrt_write_data_header( packet, _count++, _sid, secs, ps, payload_len );
+
+    vrt_items_to_payload( in + p * _spp * _item_size, _item_size, _spp,
+                          _format, packet + header_len );
+
+    _lengths[n] = header_len + payload_len;
+    n++;
+    _npackets++;
+  }
+
+  if ( n )
+    send_batch( n, batch_pos );
+
+  return npackets * _spp;
+}
+
+std::string vrt_sink_c::name()
+{
+  return "VRT Sink";
+}
+
+std::vector<std::string> vrt_sink_c::get_devices( bool fake )
+{
+  std::vector<std::string> devices;
+
+  if ( fake )
+  {
+    std::string args = "vrt=127.0.0.1:4991";
+    args += ",label='VITA 49 Transmitter'";
+    devices.push_back( args );
+  }
+
+  return devices;
+}
+
+size_t vrt_sink_c::get_num_channels( void )
+{
+  return 1;
+}
+
+std::map<std::string, double> vrt_sink_c::get_stats( size_t chan )
+{
+  std::map<std::string, double> stats;
+
+  stats["packets"] = double( _npackets );
+  stats["context_packets"] = double( _ncontext );
+  stats["packets_failed"] = double( _nfailed );
+
+  return stats;
+}
+
+osmosdr::meta_range_t vrt_sink_c::get_sample_rates( void )
+{
+  return osmosdr::meta_range_t( 1.0, 10e9 );
+}
+
+double vrt_sink_c::set_sample_rate( double rate )
+{
+  std::lock_guard< std::mutex > lock( _mutex );
+
+  if ( rate > 0 && rate != _rate ) {
+    _rate = rate;
+    _context_due = _changed = true;
+  }
+
+  return _rate;
+}
+
+double vrt_sink_c::get_sample_rate( void )
+{
+  std::lock_guard< std::mutex > lock( _mutex );
+
+  return _rate;
+}
+
+osmosdr::freq_range_t vrt_sink_c::get_freq_range( size_t chan )
+{
+  return osmosdr::freq_range_t( 0, 100e9 );
+}
+
+double vrt_sink_c::set_center_freq( double freq, size_t chan )
+{
+  std::lock_guard< std::mutex > lock( _mutex );
+
+  if ( freq != _freq ) {
+    _freq = freq;
+    _context_due = _changed = true;
+  }
+
+  return _freq;
+}
+
+double vrt_sink_c::get_center_freq( size_t chan )
+{
+  std::lock_guard< std::mutex > lock( _mutex );
+
+  return _freq;
+}
+
+double vrt_sink_c::set_freq_corr( double ppm, size_t chan )
+{
+  _corr = ppm;
+
+  return get_freq_corr( chan );
+}
+
+double vrt_sink_c::get_freq_corr( size_t chan )
+{
+  return _corr;
+}
+
+std::vector<std::string> vrt_sink_c::get_gain_names( size_t chan )
+{
+  std::vector< std::string > names;
+
+  names.push_back( "RF" );
+
+  return names;
+}
+
+osmosdr::gain_range_t vrt_sink_c::get_gain_range( size_t chan )
+{
+  /* what the context packet can carry */
+  return osmosdr::gain_range_t( -256.0, 32767.0 / 128.0, 1.0 / 128.0 );
+}
+
+osmosdr::gain_range_t vrt_sink_c::get_gain_range( const std::string & name, size_t chan )
+{
+  return get_gain_range( chan );
+}
+
+double vrt_sink_c::set_gain( double gain, size_t chan )
+{
+  osmosdr::gain_range_t range = get_gain_range( chan );
+  gain = std::max( range.start(), std::min( gain, range.stop() ) );
+
+  std::lock_guard< std::mutex > lock( _mutex );
+
+  if ( gain != _gain ) {
+    _gain = gain;
+    _context_due = _changed = true;
+  }
+
+  return _gain;
+}
+
+double vrt_sink_c::set_gain( double gain, const std::string & name, size_t chan )
+{
+  return set_gain( gain, chan );
+}
+
+double vrt_sink_c::get_gain( size_t chan )
+{
+  std::lock_guard< std::mutex > lock( _mutex );
+
+  return _gain;
+}
+
+double vrt_sink_c::get_gain( const std::string & name, size_t chan )
+{
+  return get_gain( chan );
+}
+
+std::vector< std::string > vrt_sink_c::get_antennas( size_t chan )
+{
+  return std::vector< std::string >();
+}
+
+std::string vrt_sink_c::set_antenna( const std::string & antenna, size_t chan )
+{
+  return get_antenna( chan );
+}
+
+std::string vrt_sink_c::get_antenna( size_t chan )
+{
+  return "TX";
+}
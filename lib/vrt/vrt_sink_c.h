@@ -0,0 +1,150 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef VRT_SINK_C_H
+#define VRT_SINK_C_H
+
+#include <gnuradio/sync_block.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include "sink_iface.h"
+#include "direct_block.h"
+
+#include "vrt_common.h"
+
+class vrt_sink_c;
+
+typedef std::shared_ptr< vrt_sink_c > vrt_sink_c_sptr;
+
+vrt_sink_c_sptr make_vrt_sink_c( const std::string & args = "" );
+
+/*
+ * Sends the samples as VITA 49 IF data packets over UDP, with stream id,
+ * packet count and UTC timestamps in picoseconds, and a context packet
+ * with frequency, gain and rate at the start, after changes and every
+ * context_period seconds.
+ *
+ * Timestamps follow the host clock from the first sample on, or the last
+ * tx_time tag. Packets go out no faster than the sample rate unless pace=0
+ * is given, which makes this a packet generator for the vrt source too.
+ */
+class vrt_sink_c :
+    public direct_block,
+    public sink_iface
+{
+private:
+  friend vrt_sink_c_sptr make_vrt_sink_c(const std::string &args);
+
+  vrt_sink_c(const std::string &args);
+
+public:
+  ~vrt_sink_c();
+
+  bool start();
+  bool stop();
+
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+  std::string name();
+
+  static std::vector< std::string > get_devices( bool fake = false );
+
+  size_t get_num_channels( void );
+
+  std::map< std::string, double > get_stats( size_t chan = 0 );
+
+  osmosdr::meta_range_t get_sample_rates( void );
+  double set_sample_rate( double rate );
+  double get_sample_rate( void );
+
+  osmosdr::freq_range_t get_freq_range( size_t chan = 0 );
+  double set_center_freq( double freq, size_t chan = 0 );
+  double get_center_freq( size_t chan = 0 );
+  double set_freq_corr( double ppm, size_t chan = 0 );
+  double get_freq_corr( size_t chan = 0 );
+
+  std::vector<std::string> get_gain_names( size_t chan = 0 );
+  osmosdr::gain_range_t get_gain_range( size_t chan = 0 );
+  osmosdr::gain_range_t get_gain_range( const std::string & name, size_t chan = 0 );
+  double set_gain( double gain, size_t chan = 0 );
+  double set_gain( double gain, const std::string & name, size_t chan = 0 );
+  double get_gain( size_t chan = 0 );
+  double get_gain( const std::string & name, size_t chan = 0 );
+
+  std::vector< std::string > get_antennas( size_t chan = 0 );
+  std::string set_antenna( const std::string & antenna, size_t chan = 0 );
+  std::string get_antenna( size_t chan = 0 );
+
+private:
+  /* the timestamp of the sample at pos, in UTC seconds and picoseconds */
+  void time_of( uint64_t pos, uint32_t &secs, uint64_t &ps );
+  void send_batch( size_t npackets, uint64_t pos );
+
+  size_t _item_size;
+  vrt_format _format;
+  size_t _sample_size;
+
+  uint32_t _sid;
+  uint32_t _context_sid;
+  size_t _spp;                /* samples per data packet */
+  size_t _packet_len;         /* bytes reserved per packet */
+
+  SOCKET _socket;
+  size_t _batch;              /* packets sent per system call at most */
+  std::vector< uint8_t > _packets;
+  std::vector< size_t > _lengths;
+#ifdef __linux__
+  std::vector< struct mmsghdr > _msgs;
+  std::vector< struct iovec > _iovs;
+#endif
+
+  std::mutex _mutex;          /* the settings below, against work() */
+  double _freq, _rate, _gain, _corr;
+  bool _context_due;
+  bool _changed;
+
+  double _context_period;
+  uint64_t _next_context;
+  unsigned int _count;
+  unsigned int _context_count;
+
+  /* timeline: the sample at _base_pos was due at _base_secs + _base_frac */
+  bool _have_base;
+  uint64_t _base_pos;
+  time_t _base_secs;
+  double _base_frac;
+  double _base_rate;
+
+  bool _pace;
+  bool _paced;
+  std::chrono::steady_clock::time_point _pace_start;
+  uint64_t _pace_pos;
+
+  std::atomic< uint64_t > _npackets{0};
+  std::atomic< uint64_t > _ncontext{0};
+  std::atomic< uint64_t > _nfailed{0};
+};
+
+#endif // VRT_SINK_C_H
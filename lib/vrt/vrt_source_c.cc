@@ -0,0 +1,613 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include <gnuradio/io_signature.h>
+
+#include "arg_helpers.h"
+#include "pool_helpers.h"
+#include "time_helpers.h"
+
+#include "vrt_source_c.h"
+
+/* samples in the ring by default */
+#define VRT_BUF_LEN ( 2 * 1024 * 1024 )
+
+/* packets taken per system call by default */
+#define VRT_BATCH 32
+
+static const pmt::pmt_t RX_FREQ_KEY = pmt::string_to_symbol("rx_freq");
+static const pmt::pmt_t RX_RATE_KEY = pmt::string_to_symbol("rx_rate");
+static const pmt::pmt_t RX_DROPPED_KEY = pmt::string_to_symbol("rx_dropped");
+static const pmt::pmt_t RX_TIME_KEY = pmt::string_to_symbol("rx_time");
+
+vrt_source_c_sptr make_vrt_source_c(const std::string &args)
+{
+  return gnuradio::get_initial_sptr(new vrt_source_c(args));
+}
+
+vrt_source_c::vrt_source_c(const std::string &args) :
+  direct_block("vrt_source_c",
+               gr::io_signature::make(0, 0, 0),
+               gr::io_signature::make(1, 1, sizeof(gr_complex)))
+{
+  std::string host, iface;
+  unsigned short port;
+  int rcvbuf = 32 * 1024 * 1024;
+
+#if defined(_WIN32)
+  WSADATA wsaData;
+  WSAStartup( MAKEWORD(2, 2), &wsaData );
+#endif
+
+  dict_t dict = params_to_dict( args );
+
+  vrt_parse_address( dict["vrt"], "0.0.0.0", host, port );
+
+  _format = vrt_parse_format( dict.count( "format" ) ? dict["format"] : "" );
+  _sample_size = vrt_format_size( _format );
+
+  _have_sid = dict.count( "stream_id" ) != 0;
+  _sid = _have_sid ? uint32_t( std::stoul( dict["stream_id"], NULL, 0 ) ) : 0;
+  _have_context_sid = dict.count( "context_id" ) != 0;
+  _context_sid = _have_context_sid ? uint32_t( std::stoul( dict["context_id"], NULL, 0 ) ) : 0;
+
+  _freq = dict.count( "freq" ) ? boost::lexical_cast< double >( dict["freq"] ) : 0;
+  _rate = dict.count( "rate" ) ? boost::lexical_cast< double >( dict["rate"] ) : 1e6;
+  _gain = _bandwidth = _corr = 0;
+  _context_freq = _context_rate = false;
+
+  _batch = VRT_BATCH;
+  if ( dict.count( "batch" ) )
+    _batch = std::max( boost::lexical_cast< size_t >( dict["batch"] ), size_t(1) );
+
+  _buf_len = VRT_BUF_LEN;
+  if ( dict.count( "buflen" ) )
+    _buf_len = std::max( boost::lexical_cast< size_t >( dict["buflen"] ),
+                         size_t( VRT_MAX_PACKET ) );
+
+  if ( dict.count( "rcvbuf" ) )
+    rcvbuf = boost::lexical_cast< int >( dict["rcvbuf"] );
+
+  if ( dict.count( "iface" ) )
+    iface = dict["iface"];
+
+  _timeout_ms = 100;
+  if ( dict.count( "timeout" ) )
+    _timeout_ms = boost::lexical_cast< int >( dict["timeout"] );
+
+  _time_period = 1.0;
+  if ( dict.count( "time_period" ) )
+    _time_period = boost::lexical_cast< double >( dict["time_period"] );
+
+  _sched.set( dict );
+
+  _buf = (gr_complex *)buffer_pool::get().alloc( _buf_len * sizeof(gr_complex),
+                                                 args_to_numa_node( dict ) );
+  if ( !_buf )
+    throw std::runtime_error( "Could not allocate the sample ring." );
+
+  _packets.resize( _batch * VRT_MAX_PACKET );
+
+  _buf_head = _buf_used = 0;
+  _buf_in = 0;
+  _running = false;
+  _failed = false;
+
+  _have_count = false;
+  _next_count = 0;
+  _tagged = false;
+  _next_time_pos = 0;
+  _freq_due = _rate_due = false;
+  _pending_drop = 0;
+
+  try {
+    _socket = vrt_open_rx_socket( host, port, iface, rcvbuf );
+  } catch ( ... ) {
+    buffer_pool::get().release( _buf );
+    throw;
+  }
+
+  std::cerr << "Receiving VRT " << host << ":" << port;
+  if ( _have_sid )
+    std::cerr << " stream 0x" << std::hex << _sid << std::dec;
+  std::cerr << std::endl;
+}
+
+vrt_source_c::~vrt_source_c()
+{
+  if ( _thread.joinable() )
+    stop();
+
+  vrt_close_socket( _socket );
+#if defined(_WIN32)
+  WSACleanup();
+#endif
+
+  buffer_pool::get().release( _buf );
+}
+
+bool vrt_source_c::start()
+{
+  {
+    std::lock_guard< std::mutex > lock( _buf_mutex );
+
+    /* the ring position of a sample equals its output position */
+    _buf_in = nitems_written(0) + _buf_used;
+    _have_count = false;
+    _tagged = false;
+    _freq_due = _rate_due = true;
+    _failed = false;
+    _running = true;
+  }
+
+  _thread = std::thread( &vrt_source_c::rx_loop, this );
+
+  return true;
+}
+
+bool vrt_source_c::stop()
+{
+  {
+    std::lock_guard< std::mutex > lock( _buf_mutex );
+    _running = false;
+  }
+  _buf_cond.notify_all();
+
+  if ( _thread.joinable() )
+    _thread.join();
+
+  if ( _nlost || _overflows )
+    std::cerr << "VRT Source: " << _nlost << " packets lost, "
+              << _overflows << " dropped for a full ring" << std::endl;
+
+  return true;
+}
+
+void vrt_source_c::rx_loop()
+{
+  _sched.apply( "vrt rx thread" );
+
+#ifdef __linux__
+  std::vector< struct mmsghdr > msgs( _batch );
+  std::vector< struct iovec > iovs( _batch );
+
+  for ( size_t i = 0; i < _batch; i++ ) {
+    iovs[i].iov_base = &_packets[ i * VRT_MAX_PACKET ];
+    iovs[i].iov_len = VRT_MAX_PACKET;
+    memset( &msgs[i], 0, sizeof(msgs[i]) );
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+#endif
+
+  while ( true )
+  {
+    {
+      std::lock_guard< std::mutex > lock( _buf_mutex );
+      if ( !_running )
+        break;
+    }
+
+    if ( !vrt_wait_socket( _socket, 100 ) )
+      continue;
+
+#ifdef __linux__
+    /* whatever has queued up since, in one call */
+    int count = recvmmsg( _socket, &msgs[0], (unsigned int)_batch, MSG_DONTWAIT, NULL );
+    if ( count < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ) )
+      continue;
+#else
+    int size = ::recv( _socket, (char *)&_packets[0], VRT_MAX_PACKET, 0 );
+    int count = size < 0 ? -1 : 1;
+#endif
+
+    if ( count < 0 )
+    {
+      std::cerr << "VRT Source: receiving failed (" << strerror( errno ) << ")" << std::endl;
+      std::lock_guard< std::mutex > lock( _buf_mutex );
+      _failed = true;
+      _buf_cond.notify_all();
+      break;
+    }
+
+    uint64_t now = _stats.arrival();
+
+    for ( int i = 0; i < count; i++ ) {
+#ifdef __linux__
+      size_t len = msgs[i].msg_len;
+#else
+      size_t len = size;
+#endif
+      handle_packet( &_packets[ i * VRT_MAX_PACKET ], len, now );
+    }
+
+    _buf_cond.notify_one();
+  }
+}
+
+void vrt_source_c::handle_context( const vrt_packet &pkt )
+{
+  uint32_t sid = _have_context_sid ? _context_sid : _sid;
+  vrt_context ctx;
+
+  if ( !_have_context_sid && !_have_sid ) {
+    _nignored++; /* unknown which stream it describes as yet */
+    return;
+  }
+
+  if ( pkt.sid != sid ) {
+    _nignored++;
+    return;
+  }
+
+  if ( !vrt_parse_context( pkt, ctx ) ) {
+    _ninvalid++;
+    return;
+  }
+
+  _ncontext++;
+
+  std::lock_guard< std::mutex > lock( _buf_mutex );
+
+  if ( ctx.has_freq && ( !_context_freq || ctx.freq != _freq ) ) {
+    _freq = ctx.freq;
+    _context_freq = _freq_due = true;
+  }
+
+  if ( ctx.has_rate && ctx.rate > 0 && ( !_context_rate || ctx.rate != _rate ) ) {
+    _rate = ctx.rate;
+    _context_rate = _rate_due = true;
+    _tagged = false; /* the time tags of the new rate start over */
+  }
+
+  if ( ctx.has_gain )
+    _gain = ctx.gain;
+
+  if ( ctx.has_bandwidth )
+    _bandwidth = ctx.bandwidth;
+}
+
+void vrt_source_c::handle_packet( uint8_t *buf, size_t len, uint64_t now )
+{
+  vrt_packet pkt;
+
+  if ( !vrt_parse( buf, len, pkt ) ) {
+    _ninvalid++;
+    return;
+  }
+
+  if ( VRT_TYPE_CONTEXT == pkt.type ) {
+    handle_context( pkt );
+    return;
+  }
+
+  if ( pkt.type != VRT_TYPE_DATA && pkt.type != VRT_TYPE_DATA_SID ) {
+    _nignored++;
+    return;
+  }
+
+  /* without a stream_id= the first stream seen is taken */
+  if ( !_have_sid && pkt.has_sid ) {
+    _sid = pkt.sid;
+    _have_sid = true;
+    std::cerr << "VRT Source: taking stream 0x" << std::hex << _sid << std::dec << std::endl;
+  }
+
+  if ( pkt.has_sid != _have_sid || pkt.sid != _sid ) {
+    _nignored++;
+    return;
+  }
+
+  _npackets++;
+
+  /* the 4 bit count wraps, more than 15 lost in a row look like fewer */
+  unsigned int lost = _have_count ? ( pkt.count - _next_count ) & 0xf : 0;
+  _next_count = ( pkt.count + 1 ) & 0xf;
+  _have_count = true;
+  _nlost += lost;
+
+  size_t nsamples = pkt.payload_len / _sample_size;
+  size_t tail;
+
+  {
+    std::lock_guard< std::mutex > lock( _buf_mutex );
+
+    if ( _buf_len - _buf_used < nsamples ) {
+      _overflows++;
+      _pending_drop += ( lost + 1 ) * nsamples;
+      std::cerr << "O" << std::flush;
+      return;
+    }
+
+    tail = ( _buf_head + _buf_used ) % _buf_len;
+  }
+
+  /* the region past _buf_used is owned by this thread until published */
+  size_t first = std::min( nsamples, _buf_len - tail );
+  vrt_payload_to_32fc( pkt.payload, first, _format, (float *)( _buf + tail ) );
+  vrt_payload_to_32fc( pkt.payload + first * _sample_size, nsamples - first,
+                       _format, (float *)_buf );
+
+  std::lock_guard< std::mutex > lock( _buf_mutex );
+
+  stream_mark mark;
+  mark.pos = _buf_in;
+  mark.dropped = lost * nsamples + _pending_drop;
+  mark.has_freq = _freq_due;
+  mark.freq = _freq;
+  mark.has_rate = _rate_due;
+  mark.rate = _rate;
+  mark.has_time = false;
+
+  bool time_due = !_tagged || mark.dropped ||
+                  ( _time_period > 0 && _buf_in >= _next_time_pos );
+
+  if ( time_due && pkt.tsi != VRT_TSI_NONE ) {
+    double frac = 0;
+    if ( VRT_TSF_PICOSECONDS == pkt.tsf )
+      frac = pkt.frac / 1e12;
+    else if ( VRT_TSF_SAMPLES == pkt.tsf )
+      frac = double( pkt.frac ) / _rate;
+
+    mark.has_time = true;
+    mark.time = osmosdr::time_spec_t( time_t( pkt.secs ), frac );
+
+    _tagged = true;
+    _next_time_pos = _buf_in + uint64_t( _time_period * _rate );
+  }
+
+  if ( mark.has_time || mark.has_freq || mark.has_rate || mark.dropped )
+    _marks.push_back( mark );
+
+  _freq_due = _rate_due = false;
+  _pending_drop = 0;
+
+  _buf_used += nsamples;
+  _buf_in += nsamples;
+
+  _arrivals.queued( nsamples, now );
+  _stats.fill( _buf_used, _buf_len );
+}
+
+int vrt_source_c::work( int noutput_items,
+                        gr_vector_const_void_star &input_items,
+                        gr_vector_void_star &output_items )
+{
+  gr_complex *out = (gr_complex *)output_items[0];
+
+  std::unique_lock< std::mutex > lock( _buf_mutex );
+
+  if ( !_buf_cond.wait_for( lock, std::chrono::milliseconds( _timeout_ms ),
+                            [this] { return _failed || _buf_used > 0; } ) )
+    return 0;
+
+  if ( !_buf_used )
+    throw std::runtime_error( "Receiving samples failed." );
+
+  size_t items = std::min( _buf_used, (size_t)noutput_items );
+  size_t first = std::min( items, _buf_len - _buf_head );
+
+  memcpy( out, _buf + _buf_head, first * sizeof(gr_complex) );
+  memcpy( out + first, _buf, ( items - first ) * sizeof(gr_complex) );
+
+  _buf_head = ( _buf_head + items ) % _buf_len;
+  _buf_used -= items;
+
+  _arrivals.taken( items, _stats );
+  _stats.fill( _buf_used, _buf_len );
+
+  uint64_t start = nitems_written(0);
+
+  while ( !_marks.empty() && _marks.front().pos < start + items ) {
+    const stream_mark &mark = _marks.front();
+    uint64_t offset = std::max( mark.pos, start );
+
+    if ( mark.has_time )
+      add_item_tag(0, offset, RX_TIME_KEY, time_to_pmt(mark.time));
+    if ( mark.has_freq )
+      add_item_tag(0, offset, RX_FREQ_KEY, pmt::from_double(mark.freq));
+    if ( mark.has_rate )
+      add_item_tag(0, offset, RX_RATE_KEY, pmt::from_double(mark.rate));
+    if ( mark.dropped )
+      add_item_tag(0, offset, RX_DROPPED_KEY, pmt::from_uint64(mark.dropped));
+
+    _marks.pop_front();
+  }
+
+  return items;
+}
+
+std::string vrt_source_c::name()
+{
+  return "VRT Source";
+}
+
+std::vector<std::string> vrt_source_c::get_devices( bool fake )
+{
+  std::vector<std::string> devices;
+
+  if ( fake )
+  {
+    std::string args = "vrt=0.0.0.0:4991";
+    args += ",label='VITA 49 Receiver'";
+    devices.push_back( args );
+  }
+
+  return devices;
+}
+
+size_t vrt_source_c::get_num_channels( void )
+{
+  return 1;
+}
+
+uint64_t vrt_source_c::get_overflows( void )
+{
+  return _nlost + _overflows;
+}
+
+std::map<std::string, double> vrt_source_c::get_stats( size_t chan )
+{
+  std::map<std::string, double> stats;
+  _stats.report( stats );
+  _sched.report( stats );
+
+  stats["packets"] = double( _npackets );
+  stats["packets_lost"] = double( _nlost );
+  stats["packets_invalid"] = double( _ninvalid );
+  stats["packets_ignored"] = double( _nignored );
+  stats["context_packets"] = double( _ncontext );
+  stats["ring_overflows"] = double( _overflows );
+
+  return stats;
+}
+
+osmosdr::meta_range_t vrt_source_c::get_sample_rates( void )
+{
+  return osmosdr::meta_range_t( get_sample_rate(), get_sample_rate() );
+}
+
+double vrt_source_c::set_sample_rate( double rate )
+{
+  std::lock_guard< std::mutex > lock( _buf_mutex );
+
+  if ( !_context_rate && rate > 0 )
+    _rate = rate;
+
+  return _rate;
+}
+
+double vrt_source_c::get_sample_rate( void )
+{
+  std::lock_guard< std::mutex > lock( _buf_mutex );
+
+  return _rate;
+}
+
+osmosdr::freq_range_t vrt_source_c::get_freq_range( size_t chan )
+{
+  std::lock_guard< std::mutex > lock( _buf_mutex );
+
+  if ( _context_freq )
+    return osmosdr::freq_range_t( _freq, _freq );
+
+  return osmosdr::freq_range_t( 0, 100e9 );
+}
+
+double vrt_source_c::set_center_freq( double freq, size_t chan )
+{
+  std::lock_guard< std::mutex > lock( _buf_mutex );
+
+  if ( !_context_freq )
+    _freq = freq;
+
+  return _freq;
+}
+
+double vrt_source_c::get_center_freq( size_t chan )
+{
+  std::lock_guard< std::mutex > lock( _buf_mutex );
+
+  return _freq;
+}
+
+double vrt_source_c::set_freq_corr( double ppm, size_t chan )
+{
+  _corr = ppm;
+
+  return get_freq_corr( chan );
+}
+
+double vrt_source_c::get_freq_corr( size_t chan )
+{
+  return _corr;
+}
+
+std::vector<std::string> vrt_source_c::get_gain_names( size_t chan )
+{
+  return std::vector< std::string >();
+}
+
+osmosdr::gain_range_t vrt_source_c::get_gain_range( size_t chan )
+{
+  return osmosdr::gain_range_t();
+}
+
+osmosdr::gain_range_t vrt_source_c::get_gain_range( const std::string & name, size_t chan )
+{
+  return get_gain_range( chan );
+}
+
+double vrt_source_c::set_gain( double gain, size_t chan )
+{
+  return get_gain( chan );
+}
+
+double vrt_source_c::set_gain( double gain, const std::string & name, size_t chan )
+{
+  return set_gain( gain, chan );
+}
+
+double vrt_source_c::get_gain( size_t chan )
+{
+  std::lock_guard< std::mutex > lock( _buf_mutex );
+
+  return _gain;
+}
+
+double vrt_source_c::get_gain( const std::string & name, size_t chan )
+{
+  return get_gain( chan );
+}
+
+std::vector< std::string > vrt_source_c::get_antennas( size_t chan )
+{
+  return std::vector< std::string >();
+}
+
+std::string vrt_source_c::set_antenna( const std::string & antenna, size_t chan )
+{
+  return get_antenna( chan );
+}
+
+std::string vrt_source_c::get_antenna( size_t chan )
+{
+  return "RX";
+}
+
+double vrt_source_c::set_bandwidth( double bandwidth, size_t chan )
+{
+  return get_bandwidth( chan );
+}
+
+double vrt_source_c::get_bandwidth( size_t chan )
+{
+  std::lock_guard< std::mutex > lock( _buf_mutex );
+
+  return _bandwidth;
+}
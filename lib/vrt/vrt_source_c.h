@@ -0,0 +1,182 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef VRT_SOURCE_C_H
+#define VRT_SOURCE_C_H
+
+#include <gnuradio/sync_block.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "source_iface.h"
+#include "direct_block.h"
+#include "stats_helpers.h"
+#include "sched_helpers.h"
+
+#include "vrt_common.h"
+
+class vrt_source_c;
+
+typedef std::shared_ptr< vrt_source_c > vrt_source_c_sptr;
+
+vrt_source_c_sptr make_vrt_source_c( const std::string & args = "" );
+
+/*
+ * Receives VITA 49 IF data packets over UDP, from one stream id.
+ *
+ * A thread takes the packets in batches, checks their packet counts for
+ * gaps and converts the payloads into a ring of complex float that work()
+ * copies from. Context packets of the stream update frequency, rate, gain
+ * and bandwidth. The first sample, those following lost packets or a
+ * change and one every time_period seconds get rx_time tags from the
+ * timestamps of the packets, changes get rx_freq and rx_rate tags.
+ *
+ * The digitizer is not controlled from here, the setters only take effect
+ * until its first context packet tells otherwise.
+ */
+class vrt_source_c :
+    public direct_block,
+    public source_iface
+{
+private:
+  friend vrt_source_c_sptr make_vrt_source_c(const std::string &args);
+
+  vrt_source_c(const std::string &args);
+
+public:
+  ~vrt_source_c();
+
+  bool start();
+  bool stop();
+
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+  std::string name();
+
+  static std::vector< std::string > get_devices( bool fake = false );
+
+  size_t get_num_channels( void );
+
+  uint64_t get_overflows( void );
+  std::map< std::string, double > get_stats( size_t chan = 0 );
+
+  osmosdr::meta_range_t get_sample_rates( void );
+  double set_sample_rate( double rate );
+  double get_sample_rate( void );
+
+  osmosdr::freq_range_t get_freq_range( size_t chan = 0 );
+  double set_center_freq( double freq, size_t chan = 0 );
+  double get_center_freq( size_t chan = 0 );
+  double set_freq_corr( double ppm, size_t chan = 0 );
+  double get_freq_corr( size_t chan = 0 );
+
+  std::vector<std::string> get_gain_names( size_t chan = 0 );
+  osmosdr::gain_range_t get_gain_range( size_t chan = 0 );
+  osmosdr::gain_range_t get_gain_range( const std::string & name, size_t chan = 0 );
+  double set_gain( double gain, size_t chan = 0 );
+  double set_gain( double gain, const std::string & name, size_t chan = 0 );
+  double get_gain( size_t chan = 0 );
+  double get_gain( const std::string & name, size_t chan = 0 );
+
+  std::vector< std::string > get_antennas( size_t chan = 0 );
+  std::string set_antenna( const std::string & antenna, size_t chan = 0 );
+  std::string get_antenna( size_t chan = 0 );
+
+  double set_bandwidth( double bandwidth, size_t chan = 0 );
+  double get_bandwidth( size_t chan = 0 );
+
+private:
+  /* tags due at a position of the stream */
+  struct stream_mark
+  {
+    uint64_t pos;
+    bool has_time;
+    osmosdr::time_spec_t time;
+    bool has_freq;
+    double freq;
+    bool has_rate;
+    double rate;
+    uint64_t dropped;
+  };
+
+  void rx_loop();
+  void handle_packet( uint8_t *buf, size_t len, uint64_t now );
+  void handle_context( const vrt_packet &pkt );
+
+  vrt_format _format;
+  size_t _sample_size;
+
+  bool _have_sid;             /* data packets are taken from this stream */
+  uint32_t _sid;
+  bool _have_context_sid;     /* context packets from this one, _sid if not */
+  uint32_t _context_sid;
+
+  SOCKET _socket;
+  size_t _batch;              /* packets taken per system call at most */
+  std::vector< uint8_t > _packets;
+
+  std::thread _thread;
+  std::mutex _buf_mutex;
+  std::condition_variable _buf_cond;
+
+  /* sample ring between the socket thread and work() */
+  gr_complex *_buf;
+  size_t _buf_len;
+  size_t _buf_head;
+  size_t _buf_used;
+  uint64_t _buf_in;           /* stream position of the next sample queued */
+
+  bool _running;
+  bool _failed;
+  int _timeout_ms;
+
+  double _freq, _rate, _gain, _bandwidth, _corr;
+  bool _context_freq, _context_rate;
+
+  /* tagging state of the socket thread, under _buf_mutex */
+  std::deque< stream_mark > _marks;
+  bool _have_count;
+  unsigned int _next_count;
+  bool _tagged;
+  uint64_t _next_time_pos;
+  double _time_period;
+  bool _freq_due, _rate_due;
+  uint64_t _pending_drop;
+
+  std::atomic< uint64_t > _npackets{0};
+  std::atomic< uint64_t > _nlost{0};
+  std::atomic< uint64_t > _ninvalid{0};
+  std::atomic< uint64_t > _nignored{0};
+  std::atomic< uint64_t > _ncontext{0};
+  std::atomic< uint64_t > _overflows{0};
+
+  fifo_arrivals _arrivals;
+  stream_stats _stats;
+
+  io_sched _sched;
+};
+
+#endif // VRT_SOURCE_C_H
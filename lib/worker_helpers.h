@@ -0,0 +1,247 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef OSMOSDR_WORKER_HELPERS_H
+#define OSMOSDR_WORKER_HELPERS_H
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arg_helpers.h"
+
+/* samples per chunk, the input and output of one stay within an L2 share */
+#define CONVERT_CHUNK 8192
+
+/*
+ * Small pool of threads splitting a conversion in work() into chunks, for
+ * the convert_threads=N argument of sources running at tens of MS/s.
+ *
+ * run() hands out the chunks of [0, n) one by one to the workers and the
+ * calling thread alike and returns once all are done. Every chunk writes
+ * its own part of the output, so the order of the samples is kept without
+ * any reassembly. With a single thread, or a call of no more than one
+ * chunk, the function is called directly.
+ */
+class chunk_workers
+{
+public:
+  typedef std::function< void ( size_t begin, size_t end ) > chunk_fn;
+
+  /* nthreads in total, the one calling run() included */
+  chunk_workers( size_t nthreads )
+    : _running( true ), _fn( NULL ), _n( 0 ), _chunk( 0 ), _nchunks( 0 ),
+      _next( 0 ), _done( 0 )
+  {
+    for ( size_t i = 1; i < nthreads; i++ )
+      _workers.push_back( std::thread( &chunk_workers::worker_loop, this ) );
+  }
+
+  ~chunk_workers()
+  {
+    {
+      std::lock_guard< std::mutex > lock( _lock );
+      _running = false;
+    }
+    _cond.notify_all();
+
+    for ( std::thread &worker : _workers )
+      worker.join();
+  }
+
+  size_t threads( void ) const { return _workers.size() + 1; }
+
+  void run( size_t n, size_t chunk, const chunk_fn &fn )
+  {
+    if ( _workers.empty() || n <= chunk ) {
+      fn( 0, n );
+      return;
+    }
+
+    std::unique_lock< std::mutex > lock( _lock );
+
+    _fn = &fn;
+    _n = n;
+    _chunk = chunk;
+    _nchunks = ( n + chunk - 1 ) / chunk;
+    _next = 0;
+    _done = 0;
+    _cond.notify_all();
+
+    while ( _next < _nchunks ) {
+      size_t begin = _next++ * chunk;
+      lock.unlock();
+
+      fn( begin, std::min( begin + chunk, n ) );
+
+      lock.lock();
+      _done++;
+    }
+
+    while ( _done < _nchunks )
+      _cond.wait( lock );
+
+    _fn = NULL;
+  }
+
+private:
+  void worker_loop( void )
+  {
+    std::unique_lock< std::mutex > lock( _lock );
+
+    while ( true ) {
+      while ( _running && ( !_fn || _next >= _nchunks ) )
+        _cond.wait( lock );
+
+      if ( !_running )
+        break;
+
+      const chunk_fn *fn = _fn;
+      size_t begin = _next++ * _chunk;
+      size_t end = std::min( begin + _chunk, _n );
+      lock.unlock();
+
+      (*fn)( begin, end );
+
+      lock.lock();
+      if ( ++_done == _nchunks )
+        _cond.notify_all();
+    }
+  }
+
+  std::mutex _lock;
+  std::condition_variable _cond;
+  std::vector< std::thread > _workers;
+  bool _running;
+
+  /* the current call */
+  const chunk_fn *_fn;
+  size_t _n;
+  size_t _chunk;
+  size_t _nchunks;
+  size_t _next;
+  size_t _done;
+};
+
+/* the convert_threads= argument of a device, 1 when not given */
+inline size_t args_to_convert_threads( const dict_t &dict )
+{
+  dict_t::const_iterator it = dict.find( "convert_threads" );
+  if ( it == dict.end() )
+    return 1;
+
+  return std::max( boost::lexical_cast< size_t >( it->second ), size_t(1) );
+}
+
+/* the global open_threads= argument, 0 for one thread per device */
+inline size_t args_to_open_threads( const std::string &args )
+{
+  size_t nthreads = 0;
+
+  for ( std::string arg : args_to_vector( args ) ) {
+    dict_t dict = params_to_dict( arg );
+    if ( dict.count( "open_threads" ) )
+      nthreads = boost::lexical_cast< size_t >( dict["open_threads"] );
+  }
+
+  return nthreads;
+}
+
+/*
+ * Makes the backends of a device argument list side by side on up to
+ * nthreads threads, 0 meaning one per device, as opening one takes from
+ * a fraction of a second to seconds of USB, firmware and FPGA setup.
+ * Blocks and ifaces come back in the order of the arguments.
+ *
+ * With a single device argument, global ones aside, everything is made on
+ * the calling thread and errors pass unchanged. Otherwise every argument
+ * is tried and the errors of all that failed are thrown as one, naming
+ * each argument. The devices opened are closed again as the blocks go
+ * away.
+ */
+template< typename block_t, typename iface_t >
+void open_devices( const std::vector< std::string > &args, size_t nthreads,
+                   block_t (*make)( const std::string &, iface_t *& ),
+                   std::vector< block_t > &blocks, std::vector< iface_t * > &ifaces )
+{
+  size_t n = args.size();
+
+  blocks.assign( n, block_t() );
+  ifaces.assign( n, NULL );
+
+  size_t ndev = std::count_if( args.begin(), args.end(),
+                               []( const std::string &arg )
+                               { return ! is_global_argument()( arg ); } );
+
+  if ( ndev <= 1 ) {
+    for ( size_t i = 0; i < n; i++ )
+      blocks[i] = make( args[i], ifaces[i] );
+    return;
+  }
+
+  if ( nthreads == 0 || nthreads > ndev )
+    nthreads = ndev;
+
+  std::vector< std::string > errors( n );
+  std::atomic< size_t > next( 0 );
+
+  auto open_next = [&]() {
+    for ( size_t i = next++; i < n; i = next++ ) {
+      try {
+        blocks[i] = make( args[i], ifaces[i] );
+      } catch ( const std::exception &ex ) {
+        const char *what = ex.what();
+        errors[i] = what && *what ? what : "unknown error";
+      } catch ( ... ) {
+        errors[i] = "unknown error";
+      }
+    }
+  };
+
+  std::vector< std::thread > threads;
+  for ( size_t i = 1; i < nthreads; i++ )
+    threads.push_back( std::thread( open_next ) );
+
+  open_next();
+
+  for ( std::thread &thread : threads )
+    thread.join();
+
+  std::string message;
+  for ( size_t i = 0; i < n; i++ )
+    if ( ! errors[i].empty() )
+      message += ( message.empty() ? "" : "; " ) + args[i] + ": " + errors[i];
+
+  if ( ! message.empty() ) {
+    blocks.clear();
+    ifaces.clear();
+    throw std::runtime_error( message );
+  }
+}
+
+#endif // OSMOSDR_WORKER_HELPERS_H
@@ -35,6 +35,7 @@
 #include "xtrx_sink_c.h"
 
 #include "arg_helpers.h"
+#include "convert_helpers.h"
 
 static const int max_burstsz = 4096;
 using namespace boost::assign;
@@ -60,10 +61,10 @@ static size_t parse_nchan(const std::string &args)
 }
 
 xtrx_sink_c::xtrx_sink_c(const std::string &args) :
-  gr::sync_block("xtrx_sink_c",
+  direct_block("xtrx_sink_c",
                  gr::io_signature::make(parse_nchan(args),
                                         parse_nchan(args),
-                                        sizeof(gr_complex)),
+                                        args_to_item_size(args)),
                  gr::io_signature::make(0, 0, 0)),
   _sample_flags(0),
   _rate(0),
@@ -74,6 +75,7 @@ xtrx_sink_c::xtrx_sink_c(const std::string &args) :
   _dsp(0),
   _auto_gain(false),
   _otw(XTRX_WF_16),
+  _item_size(args_to_item_size(args)),
   _mimo_mode(false),
   _gain_tx(0),
   _channels(parse_nchan(args)),
@@ -437,6 +439,19 @@ int xtrx_sink_c::work (int noutput_items,
   nfo.samples = noutput_items;
   nfo.buffer_count = input_items.size();
   nfo.buffers = &input_items[0];
+
+  /* sc8 items are sent as int16, sc16 and complex float as they are */
+  if (_item_size == 2 * sizeof(int8_t)) {
+    _convbuf.resize(input_items.size());
+    _bufs.resize(input_items.size());
+    for (unsigned i = 0; i < input_items.size(); i++) {
+      _convbuf[i].resize(2 * noutput_items);
+      convert_8i_to_16i((const int8_t *)input_items[i], &_convbuf[i][0],
+                        2 * noutput_items, 8);
+      _bufs[i] = &_convbuf[i][0];
+    }
+    nfo.buffers = &_bufs[0];
+  }
   nfo.flags = XTRX_TX_DONT_BUFFER;
   if (!_allow_dis)
     nfo.flags |= XTRX_TX_NO_DISCARD;
@@ -476,7 +491,7 @@ bool xtrx_sink_c::start()
   if (_swap_iq)
     params.tx.flags |= XTRX_RSP_SWAP_IQ;
 
-  params.tx.hfmt = XTRX_IQ_FLOAT32;
+  params.tx.hfmt = (_item_size == sizeof(gr_complex)) ? XTRX_IQ_FLOAT32 : XTRX_IQ_INT16;
   params.tx.wfmt = _otw;
   params.tx.chs = XTRX_CH_AB;
   params.tx.paketsize = 0;
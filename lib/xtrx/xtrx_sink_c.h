@@ -25,6 +25,7 @@
 #include <gnuradio/sync_block.h>
 
 #include "sink_iface.h"
+#include "direct_block.h"
 #include "xtrx_obj.h"
 
 
@@ -41,7 +42,7 @@ typedef std::shared_ptr< xtrx_sink_c > xtrx_sink_c_sptr;
 xtrx_sink_c_sptr make_xtrx_sink_c( const std::string & args = "" );
 
 class xtrx_sink_c :
-    public gr::sync_block,
+    public direct_block,
     public sink_iface
 {
 private:
@@ -108,6 +109,9 @@ private:
   bool _auto_gain;
 
   xtrx_wire_format_t _otw;
+  size_t _item_size;   /* complex float, int16 or int8 */
+  std::vector< std::vector<int16_t> > _convbuf;
+  std::vector< const void * > _bufs;
   bool _mimo_mode;
 
   int _gain_tx;
@@ -60,7 +60,7 @@ static size_t parse_nchan(const std::string &args)
 }
 
 xtrx_source_c::xtrx_source_c(const std::string &args) :
-  gr::sync_block("xtrx_source_c",
+  direct_block("xtrx_source_c",
                  gr::io_signature::make(0, 0, 0),
                  gr::io_signature::make(parse_nchan(args),
                                         parse_nchan(args),
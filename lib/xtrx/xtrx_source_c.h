@@ -24,6 +24,7 @@
 #include <gnuradio/sync_block.h>
 
 #include "source_iface.h"
+#include "direct_block.h"
 #include "xtrx_obj.h"
 
 static const pmt::pmt_t TIME_KEY = pmt::string_to_symbol("rx_time");
@@ -37,7 +38,7 @@ typedef std::shared_ptr< xtrx_source_c > xtrx_source_c_sptr;
 xtrx_source_c_sptr make_xtrx_source_c( const std::string & args = "" );
 
 class xtrx_source_c :
-    public gr::sync_block,
+    public direct_block,
     public source_iface
 {
 private:
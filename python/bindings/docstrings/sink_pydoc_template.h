@@ -112,6 +112,9 @@
  static const char *__doc_osmosdr_sink_get_bandwidth_range = R"doc()doc";
 
 
+ static const char *__doc_osmosdr_sink_configure = R"doc()doc";
+
+
  static const char *__doc_osmosdr_sink_set_time_source = R"doc()doc";
 
 
@@ -150,4 +153,7 @@
 
  static const char *__doc_osmosdr_sink_set_time_unknown_pps = R"doc()doc";
 
+
+ static const char *__doc_osmosdr_sink_get_stats = R"doc()doc";
+
   
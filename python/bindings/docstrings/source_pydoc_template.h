@@ -43,6 +43,9 @@
  static const char *__doc_osmosdr_source_get_sample_rate = R"doc()doc";
 
 
+ static const char *__doc_osmosdr_source_get_native_sample_rate = R"doc()doc";
+
+
  static const char *__doc_osmosdr_source_get_freq_range = R"doc()doc";
 
 
@@ -121,6 +124,9 @@
  static const char *__doc_osmosdr_source_get_bandwidth_range = R"doc()doc";
 
 
+ static const char *__doc_osmosdr_source_configure = R"doc()doc";
+
+
  static const char *__doc_osmosdr_source_set_time_source = R"doc()doc";
 
 
@@ -159,4 +165,25 @@
 
  static const char *__doc_osmosdr_source_set_time_unknown_pps = R"doc()doc";
 
+
+ static const char *__doc_osmosdr_source_start_scan = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_source_stop_scan = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_source_get_sample_offsets = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_source_set_ddc_offset = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_source_get_ddc_offset = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_source_get_ddc_sample_rate = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_source_get_stats = R"doc()doc";
+
   
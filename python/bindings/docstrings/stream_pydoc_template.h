@@ -0,0 +1,87 @@
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#include "pydoc_macros.h"
+#define D(...) DOC(osmosdr, __VA_ARGS__ )
+/*
+  This file contains placeholders for docstrings for the Python bindings.
+  Do not edit! These were automatically extracted during the binding process
+  and will be overwritten during the build process
+ */
+
+
+ 
+ static const char *__doc_osmosdr_stream_metadata = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_make = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_get_num_channels = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_activate = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_deactivate = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_read = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_write = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_get_sample_rates = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_set_sample_rate = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_get_sample_rate = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_get_freq_range = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_set_center_freq = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_get_center_freq = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_get_gain_range = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_set_gain_mode = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_set_gain = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_get_gain = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_get_antennas = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_set_antenna = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_get_antenna = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_set_bandwidth = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_stream_get_bandwidth = R"doc()doc";
+
+  
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#include "pydoc_macros.h"
+#define D(...) DOC(osmosdr, __VA_ARGS__ )
+/*
+  This file contains placeholders for docstrings for the Python bindings.
+  Do not edit! These were automatically extracted during the binding process
+  and will be overwritten during the build process
+ */
+
+
+ 
+ static const char *__doc_osmosdr_survey = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_survey_make = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_survey_get_num_bins = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_survey_get_bin_width = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_survey_get_freqs = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_survey_get_hops = R"doc()doc";
+
+  
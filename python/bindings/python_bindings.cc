@@ -23,6 +23,8 @@ namespace py = pybind11;
 // BINDING_FUNCTION_PROTOTYPES(
     void bind_sink(py::module& m);
     void bind_source(py::module& m);
+    void bind_stream(py::module& m);
+    void bind_survey(py::module& m);
 // ) END BINDING_FUNCTION_PROTOTYPES
 
 void bind_device(py::module& m);
@@ -57,6 +59,8 @@ PYBIND11_MODULE(osmosdr_python, m)
     // BINDING_FUNCTION_CALLS(
         bind_sink(m);
         bind_source(m);
+        bind_stream(m);
+        bind_survey(m);
     // ) END BINDING_FUNCTION_CALLS
 
     bind_device(m);
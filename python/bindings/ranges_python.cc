@@ -26,6 +26,7 @@ void bind_ranges(py::module& m)
     py::class_<meta_range_t>(m, "meta_range_t")
         .def(py::init())
         .def(py::init<double, double, double>(), py::arg("start"), py::arg("stop"), py::arg("step") = 0)
+        .def("validate", &meta_range_t::validate)
         .def("start", &meta_range_t::start)
         .def("stop", &meta_range_t::stop)
         .def("step", &meta_range_t::step)
@@ -224,6 +224,20 @@ void bind_sink(py::module& m)
         )
 
 
+        /* numbers and booleans are welcome as values, they go as strings */
+        .def("configure",
+            [](sink &self, const py::dict &settings, size_t chan) {
+                std::map< std::string, std::string > values;
+                for (const auto &item : settings)
+                    values[ py::str(item.first) ] = py::str(item.second);
+                self.configure(values, chan);
+            },
+            py::arg("settings"),
+            py::arg("chan") = 0,
+            D(sink,configure)
+        )
+
+
         .def("set_time_source",&sink::set_time_source,
             py::arg("source"),
             py::arg("mboard") = 0,
@@ -305,6 +319,12 @@ void bind_sink(py::module& m)
             D(sink,set_time_unknown_pps)
         )
 
+
+        .def("get_stats",&sink::get_stats,
+            py::arg("chan") = 0,
+            D(sink,get_stats)
+        )
+
         ;
 
 
@@ -74,6 +74,11 @@ void bind_source(py::module& m)
         )
 
 
+        .def("get_native_sample_rate",&source::get_native_sample_rate,
+            D(source,get_native_sample_rate)
+        )
+
+
         .def("get_freq_range",&source::get_freq_range,
             py::arg("chan") = 0,
             D(source,get_freq_range)
@@ -246,6 +251,20 @@ void bind_source(py::module& m)
         )
 
 
+        /* numbers and booleans are welcome as values, they go as strings */
+        .def("configure",
+            [](source &self, const py::dict &settings, size_t chan) {
+                std::map< std::string, std::string > values;
+                for (const auto &item : settings)
+                    values[ py::str(item.first) ] = py::str(item.second);
+                self.configure(values, chan);
+            },
+            py::arg("settings"),
+            py::arg("chan") = 0,
+            D(source,configure)
+        )
+
+
         .def("set_time_source",&source::set_time_source,
             py::arg("source"),
             py::arg("mboard") = 0,
@@ -327,6 +346,48 @@ void bind_source(py::module& m)
             D(source,set_time_unknown_pps)
         )
 
+
+        .def("start_scan",&source::start_scan,
+            py::arg("freqs"),
+            py::arg("dwell"),
+            py::arg("settle") = 0,
+            D(source,start_scan)
+        )
+
+
+        .def("stop_scan",&source::stop_scan,
+            D(source,stop_scan)
+        )
+
+
+        .def("get_sample_offsets",&source::get_sample_offsets,
+            D(source,get_sample_offsets)
+        )
+
+
+        .def("set_ddc_offset",&source::set_ddc_offset,
+            py::arg("offset"),
+            py::arg("ddc") = 0,
+            D(source,set_ddc_offset)
+        )
+
+
+        .def("get_ddc_offset",&source::get_ddc_offset,
+            py::arg("ddc") = 0,
+            D(source,get_ddc_offset)
+        )
+
+
+        .def("get_ddc_sample_rate",&source::get_ddc_sample_rate,
+            D(source,get_ddc_sample_rate)
+        )
+
+
+        .def("get_stats",&source::get_stats,
+            py::arg("chan") = 0,
+            D(source,get_stats)
+        )
+
         ;
 
 
@@ -0,0 +1,263 @@
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(stream.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(00000000000000000000000000000000)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <osmosdr/stream.h>
+// pydoc.h is automatically generated in the build directory
+#include <stream_pydoc.h>
+
+/* The samples go straight into or out of the arrays, which therefore have
+ * to be contiguous complex64 ones. Anything else would need a copy. */
+static std::vector<py::array> get_buffers(const py::list& buffs,
+                                          size_t nitems,
+                                          bool writeable)
+{
+    std::vector<py::array> arrays;
+
+    for (const py::handle& buff : buffs) {
+        if (!py::isinstance<py::array>(buff))
+            throw py::type_error("stream buffers must be numpy arrays");
+
+        py::array array = py::reinterpret_borrow<py::array>(buff);
+
+        if (!array.dtype().equal(py::dtype::of<gr_complex>()))
+            throw py::type_error("stream buffers must be of dtype complex64");
+
+        if (!(array.flags() & py::array::c_style))
+            throw py::value_error("stream buffers must be contiguous");
+
+        if (writeable && !array.writeable())
+            throw py::value_error("stream buffers must be writeable");
+
+        if (size_t(array.size()) < nitems)
+            throw py::value_error("stream buffers are shorter than nitems");
+
+        arrays.push_back(array);
+    }
+
+    return arrays;
+}
+
+static py::tuple stream_read(::osmosdr::stream& self,
+                             const py::list& buffs,
+                             size_t nitems,
+                             double timeout)
+{
+    std::vector<py::array> arrays = get_buffers(buffs, nitems, true);
+
+    std::vector<gr_complex*> ptrs;
+    for (py::array& buff : arrays)
+        ptrs.push_back(static_cast<gr_complex*>(buff.mutable_data()));
+
+    ::osmosdr::stream_metadata meta;
+    int ret;
+    {
+        py::gil_scoped_release release;
+        ret = self.read(ptrs, nitems, timeout, meta);
+    }
+
+    return py::make_tuple(ret, meta);
+}
+
+static int stream_write(::osmosdr::stream& self,
+                        const py::list& buffs,
+                        size_t nitems,
+                        double timeout,
+                        const ::osmosdr::stream_metadata& meta)
+{
+    std::vector<py::array> arrays = get_buffers(buffs, nitems, false);
+
+    std::vector<const gr_complex*> ptrs;
+    for (const py::array& buff : arrays)
+        ptrs.push_back(static_cast<const gr_complex*>(buff.data()));
+
+    py::gil_scoped_release release;
+    return self.write(ptrs, nitems, timeout, meta);
+}
+
+void bind_stream(py::module& m)
+{
+
+    using stream    = ::osmosdr::stream;
+    using stream_metadata    = ::osmosdr::stream_metadata;
+
+
+    py::class_<stream_metadata>(m, "stream_metadata", D(stream_metadata))
+
+        .def(py::init<>())
+
+        .def_readwrite("has_time", &stream_metadata::has_time)
+        .def_readwrite("time", &stream_metadata::time)
+        .def_readwrite("overflow", &stream_metadata::overflow)
+        .def_readwrite("freq", &stream_metadata::freq)
+        .def_readwrite("start_of_burst", &stream_metadata::start_of_burst)
+        .def_readwrite("end_of_burst", &stream_metadata::end_of_burst)
+        ;
+
+
+    py::class_<stream, std::shared_ptr<stream>> stream_class(m, "stream", D(stream));
+
+    py::enum_<stream::direction_t>(stream_class, "direction_t")
+        .value("RX", stream::RX)
+        .value("TX", stream::TX)
+        .export_values();
+
+    stream_class
+
+        .def(py::init(&stream::make),
+           py::arg("direction"),
+           py::arg("args") = "",
+           D(stream,make)
+        )
+
+
+        .def("get_num_channels",&stream::get_num_channels,
+            D(stream,get_num_channels)
+        )
+
+
+        .def("activate",&stream::activate,
+            D(stream,activate)
+        )
+
+
+        .def("deactivate",&stream::deactivate,
+            D(stream,deactivate)
+        )
+
+
+        .def("read",&stream_read,
+            py::arg("buffs"),
+            py::arg("nitems"),
+            py::arg("timeout") = 1.0,
+            D(stream,read)
+        )
+
+
+        .def("write",&stream_write,
+            py::arg("buffs"),
+            py::arg("nitems"),
+            py::arg("timeout") = 1.0,
+            py::arg("meta") = stream_metadata(),
+            D(stream,write)
+        )
+
+
+        .def("get_sample_rates",&stream::get_sample_rates,
+            D(stream,get_sample_rates)
+        )
+
+
+        .def("set_sample_rate",&stream::set_sample_rate,
+            py::arg("rate"),
+            D(stream,set_sample_rate)
+        )
+
+
+        .def("get_sample_rate",&stream::get_sample_rate,
+            D(stream,get_sample_rate)
+        )
+
+
+        .def("get_freq_range",&stream::get_freq_range,
+            py::arg("chan") = 0,
+            D(stream,get_freq_range)
+        )
+
+
+        .def("set_center_freq",&stream::set_center_freq,
+            py::arg("freq"),
+            py::arg("chan") = 0,
+            D(stream,set_center_freq)
+        )
+
+
+        .def("get_center_freq",&stream::get_center_freq,
+            py::arg("chan") = 0,
+            D(stream,get_center_freq)
+        )
+
+
+        .def("get_gain_range",&stream::get_gain_range,
+            py::arg("chan") = 0,
+            D(stream,get_gain_range)
+        )
+
+
+        .def("set_gain_mode",&stream::set_gain_mode,
+            py::arg("automatic"),
+            py::arg("chan") = 0,
+            D(stream,set_gain_mode)
+        )
+
+
+        .def("set_gain",&stream::set_gain,
+            py::arg("gain"),
+            py::arg("chan") = 0,
+            D(stream,set_gain)
+        )
+
+
+        .def("get_gain",&stream::get_gain,
+            py::arg("chan") = 0,
+            D(stream,get_gain)
+        )
+
+
+        .def("get_antennas",&stream::get_antennas,
+            py::arg("chan") = 0,
+            D(stream,get_antennas)
+        )
+
+
+        .def("set_antenna",&stream::set_antenna,
+            py::arg("antenna"),
+            py::arg("chan") = 0,
+            D(stream,set_antenna)
+        )
+
+
+        .def("get_antenna",&stream::get_antenna,
+            py::arg("chan") = 0,
+            D(stream,get_antenna)
+        )
+
+
+        .def("set_bandwidth",&stream::set_bandwidth,
+            py::arg("bandwidth"),
+            py::arg("chan") = 0,
+            D(stream,set_bandwidth)
+        )
+
+
+        .def("get_bandwidth",&stream::get_bandwidth,
+            py::arg("chan") = 0,
+            D(stream,get_bandwidth)
+        )
+
+        ;
+
+
+}
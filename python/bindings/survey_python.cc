@@ -0,0 +1,74 @@
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(survey.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(00000000000000000000000000000000)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <osmosdr/survey.h>
+// pydoc.h is automatically generated in the build directory
+#include <survey_pydoc.h>
+
+void bind_survey(py::module& m)
+{
+
+    using survey    = ::osmosdr::survey;
+
+
+    py::class_<survey, gr::block, gr::basic_block,
+        std::shared_ptr<survey>>(m, "survey", D(survey))
+
+        .def(py::init(&survey::make),
+           py::arg("src"),
+           py::arg("start_freq"),
+           py::arg("stop_freq"),
+           py::arg("fft_len") = 1024,
+           py::arg("avg") = 16,
+           py::arg("usable") = 0.75,
+           py::arg("settle") = 0,
+           py::arg("threads") = 0,
+           D(survey,make)
+        )
+
+
+        .def("get_num_bins",&survey::get_num_bins,
+            D(survey,get_num_bins)
+        )
+
+
+        .def("get_bin_width",&survey::get_bin_width,
+            D(survey,get_bin_width)
+        )
+
+
+        .def("get_freqs",&survey::get_freqs,
+            D(survey,get_freqs)
+        )
+
+
+        .def("get_hops",&survey::get_hops,
+            D(survey,get_hops)
+        )
+
+        ;
+
+
+}
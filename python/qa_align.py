@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+#
+# Copyright 2026 Free Software Foundation, Inc.
+#
+# This file is part of gr-osmosdr
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import os
+import random
+import tempfile
+
+from gnuradio import gr, gr_unittest, blocks
+import osmosdr
+
+
+class qa_align(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+        self.dir = tempfile.mkdtemp()
+
+    def tearDown(self):
+        self.tb = None
+        for name in os.listdir(self.dir):
+            os.remove(os.path.join(self.dir, name))
+        os.rmdir(self.dir)
+
+    def write(self, name, data):
+        path = os.path.join(self.dir, name)
+        tb = gr.top_block()
+        src = blocks.vector_source_c(data, False)
+        dst = blocks.file_sink(gr.sizeof_gr_complex, path)
+        tb.connect(src, dst)
+        tb.run()
+        dst.close()
+        return path
+
+    def test_001_file_delay(self):
+        """ two file channels, the second one started delay samples earlier """
+        delay = 37
+        n = 1 << 16
+        rng = random.Random(42)
+        data = [complex(rng.gauss(0, 1), rng.gauss(0, 1)) for _ in range(n + delay)]
+
+        a = self.write("a.cfile", data[delay:])
+        b = self.write("b.cfile", data[:n])
+
+        args = "numchan=2 " \
+               "file=%s,rate=1e6,repeat=false,throttle=false " \
+               "file=%s,rate=1e6,repeat=false,throttle=false " \
+               "align=xcorr,align_len=4096" % (a, b)
+
+        src = osmosdr.source(args)
+        dst0 = blocks.vector_sink_c()
+        dst1 = blocks.vector_sink_c()
+        self.tb.connect((src, 0), dst0)
+        self.tb.connect((src, 1), dst1)
+        self.tb.run()
+
+        out0 = dst0.data()
+        out1 = dst1.data()
+        m = min(len(out0), len(out1))
+        self.assertGreater(m, n // 2)
+
+        self.assertAlmostEqual(src.get_sample_offsets()[0], 0.0, 1)
+        # b[k + delay] == a[k]: channel 1 started earlier, its offset is negative
+        self.assertAlmostEqual(src.get_sample_offsets()[1], -delay, 1)
+        self.assertComplexTuplesAlmostEqual(out0[m - 1024:m], out1[m - 1024:m], 4)
+
+    def test_002_short_align_len(self):
+        """ a calibration window below 1024 samples is rejected """
+        z = self.write("z.cfile", [0j] * 16)
+        with self.assertRaises(RuntimeError):
+            osmosdr.source("numchan=2 file=%s,rate=1e6 file=%s,rate=1e6 "
+                           "align=xcorr,align_len=0" % (z, z))
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_align)
@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+#
+# Copyright 2026 Free Software Foundation, Inc.
+#
+# This file is part of gr-osmosdr
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import random
+import socket
+import struct
+import threading
+import time
+
+from gnuradio import gr, gr_unittest, blocks
+import osmosdr
+
+
+class server(object):
+    """ stand-in for the Red Pitaya SDR server on 127.0.0.1
+
+    The block opens a control and a data connection to the same port and
+    introduces each with a 32 bit command: 0 and 1 for the receiver, 2
+    and 3 for the transmitter. Whatever arrives on the control connection
+    is drained, the data connection is handed to the test. """
+
+    def __init__(self, rcvbuf=0):
+        self.listener = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        self.listener.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        if rcvbuf:
+            # accepted connections inherit it, the window is set on connect
+            self.listener.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, rcvbuf)
+        self.listener.bind(("127.0.0.1", 0))
+        self.listener.listen(2)
+        self.port = self.listener.getsockname()[1]
+        self.control = None
+        self.data = None
+        self.ready = threading.Event()
+        self.thread = threading.Thread(target=self.accept, daemon=True)
+        self.thread.start()
+
+    def accept(self):
+        for _ in range(2):
+            try:
+                conn, _ = self.listener.accept()
+            except OSError:
+                return
+            command = struct.unpack("<I", recv_exactly(conn, 4))[0]
+            if command in (0, 2):
+                self.control = conn
+            else:
+                self.data = conn
+        self.ready.set()
+        threading.Thread(target=self.drain, daemon=True).start()
+
+    def drain(self):
+        try:
+            while self.control.recv(4096):
+                pass
+        except OSError:
+            pass
+
+    def wait(self):
+        self.ready.wait(5)
+        return self.data
+
+    def close(self):
+        for s in (self.data, self.control, self.listener):
+            if s is not None:
+                s.close()
+
+
+def recv_exactly(conn, size):
+    data = b""
+    while len(data) < size:
+        chunk = conn.recv(size - len(data))
+        if not chunk:
+            break
+        data += chunk
+    return data
+
+
+def pack(samples):
+    return b"".join(struct.pack("<ff", s.real, s.imag) for s in samples)
+
+
+def unpack(data):
+    values = struct.unpack("<%df" % (len(data) // 4), data)
+    return [complex(values[i], values[i + 1]) for i in range(0, len(values), 2)]
+
+
+class qa_redpitaya(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+        self.rng = random.Random(42)
+
+    def tearDown(self):
+        self.tb = None
+
+    def samples(self, n):
+        # exactly representable in float32, compared without tolerance
+        return [complex(self.rng.randint(-2048, 2047) / 2048.0,
+                        self.rng.randint(-2048, 2047) / 2048.0) for _ in range(n)]
+
+    def test_001_source_partial_reads(self):
+        """ samples split at odd byte boundaries and a stall come out whole """
+        n = 20000
+        data = self.samples(n)
+        payload = pack(data)
+        srv = server()
+
+        def feed():
+            conn = srv.wait()
+            pos = 0
+            stalled = False
+            while pos < len(payload):
+                # chunks not a multiple of the sample size
+                size = self.rng.randint(1, 3001)
+                conn.sendall(payload[pos:pos + size])
+                pos += size
+                time.sleep(0.001)
+                if not stalled and pos > len(payload) // 2:
+                    # several work() timeouts in a row
+                    time.sleep(0.3)
+                    stalled = True
+
+        src = osmosdr.source("redpitaya=127.0.0.1:%d,timeout=20" % srv.port)
+        feeder = threading.Thread(target=feed, daemon=True)
+        feeder.start()
+
+        head = blocks.head(gr.sizeof_gr_complex, n)
+        dst = blocks.vector_sink_c()
+        self.tb.connect(src, head, dst)
+        self.tb.run()
+        feeder.join(5)
+
+        stats = src.get_stats()
+        srv.close()
+
+        self.assertEqual(list(dst.data()), data)
+        self.assertGreater(stats["late_reads"], 0)
+        self.assertGreater(stats["short_reads"], 0)
+
+    def test_002_sink_slow_reader(self):
+        """ a reader stalling and taking small bites gets every sample """
+        n = 20000
+        data = self.samples(n)
+        srv = server(rcvbuf=4096)
+        received = []
+
+        def collect():
+            conn = srv.wait()
+            # hold back until the ring and the socket buffers are full
+            time.sleep(0.3)
+            total = n * gr.sizeof_gr_complex
+            chunks = []
+            size = 0
+            while size < total:
+                chunk = conn.recv(min(1000, total - size))
+                if not chunk:
+                    break
+                chunks.append(chunk)
+                size += len(chunk)
+                time.sleep(0.0005)
+            received.append(b"".join(chunks))
+
+        sink = osmosdr.sink("redpitaya=127.0.0.1:%d,buffers=2,buflen=4096,"
+                            "sndbuf=4096,timeout=20" % srv.port)
+        collector = threading.Thread(target=collect, daemon=True)
+        collector.start()
+
+        src = blocks.vector_source_c(data, False)
+        self.tb.connect(src, sink)
+        self.tb.run()
+        collector.join(10)
+
+        stats = sink.get_stats()
+        srv.close()
+
+        self.assertEqual(len(received), 1)
+        self.assertEqual(unpack(received[0]), data)
+        self.assertGreater(stats["late_writes"], 0)
+        self.assertGreater(stats["short_writes"], 0)
+
+    def test_003_no_server(self):
+        """ nothing listening is reported on construction """
+        s = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        s.bind(("127.0.0.1", 0))
+        port = s.getsockname()[1]
+        s.close()
+        with self.assertRaises(RuntimeError):
+            osmosdr.source("redpitaya=127.0.0.1:%d" % port)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_redpitaya)
@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+#
+# Copyright 2026 Free Software Foundation, Inc.
+#
+# This file is part of gr-osmosdr
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import random
+import socket
+import struct
+import time
+
+from gnuradio import gr, gr_unittest, blocks
+import pmt
+import osmosdr
+
+# header fields, VITA 49.0
+TYPE_DATA_SID = 1
+TYPE_CONTEXT = 4
+TSI_UTC = 1
+TSF_PICOSECONDS = 2
+
+# context indicator bits and the fixed point scale of frequencies
+CIF_RF_FREQ = 1 << 27
+CIF_GAIN = 1 << 23
+CIF_RATE = 1 << 21
+FREQ_SCALE = 1 << 20
+
+
+def free_port():
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    s.bind(("127.0.0.1", 0))
+    port = s.getsockname()[1]
+    s.close()
+    return port
+
+
+def header(kind, count, words):
+    return (kind << 28) | (TSI_UTC << 22) | (TSF_PICOSECONDS << 20) | \
+           ((count & 0xf) << 16) | words
+
+
+def data_packet(count, sid, secs, ps, samples):
+    payload = b"".join(struct.pack(">ff", s.real, s.imag) for s in samples)
+    words = 5 + len(payload) // 4
+    return struct.pack(">IIIQ", header(TYPE_DATA_SID, count, words), sid, secs, ps) + payload
+
+
+def context_packet(count, sid, secs, ps, freq, rate):
+    cif = CIF_RF_FREQ | CIF_GAIN | CIF_RATE
+    return struct.pack(">IIIQIqIq", header(TYPE_CONTEXT, count, 11), sid, secs, ps,
+                       cif, int(freq * FREQ_SCALE), 0, int(rate * FREQ_SCALE))
+
+
+def tags_of(dst, key):
+    return sorted((t for t in dst.tags() if pmt.symbol_to_string(t.key) == key),
+                  key=lambda t: t.offset)
+
+
+def tag_time(tag):
+    return (pmt.to_uint64(pmt.tuple_ref(tag.value, 0)),
+            pmt.to_double(pmt.tuple_ref(tag.value, 1)))
+
+
+class qa_vrt(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+        self.rng = random.Random(42)
+        self.port = free_port()
+
+    def tearDown(self):
+        self.tb = None
+
+    def samples(self, n):
+        # exactly representable in float32, compared without tolerance
+        return [complex(self.rng.randint(-2048, 2047) / 2048.0,
+                        self.rng.randint(-2048, 2047) / 2048.0) for _ in range(n)]
+
+    def receive(self, args, n, send):
+        """ runs a vrt source into n samples while send() produces them """
+        src = osmosdr.source("vrt=127.0.0.1:%d,%s" % (self.port, args))
+        head = blocks.head(gr.sizeof_gr_complex, n)
+        dst = blocks.vector_sink_c()
+        self.tb.connect(src, head, dst)
+        self.tb.start()
+
+        send()
+
+        deadline = time.time() + 5
+        while len(dst.data()) < n and time.time() < deadline:
+            time.sleep(0.01)
+        self.tb.stop()
+        self.tb.wait()
+
+        return src, dst
+
+    def test_001_loopback(self):
+        """ vrt sink into vrt source: samples, times and context survive """
+        n = 20000
+        rate = 1e6
+        data = self.samples(n)
+
+        def send():
+            tb = gr.top_block()
+            sink = osmosdr.sink("vrt=127.0.0.1:%d,format=fc32,stream_id=0x10,spp=100"
+                                % self.port)
+            sink.set_sample_rate(rate)
+            sink.set_center_freq(100e6)
+            tb.connect(blocks.vector_source_c(data, False), sink)
+            tb.run()
+
+        src, dst = self.receive("format=fc32,stream_id=0x10,time_period=0.005", n, send)
+
+        self.assertEqual(list(dst.data()), data)
+
+        freqs = tags_of(dst, "rx_freq")
+        self.assertEqual(freqs[0].offset, 0)
+        self.assertEqual(pmt.to_double(freqs[0].value), 100e6)
+        rates = tags_of(dst, "rx_rate")
+        self.assertEqual(rates[0].offset, 0)
+        self.assertEqual(pmt.to_double(rates[0].value), rate)
+
+        # one at the start and one every 5000 samples, all on one timeline
+        times = tags_of(dst, "rx_time")
+        self.assertEqual([t.offset for t in times], [0, 5000, 10000, 15000])
+        secs, frac = tag_time(times[0])
+        self.assertLess(abs(secs + frac - time.time()), 60)
+        for t in times[1:]:
+            s, f = tag_time(t)
+            self.assertAlmostEqual((s - secs) + (f - frac), t.offset / rate, 9)
+
+        self.assertEqual(len(tags_of(dst, "rx_dropped")), 0)
+
+        stats = src.get_stats()
+        self.assertEqual(stats["packets"], n // 100)
+        self.assertEqual(stats["packets_lost"], 0)
+        self.assertGreaterEqual(stats["context_packets"], 1)
+
+    def test_002_count_gap(self):
+        """ generated packets with two counts missing and a context packet """
+        spp = 100
+        rate = 2e6
+        secs = 1700000000
+        sid = 0x20
+        data = self.samples(10 * spp)
+        sent = [k for k in range(10) if k not in (3, 4)]
+
+        def send():
+            s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+            s.sendto(context_packet(0, sid, secs, 0, 433.92e6, rate), ("127.0.0.1", self.port))
+            for k in sent:
+                ps = k * spp * 1000000 // 2   # k * spp samples at 2 MS/s in ps
+                s.sendto(data_packet(k, sid, secs, ps, data[k * spp:(k + 1) * spp]),
+                         ("127.0.0.1", self.port))
+            s.close()
+
+        src, dst = self.receive("format=fc32,stream_id=0x20,rate=1e6,time_period=0",
+                                len(sent) * spp, send)
+
+        expected = []
+        for k in sent:
+            expected += data[k * spp:(k + 1) * spp]
+        self.assertEqual(list(dst.data()), expected)
+
+        freqs = tags_of(dst, "rx_freq")
+        self.assertEqual([(t.offset, pmt.to_double(t.value)) for t in freqs], [(0, 433.92e6)])
+        rates = tags_of(dst, "rx_rate")
+        self.assertEqual([(t.offset, pmt.to_double(t.value)) for t in rates], [(0, rate)])
+
+        # packets 3 and 4 are missing, packet 5 comes out at 3 * spp
+        dropped = tags_of(dst, "rx_dropped")
+        self.assertEqual([(t.offset, pmt.to_uint64(t.value)) for t in dropped],
+                         [(3 * spp, 2 * spp)])
+
+        # a time tag at the start and again right after the gap
+        times = tags_of(dst, "rx_time")
+        self.assertEqual([t.offset for t in times], [0, 3 * spp])
+        self.assertEqual(tag_time(times[0]), (secs, 0.0))
+        s, f = tag_time(times[1])
+        self.assertEqual(s, secs)
+        self.assertAlmostEqual(f, 5 * spp / rate, 12)
+
+        stats = src.get_stats()
+        self.assertEqual(stats["packets"], len(sent))
+        self.assertEqual(stats["packets_lost"], 2)
+        self.assertEqual(stats["context_packets"], 1)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_vrt)